@@ -1,4 +1,4 @@
-QT       += core gui network charts widgets testlib
+QT       += core gui network charts widgets testlib concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,15 +9,56 @@ CONFIG += debug c++17 testcase
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    airqualityindex.cpp \
+    basemapitem.cpp \
+    geocodecache.cpp \
+    giosclient.cpp \
+    giosresponsecache.cpp \
+    giosstreamparsers.cpp \
+    giostime.cpp \
+    haversinebatch.cpp \
+    heatmaplayer.cpp \
+    jsonstreamreader.cpp \
     main.cpp \
     mainwindow.cpp \
+    mapprojection.cpp \
+    sensorseries.cpp \
+    seriescodec.cpp \
+    stationarchive.cpp \
+    stationcatalog.cpp \
+    stationfacetindex.cpp \
     stationinfocard.cpp \
+    stationlistmodel.cpp \
+    stationmapview.cpp \
+    stationmarkerlayer.cpp \
+    stationspatialindex.cpp \
+    stationtextindex.cpp \
 
 HEADERS += \
-    clickableellipseitem.h \
+    airqualityindex.h \
+    basemapitem.h \
     custombutton.h \
+    geocodecache.h \
+    giosclient.h \
+    giosresponsecache.h \
+    giosstreamparsers.h \
+    giostime.h \
+    haversinebatch.h \
+    heatmaplayer.h \
+    jsonstreamreader.h \
     mainwindow.h \
-    stationinfocard.h
+    mapprojection.h \
+    sensorseries.h \
+    seriescodec.h \
+    stationarchive.h \
+    stationcatalog.h \
+    stationfacetindex.h \
+    stationinfocard.h \
+    stationlistmodel.h \
+    stationmapview.h \
+    stationmarkerlayer.h \
+    stationspatialindex.h \
+    stationtextindex.h
 
 FORMS += \
     mainwindow.ui
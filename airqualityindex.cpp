@@ -0,0 +1,140 @@
+/**
+ * @file airqualityindex.cpp
+ * @brief Implementacja progów indeksu jakości powietrza.
+ */
+
+#include "airqualityindex.h"
+#include <QtGlobal>
+
+namespace {
+
+/// Górne granice klas 0 ... BandCount - 2 dla parametru (ostatnia klasa jest otwarta).
+struct Thresholds {
+    const char *paramCode; ///< Kod parametru.
+    double upper[AirQualityIndex::BandCount - 1]; ///< Górne granice klas (µg/m³).
+};
+
+const Thresholds IndexThresholds[] = {
+    {"PM10", {20, 50, 80, 110, 150}},
+    {"PM2.5", {13, 35, 55, 75, 110}},
+    {"NO2", {40, 100, 150, 230, 400}},
+    {"O3", {70, 120, 150, 180, 240}},
+    {"SO2", {50, 100, 200, 350, 500}},
+};
+
+const QRgb BandColors[AirQualityIndex::BandCount] = {
+    qRgb(0x57, 0xb1, 0x08), qRgb(0xb0, 0xdd, 0x10), qRgb(0xff, 0xd9, 0x11),
+    qRgb(0xe5, 0x81, 0x00), qRgb(0xe5, 0x00, 0x00), qRgb(0x99, 0x00, 0x00),
+};
+
+/**
+ * @brief Wyszukuje progi parametru.
+ * @param paramCode Kod parametru.
+ * @return Progi lub nullptr dla parametru spoza indeksu.
+ */
+const Thresholds *thresholdsFor(const QString &paramCode) {
+    for (const Thresholds &thresholds : IndexThresholds) {
+        if (paramCode == QLatin1String(thresholds.paramCode)) {
+            return &thresholds;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+/**
+ * @brief Zwraca kody parametrów objętych indeksem.
+ * @return Kody parametrów w kolejności wyświetlania.
+ */
+QStringList AirQualityIndex::parameters() {
+    QStringList result;
+    for (const Thresholds &thresholds : IndexThresholds) {
+        result.append(QString::fromLatin1(thresholds.paramCode));
+    }
+    return result;
+}
+
+/**
+ * @brief Sprawdza, czy parametr jest objęty indeksem.
+ * @param paramCode Kod parametru (np. PM10).
+ * @return true, jeśli dla parametru zdefiniowano progi.
+ */
+bool AirQualityIndex::isIndexed(const QString &paramCode) {
+    return thresholdsFor(paramCode) != nullptr;
+}
+
+/**
+ * @brief Zwraca ciągły poziom indeksu dla stężenia.
+ * @param paramCode Kod parametru.
+ * @param value Stężenie (µg/m³).
+ * @return Poziom w przedziale [0, BandCount) lub -1 dla parametru spoza indeksu.
+ *
+ * Ostatnia (otwarta) klasa ma umowną szerokość równą szerokości poprzedniej.
+ */
+double AirQualityIndex::level(const QString &paramCode, double value) {
+    const Thresholds *thresholds = thresholdsFor(paramCode);
+    if (!thresholds) {
+        return -1.0;
+    }
+    double lower = 0.0;
+    for (int band = 0; band < BandCount; ++band) {
+        const double upper = band < BandCount - 1 ? thresholds->upper[band]
+                                                  : 2 * thresholds->upper[BandCount - 2] - thresholds->upper[BandCount - 3];
+        if (value < upper || band == BandCount - 1) {
+            return band + qBound(0.0, (value - lower) / (upper - lower), 0.999);
+        }
+        lower = upper;
+    }
+    return BandCount - 0.001;
+}
+
+/**
+ * @brief Zwraca klasę indeksu dla stężenia.
+ * @param paramCode Kod parametru.
+ * @param value Stężenie (µg/m³).
+ * @return Klasa 0 (bardzo dobry) ... BandCount - 1 (bardzo zły) lub -1 dla parametru spoza indeksu.
+ */
+int AirQualityIndex::band(const QString &paramCode, double value) {
+    const double result = level(paramCode, value);
+    return result < 0.0 ? -1 : int(result);
+}
+
+/**
+ * @brief Zwraca kolor klasy indeksu.
+ * @param band Klasa indeksu (-1 - brak danych).
+ * @return Kolor klasy (szary dla braku danych).
+ */
+QColor AirQualityIndex::bandColor(int band) {
+    return band >= 0 && band < BandCount ? QColor(BandColors[band]) : QColor(Qt::gray);
+}
+
+/**
+ * @brief Zwraca kolor poziomu indeksu, interpolowany między kolorami sąsiednich klas.
+ * @param level Poziom z level().
+ * @return Kolor (szary dla poziomu ujemnego).
+ *
+ * Środek klasy ma dokładnie jej kolor; między środkami kolory zmieniają się liniowo.
+ */
+QColor AirQualityIndex::levelColor(double level) {
+    if (level < 0.0) {
+        return QColor(Qt::gray);
+    }
+    const double position = qBound(0.0, level - 0.5, BandCount - 1.0);
+    const int band = qMin(int(position), BandCount - 2);
+    const double t = position - band;
+    const QColor a(BandColors[band]);
+    const QColor b(BandColors[band + 1]);
+    return QColor::fromRgbF(float(a.redF() + (b.redF() - a.redF()) * t), float(a.greenF() + (b.greenF() - a.greenF()) * t),
+                            float(a.blueF() + (b.blueF() - a.blueF()) * t));
+}
+
+/**
+ * @brief Zwraca nazwę klasy indeksu.
+ * @param band Klasa indeksu.
+ * @return Nazwa klasy (np. "Dobry").
+ */
+QString AirQualityIndex::bandName(int band) {
+    static const char *const names[BandCount] = {"Bardzo dobry", "Dobry", "Umiarkowany", "Dostateczny", "Zły", "Bardzo zły"};
+    return band >= 0 && band < BandCount ? QString::fromUtf8(names[band]) : QString("Brak indeksu");
+}
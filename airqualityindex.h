@@ -0,0 +1,71 @@
+/**
+ * @file airqualityindex.h
+ * @brief Progi polskiego indeksu jakości powietrza i odpowiadające im kolory.
+ */
+
+#ifndef AIRQUALITYINDEX_H
+#define AIRQUALITYINDEX_H
+
+#include <QColor>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @namespace AirQualityIndex
+ * @brief Klasy indeksu jakości powietrza GIOŚ (od bardzo dobrego do bardzo złego) dla stężeń godzinowych.
+ *
+ * Progi (µg/m³) dotyczą parametrów objętych indeksem: PM10, PM2.5, NO2, O3 i SO2. Dla pozostałych
+ * parametrów klasa jest nieznana.
+ */
+namespace AirQualityIndex {
+
+constexpr int BandCount = 6; ///< Liczba klas indeksu.
+
+/**
+ * @brief Zwraca kody parametrów objętych indeksem.
+ * @return Kody parametrów w kolejności wyświetlania.
+ */
+QStringList parameters();
+/**
+ * @brief Sprawdza, czy parametr jest objęty indeksem.
+ * @param paramCode Kod parametru (np. PM10).
+ * @return true, jeśli dla parametru zdefiniowano progi.
+ */
+bool isIndexed(const QString &paramCode);
+/**
+ * @brief Zwraca ciągły poziom indeksu dla stężenia.
+ * @param paramCode Kod parametru.
+ * @param value Stężenie (µg/m³).
+ * @return Poziom w przedziale [0, BandCount) - część całkowita to klasa, ułamkowa to położenie
+ *         w przedziale klasy; -1 dla parametru spoza indeksu.
+ */
+double level(const QString &paramCode, double value);
+/**
+ * @brief Zwraca klasę indeksu dla stężenia.
+ * @param paramCode Kod parametru.
+ * @param value Stężenie (µg/m³).
+ * @return Klasa 0 (bardzo dobry) ... BandCount - 1 (bardzo zły) lub -1 dla parametru spoza indeksu.
+ */
+int band(const QString &paramCode, double value);
+/**
+ * @brief Zwraca kolor klasy indeksu.
+ * @param band Klasa indeksu (-1 - brak danych).
+ * @return Kolor klasy (szary dla braku danych).
+ */
+QColor bandColor(int band);
+/**
+ * @brief Zwraca kolor poziomu indeksu, interpolowany między kolorami sąsiednich klas.
+ * @param level Poziom z level().
+ * @return Kolor (szary dla poziomu ujemnego).
+ */
+QColor levelColor(double level);
+/**
+ * @brief Zwraca nazwę klasy indeksu.
+ * @param band Klasa indeksu.
+ * @return Nazwa klasy (np. "Dobry").
+ */
+QString bandName(int band);
+
+} // namespace AirQualityIndex
+
+#endif // AIRQUALITYINDEX_H
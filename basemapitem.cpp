@@ -0,0 +1,53 @@
+/**
+ * @file basemapitem.cpp
+ * @brief Implementacja podkładu mapy.
+ */
+
+#include "basemapitem.h"
+#include <QDebug>
+#include <QImage>
+#include <QPainter>
+
+/**
+ * @brief Wczytuje obraz mapy.
+ * @param fileName Ścieżka obrazu (np. zasób Qt).
+ * @param sceneRect Prostokąt sceny, w który wpisywany jest obraz (z zachowaniem proporcji).
+ * @param parent Element nadrzędny.
+ */
+BasemapItem::BasemapItem(const QString &fileName, const QRectF &sceneRect, QGraphicsItem *parent) : QGraphicsItem(parent) {
+    QImage image(fileName);
+    if (image.isNull()) {
+        qDebug() << "Błąd: Nie udało się załadować obrazu mapy!";
+        return;
+    }
+    const QSizeF size = QSizeF(image.size()).scaled(sceneRect.size(), Qt::KeepAspectRatio);
+    rect = QRectF(sceneRect.center() - QPointF(size.width() / 2.0, size.height() / 2.0), size);
+    pixmap = QPixmap::fromImage(image);
+}
+
+/**
+ * @brief Zwraca kanał alfa obrazu mapy (kształt kraju).
+ * @return Kanał alfa obrazu (Format_Alpha8) lub pusty obraz, jeśli mapa nie ma przezroczystości.
+ */
+QImage BasemapItem::shapeMask() const {
+    if (pixmap.isNull() || !pixmap.hasAlphaChannel()) {
+        return QImage();
+    }
+    return pixmap.toImage().convertToFormat(QImage::Format_Alpha8);
+}
+
+/**
+ * @brief Rysuje obraz mapy wpisany w prostokąt mapy.
+ * @param painter Obiekt rysujący.
+ * @param option Opcje stylu.
+ * @param widget Widżet, na którym odbywa się rysowanie.
+ */
+void BasemapItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    if (pixmap.isNull()) {
+        return;
+    }
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawPixmap(rect, pixmap, QRectF(pixmap.rect()));
+}
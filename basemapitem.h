@@ -0,0 +1,56 @@
+/**
+ * @file basemapitem.h
+ * @brief Element sceny rysujący podkład mapy z obrazu dekodowanego raz.
+ */
+
+#ifndef BASEMAPITEM_H
+#define BASEMAPITEM_H
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPixmap>
+
+/**
+ * @class BasemapItem
+ * @brief Podkład mapy wpisany w prostokąt sceny.
+ *
+ * Obraz dekodowany jest raz, przy tworzeniu elementu, i rysowany bezpośrednio z pixmapy
+ * z wygładzaniem, więc przybliżanie i zmiana rozmiaru okna nie wymagają ponownego dekodowania.
+ * Dołączony obraz mapy jest mniejszy od prostokąta mapy w scenie, dlatego nie jest przechowywany
+ * w kilku rozdzielczościach.
+ */
+class BasemapItem : public QGraphicsItem {
+public:
+    /**
+     * @brief Wczytuje obraz mapy.
+     * @param fileName Ścieżka obrazu (np. zasób Qt).
+     * @param sceneRect Prostokąt sceny, w który wpisywany jest obraz (z zachowaniem proporcji).
+     * @param parent Element nadrzędny.
+     */
+    BasemapItem(const QString &fileName, const QRectF &sceneRect, QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief Sprawdza, czy obraz nie został wczytany.
+     * @return true, jeśli wczytanie obrazu się nie powiodło.
+     */
+    bool isNull() const { return pixmap.isNull(); }
+    /**
+     * @brief Zwraca prostokąt zajmowany przez obraz mapy.
+     * @return Prostokąt we współrzędnych elementu (wyśrodkowany w prostokącie sceny).
+     */
+    QRectF mapRect() const { return rect; }
+    /**
+     * @brief Zwraca kanał alfa obrazu mapy (kształt kraju).
+     * @return Kanał alfa obrazu (Format_Alpha8) lub pusty obraz, jeśli mapa nie ma przezroczystości.
+     */
+    QImage shapeMask() const;
+
+    QRectF boundingRect() const override { return rect; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+private:
+    QRectF rect; ///< Prostokąt obrazu mapy.
+    QPixmap pixmap; ///< Obraz mapy.
+};
+
+#endif // BASEMAPITEM_H
@@ -0,0 +1,267 @@
+/**
+ * @file geocodecache.cpp
+ * @brief Implementacja pamięci podręcznej geokodowania i lokalnego spisu miejscowości.
+ */
+
+#include "geocodecache.h"
+#include "stationtextindex.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+/**
+ * @brief Tworzy pamięć podręczną i wczytuje zapisane wpisy.
+ * @param capacity Maksymalna liczba wpisów.
+ */
+GeocodeCache::GeocodeCache(int capacity) : maxEntries(qMax(1, capacity)) {
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (directory.isEmpty()) {
+        directory = QDir::tempPath() + "/GIOSrevamp";
+    }
+    filePath = directory + "/geocode.json";
+    load();
+}
+
+/**
+ * @brief Wyszukuje zapytanie w pamięci podręcznej i oznacza je jako ostatnio użyte.
+ * @param query Tekst lokalizacji.
+ * @param point Wynik (współrzędne), jeśli zapytanie jest znane.
+ * @return true, jeśli zapytanie jest w pamięci podręcznej.
+ */
+bool GeocodeCache::lookup(const QString &query, GeoPoint *point) {
+    auto it = entries.find(normalize(query));
+    if (it == entries.end()) {
+        return false;
+    }
+    recency.splice(recency.begin(), recency, it->position);
+    *point = it->point;
+    return true;
+}
+
+/**
+ * @brief Dodaje wynik geokodowania i zapisuje pamięć podręczną na dysk.
+ * @param query Tekst lokalizacji.
+ * @param point Współrzędne.
+ */
+void GeocodeCache::insert(const QString &query, const GeoPoint &point) {
+    const QString key = normalize(query);
+    if (key.isEmpty()) {
+        return;
+    }
+    put(key, point);
+    save();
+}
+
+/**
+ * @brief Normalizuje tekst lokalizacji: małe litery bez znaków diakrytycznych, pojedyncze spacje.
+ * @param query Tekst lokalizacji.
+ * @return Klucz pamięci podręcznej.
+ */
+QString GeocodeCache::normalize(const QString &query) {
+    return StationTextIndex::fold(query.simplified());
+}
+
+/**
+ * @brief Wczytuje wpisy z pliku.
+ */
+void GeocodeCache::load() {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonArray array = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        const QString key = object["query"].toString();
+        if (!key.isEmpty() && object.contains("lat") && object.contains("lon")) {
+            put(key, {object["lat"].toDouble(), object["lon"].toDouble()});
+        }
+    }
+    qDebug() << "Wczytano" << entries.size() << "zapamiętanych lokalizacji";
+}
+
+/**
+ * @brief Zapisuje wpisy do pliku (od najdawniej do ostatnio używanego).
+ *
+ * Kolejność w pliku odtwarza kolejność użycia po ponownym wczytaniu.
+ */
+void GeocodeCache::save() const {
+    QJsonArray array;
+    for (auto it = recency.rbegin(); it != recency.rend(); ++it) {
+        const GeoPoint &point = entries[*it].point;
+        array.append(QJsonObject{{"query", *it}, {"lat", point.lat}, {"lon", point.lon}});
+    }
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Nie można zapisać pamięci lokalizacji:" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(array).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+/**
+ * @brief Dodaje wpis bez zapisu na dysk, usuwając w razie potrzeby najdawniej używany.
+ * @param key Znormalizowany klucz.
+ * @param point Współrzędne.
+ */
+void GeocodeCache::put(const QString &key, const GeoPoint &point) {
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        it->point = point;
+        recency.splice(recency.begin(), recency, it->position);
+        return;
+    }
+    recency.push_front(key);
+    entries.insert(key, {point, recency.begin()});
+    if (entries.size() > maxEntries) {
+        entries.remove(recency.back());
+        recency.pop_back();
+    }
+}
+
+/**
+ * @brief Buduje spis dla stacji katalogu.
+ * @param catalog Katalog stacji.
+ */
+void OfflineGazetteer::build(const StationCatalog &catalog) {
+    cities = collect(catalog, &StationCatalog::city);
+    communes = collect(catalog, &StationCatalog::commune);
+}
+
+/**
+ * @brief Wyszukuje miejscowość lub gminę.
+ * @param query Tekst lokalizacji (nazwa, ewentualnie z dopiskiem ", Polska" albo ", województwo").
+ * @param point Wynik (współrzędne), jeśli miejsce jest znane.
+ * @return true, jeśli miejsce jest w spisie i jest jednoznaczne.
+ *
+ * Zapytania z dodatkowymi częściami (np. ulicą) nie są rozpoznawane - środek stacji miejscowości
+ * byłby dla nich zbyt mało dokładny. Nazwa miejscowości ma pierwszeństwo przed nazwą gminy;
+ * niejednoznaczna nazwa miejscowości nie jest zastępowana gminą o tej samej nazwie.
+ */
+bool OfflineGazetteer::lookup(const QString &query, GeoPoint *point) const {
+    const QStringList parts = GeocodeCache::normalize(query).split(',');
+    if (parts.size() > 2) {
+        return false;
+    }
+    QString province = parts.size() == 2 ? parts[1].trimmed() : QString();
+    if (province == QLatin1String("polska") || province == QLatin1String("poland")) {
+        province.clear();
+    } else if (province.startsWith(QLatin1String("wojewodztwo "))) {
+        province = province.mid(12);
+    }
+    const QString key = parts[0].trimmed();
+    auto city = cities.constFind(key);
+    if (city != cities.constEnd()) {
+        return pick(city.value(), province, point);
+    }
+    auto commune = communes.constFind(key);
+    if (commune != communes.constEnd()) {
+        return pick(commune.value(), province, point);
+    }
+    return false;
+}
+
+/**
+ * @brief Buduje spis miejsc według nazw z katalogu.
+ * @param catalog Katalog stacji.
+ * @param name Nazwa miejsca stacji (miejscowość albo gmina).
+ * @return Znormalizowana nazwa → miejsca o tej nazwie.
+ *
+ * Nazwy są internowane w katalogu, więc każda jest normalizowana tylko raz. Miejsce, którego stacje
+ * są od siebie dalej niż MaxPlaceExtent (kilka miejscowości o tej samej nazwie w jednym
+ * województwie), otrzymuje współrzędne NaN.
+ */
+QHash<QString, OfflineGazetteer::Places> OfflineGazetteer::collect(const StationCatalog &catalog,
+                                                                   const QString &(StationCatalog::*name)(int) const) {
+    QHash<QString, QString> foldedNames;
+    auto folded = [&foldedNames](const QString &text) {
+        /**
+         * @brief Lambda zwracająca znormalizowaną nazwę (zapamiętaną dla powtarzających się nazw).
+         * @param text Nazwa miejsca lub województwa.
+         * @return Znormalizowana nazwa.
+         */
+        auto it = foldedNames.constFind(text);
+        if (it == foldedNames.constEnd()) {
+            it = foldedNames.insert(text, GeocodeCache::normalize(text));
+        }
+        return it.value();
+    };
+
+    /// Stacje jednego miejsca.
+    struct Extent {
+        double latSum = 0.0; ///< Suma szerokości geograficznych.
+        double lonSum = 0.0; ///< Suma długości geograficznych.
+        int count = 0; ///< Liczba stacji.
+        double minLat = 90.0; ///< Najmniejsza szerokość geograficzna.
+        double maxLat = -90.0; ///< Największa szerokość geograficzna.
+        double minLon = 180.0; ///< Najmniejsza długość geograficzna.
+        double maxLon = -180.0; ///< Największa długość geograficzna.
+    };
+    QHash<QString, QHash<QString, Extent>> extents;
+    for (int i = 0; i < catalog.size(); ++i) {
+        if (!catalog.hasCoordinates(i)) {
+            continue;
+        }
+        const QString place = folded((catalog.*name)(i));
+        if (place.isEmpty()) {
+            continue;
+        }
+        Extent &extent = extents[place][folded(catalog.province(i))];
+        const double lat = catalog.latitude(i);
+        const double lon = catalog.longitude(i);
+        extent.latSum += lat;
+        extent.lonSum += lon;
+        extent.count++;
+        extent.minLat = qMin(extent.minLat, lat);
+        extent.maxLat = qMax(extent.maxLat, lat);
+        extent.minLon = qMin(extent.minLon, lon);
+        extent.maxLon = qMax(extent.maxLon, lon);
+    }
+
+    QHash<QString, Places> result;
+    result.reserve(extents.size());
+    for (auto place = extents.constBegin(); place != extents.constEnd(); ++place) {
+        Places &places = result[place.key()];
+        for (auto extent = place->constBegin(); extent != place->constEnd(); ++extent) {
+            const bool spread = extent->maxLat - extent->minLat > MaxPlaceExtent || extent->maxLon - extent->minLon > MaxPlaceExtent;
+            places.insert(extent.key(), spread ? GeoPoint{qQNaN(), qQNaN()}
+                                               : GeoPoint{extent->latSum / extent->count, extent->lonSum / extent->count});
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Wybiera miejsce o podanej nazwie.
+ * @param places Miejsca o tej samej nazwie.
+ * @param province Znormalizowane województwo (puste - dowolne).
+ * @param point Wynik (współrzędne), jeśli miejsce jest jednoznaczne.
+ * @return true, jeśli miejsce jest jednoznaczne.
+ */
+bool OfflineGazetteer::pick(const Places &places, const QString &province, GeoPoint *point) {
+    GeoPoint found;
+    if (!province.isEmpty()) {
+        auto it = places.constFind(province);
+        if (it == places.constEnd()) {
+            return false;
+        }
+        found = it.value();
+    } else if (places.size() == 1) {
+        found = places.constBegin().value();
+    } else {
+        return false; // Ta sama nazwa w kilku województwach
+    }
+    if (qIsNaN(found.lat)) {
+        return false;
+    }
+    *point = found;
+    return true;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file geocodecache.h
+ * @brief Trwała pamięć podręczna geokodowania (LRU) i lokalny spis miejscowości z katalogu stacji.
+ */
+
+#ifndef GEOCODECACHE_H
+#define GEOCODECACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <list>
+#include "stationcatalog.h"
+
+/**
+ * @struct GeoPoint
+ * @brief Współrzędne geograficzne punktu.
+ */
+struct GeoPoint {
+    double lat = 0.0; ///< Szerokość geograficzna (stopnie).
+    double lon = 0.0; ///< Długość geograficzna (stopnie).
+};
+
+/**
+ * @class GeocodeCache
+ * @brief Pamięć podręczna wyników geokodowania (znormalizowane zapytanie → współrzędne).
+ *
+ * Przechowuje co najwyżej capacity() ostatnio używanych zapytań; przy przepełnieniu usuwane jest
+ * najdawniej używane. Zawartość zapisywana jest w pliku JSON w katalogu podręcznym aplikacji
+ * po każdym dodaniu wpisu i wczytywana przy tworzeniu obiektu.
+ */
+class GeocodeCache {
+public:
+    /**
+     * @brief Tworzy pamięć podręczną i wczytuje zapisane wpisy.
+     * @param capacity Maksymalna liczba wpisów.
+     */
+    explicit GeocodeCache(int capacity = 256);
+
+    /**
+     * @brief Wyszukuje zapytanie w pamięci podręcznej i oznacza je jako ostatnio użyte.
+     * @param query Tekst lokalizacji.
+     * @param point Wynik (współrzędne), jeśli zapytanie jest znane.
+     * @return true, jeśli zapytanie jest w pamięci podręcznej.
+     */
+    bool lookup(const QString &query, GeoPoint *point);
+    /**
+     * @brief Dodaje wynik geokodowania i zapisuje pamięć podręczną na dysk.
+     * @param query Tekst lokalizacji.
+     * @param point Współrzędne.
+     */
+    void insert(const QString &query, const GeoPoint &point);
+
+    int size() const { return entries.size(); } ///< Liczba wpisów.
+    int capacity() const { return maxEntries; } ///< Maksymalna liczba wpisów.
+
+    /**
+     * @brief Normalizuje tekst lokalizacji: małe litery bez znaków diakrytycznych, pojedyncze spacje.
+     * @param query Tekst lokalizacji.
+     * @return Klucz pamięci podręcznej.
+     */
+    static QString normalize(const QString &query);
+
+private:
+    /// Wpis pamięci podręcznej.
+    struct Entry {
+        GeoPoint point; ///< Współrzędne.
+        std::list<QString>::iterator position; ///< Pozycja klucza na liście użycia.
+    };
+
+    /**
+     * @brief Wczytuje wpisy z pliku.
+     */
+    void load();
+    /**
+     * @brief Zapisuje wpisy do pliku (od najdawniej do ostatnio używanego).
+     */
+    void save() const;
+    /**
+     * @brief Dodaje wpis bez zapisu na dysk, usuwając w razie potrzeby najdawniej używany.
+     * @param key Znormalizowany klucz.
+     * @param point Współrzędne.
+     */
+    void put(const QString &key, const GeoPoint &point);
+
+    int maxEntries; ///< Maksymalna liczba wpisów.
+    QString filePath; ///< Ścieżka pliku z zapisanymi wpisami.
+    std::list<QString> recency; ///< Klucze od ostatnio do najdawniej używanego.
+    QHash<QString, Entry> entries; ///< Klucz → wpis.
+};
+
+/**
+ * @class OfflineGazetteer
+ * @brief Lokalny spis miejscowości i gmin ze współrzędnymi wyznaczonymi z katalogu stacji.
+ *
+ * Współrzędne miejscowości (lub gminy) to środek stacji w niej położonych. Zapytania w rodzaju
+ * "Kraków", "Kraków, Polska" albo "Nowa Wieś, mazowieckie" rozpoznawane są bez połączenia z siecią.
+ * Miejsca są rozróżniane według nazwy i województwa; nazwa występująca w kilku województwach
+ * (bez podanego województwa) albo obejmująca stacje zbyt odległe od siebie nie jest rozpoznawana,
+ * więc zapytanie trafia do geokodera sieciowego.
+ */
+class OfflineGazetteer {
+public:
+    /**
+     * @brief Buduje spis dla stacji katalogu.
+     * @param catalog Katalog stacji.
+     */
+    void build(const StationCatalog &catalog);
+    /**
+     * @brief Wyszukuje miejscowość lub gminę.
+     * @param query Tekst lokalizacji (sama nazwa, ewentualnie z dopiskiem ", Polska").
+     * @param point Wynik (współrzędne), jeśli miejsce jest znane.
+     * @return true, jeśli miejsce jest w spisie.
+     */
+    bool lookup(const QString &query, GeoPoint *point) const;
+
+    static constexpr double MaxPlaceExtent = 0.5; ///< Największy rozrzut stacji jednego miejsca (stopnie).
+
+private:
+    /// Miejsca o tej samej nazwie: znormalizowane województwo → środek stacji (NaN - miejsce niejednoznaczne).
+    using Places = QHash<QString, GeoPoint>;
+
+    /**
+     * @brief Buduje spis miejsc według nazw z katalogu.
+     * @param catalog Katalog stacji.
+     * @param name Nazwa miejsca stacji (miejscowość albo gmina).
+     * @return Znormalizowana nazwa → miejsca o tej nazwie.
+     */
+    static QHash<QString, Places> collect(const StationCatalog &catalog, const QString &(StationCatalog::*name)(int) const);
+    /**
+     * @brief Wybiera miejsce o podanej nazwie.
+     * @param places Miejsca o tej samej nazwie.
+     * @param province Znormalizowane województwo (puste - dowolne).
+     * @param point Wynik (współrzędne), jeśli miejsce jest jednoznaczne.
+     * @return true, jeśli miejsce jest jednoznaczne.
+     */
+    static bool pick(const Places &places, const QString &province, GeoPoint *point);
+
+    QHash<QString, Places> cities; ///< Znormalizowana nazwa miejscowości → miejscowości o tej nazwie.
+    QHash<QString, Places> communes; ///< Znormalizowana nazwa gminy → gminy o tej nazwie.
+};
+
+#endif // GEOCODECACHE_H
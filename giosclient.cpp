@@ -0,0 +1,233 @@
+/**
+ * @file giosclient.cpp
+ * @brief Implementacja klienta API GIOŚ.
+ */
+
+#include "giosclient.h"
+#include "giosresponsecache.h"
+#include <QDebug>
+#include <QSslConfiguration>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+const char ApiHost[] = "api.gios.gov.pl"; ///< Host API GIOŚ.
+const char ApiBase[] = "https://api.gios.gov.pl/pjp-api/rest/"; ///< Adres bazowy zasobów API GIOŚ.
+
+} // namespace
+
+/**
+ * @brief Tworzy klienta i otwiera z wyprzedzeniem połączenie z API GIOŚ.
+ * @param parent Obiekt nadrzędny.
+ *
+ * Uzgadnianie TLS odbywa się w tle, zanim powstanie pierwsze zapytanie. Połączenie ogłasza w ALPN protokół
+ * HTTP/2, tak jak zapytania z Http2AllowedAttribute - inaczej powstałoby połączenie HTTP/1.1, którego
+ * zapytania HTTP/2 nie mogłyby ponownie wykorzystać.
+ */
+GiosClient::GiosClient(QObject *parent) : QObject(parent), manager(new QNetworkAccessManager(this)) {
+    GiosResponseCache::install(manager);
+    QSslConfiguration sslConfig = QSslConfiguration::defaultConfiguration();
+    sslConfig.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2});
+    manager->connectToHostEncrypted(ApiHost, 443, sslConfig);
+}
+
+/**
+ * @brief Pobiera katalog wszystkich stacji (@c station/findAll).
+ * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+ * @param done Wywołanie zwrotne.
+ * @param control Sposób korzystania z pamięci podręcznej (AlwaysNetwork - okresowe odświeżanie katalogu).
+ *
+ * Przy AlwaysNetwork ważna kopia w pamięci podręcznej jest pomijana, ale bez połączenia z serwerem
+ * zapytanie nadal jest powtarzane z tej kopii.
+ */
+void GiosClient::fetchCatalog(QObject *context, CatalogCallback done, QNetworkRequest::CacheLoadControl control) {
+    enqueue<CatalogStreamParser>(QUrl(QString(ApiBase) + "station/findAll"), Visible, -1, control, context,
+                                 [done](const GiosResult &result, CatalogStreamParser &parser) {
+                                     /**
+                                      * @brief Lambda przekazująca zbudowany katalog do wywołania zwrotnego.
+                                      */
+                                     StationCatalog catalog = parser.takeCatalog();
+                                     done(result, catalog);
+                                 });
+}
+
+/**
+ * @brief Pobiera listę sensorów stacji (@c station/sensors/{id}).
+ * @param stationId Identyfikator stacji.
+ * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+ * @param done Wywołanie zwrotne.
+ * @param priority Priorytet zapytania w kolejce.
+ */
+void GiosClient::fetchSensors(int stationId, QObject *context, SensorsCallback done, Priority priority) {
+    enqueue<SensorListStreamParser>(QUrl(QString(ApiBase) + QString("station/sensors/%1").arg(stationId)), priority, -1, QNetworkRequest::PreferNetwork, context,
+                                    [done](const GiosResult &result, SensorListStreamParser &parser) {
+                                        /**
+                                         * @brief Lambda przekazująca listę sensorów do wywołania zwrotnego.
+                                         */
+                                        done(result, parser.sensors());
+                                    });
+}
+
+/**
+ * @brief Pobiera dane pomiarowe sensora (@c data/getData/{id}).
+ * @param sensorId Identyfikator sensora.
+ * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+ * @param done Wywołanie zwrotne.
+ * @param priority Priorytet zapytania w kolejce.
+ */
+void GiosClient::fetchData(int sensorId, QObject *context, SeriesCallback done, Priority priority) {
+    enqueue<SeriesStreamParser>(QUrl(QString(ApiBase) + QString("data/getData/%1").arg(sensorId)), priority, sensorId, QNetworkRequest::PreferNetwork, context,
+                                [done](const GiosResult &result, SeriesStreamParser &parser) {
+                                    /**
+                                     * @brief Lambda przekazująca szereg pomiarów do wywołania zwrotnego.
+                                     */
+                                    SensorSeries series = parser.takeSeries();
+                                    done(result, series);
+                                });
+}
+
+/**
+ * @brief Pobiera indeks jakości powietrza stacji (@c aqindex/getIndex/{id}).
+ * @param stationId Identyfikator stacji.
+ * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+ * @param done Wywołanie zwrotne.
+ * @param priority Priorytet zapytania w kolejce.
+ */
+void GiosClient::fetchIndex(int stationId, QObject *context, IndexCallback done, Priority priority) {
+    enqueue<IndexStreamParser>(QUrl(QString(ApiBase) + QString("aqindex/getIndex/%1").arg(stationId)), priority, -1, QNetworkRequest::PreferNetwork, context,
+                               [done](const GiosResult &result, IndexStreamParser &parser) {
+                                   /**
+                                    * @brief Lambda przekazująca indeks stacji do wywołania zwrotnego.
+                                    */
+                                   done(result, parser.index());
+                               });
+}
+
+/**
+ * @brief Zmienia priorytet oczekujących zapytań o dane sensora.
+ * @param sensorId Identyfikator sensora.
+ * @param context Obiekt kontekstu, z którym zapytania zostały dodane.
+ * @param priority Nowy priorytet.
+ */
+void GiosClient::setDataPriority(int sensorId, QObject *context, Priority priority) {
+    for (PendingRequest &request : pending) {
+        if (request.sensorId == sensorId && request.context == context) {
+            request.priority = priority;
+        }
+    }
+}
+
+/**
+ * @brief Ustawia maksymalną liczbę jednocześnie trwających zapytań.
+ * @param count Liczba zapytań (co najmniej 1).
+ */
+void GiosClient::setMaxConcurrentRequests(int count) {
+    maxConcurrent = qMax(1, count);
+    startPending();
+}
+
+/**
+ * @brief Dodaje zapytanie do kolejki.
+ * @param url Adres zasobu.
+ * @param priority Priorytet.
+ * @param sensorId ID sensora (-1 dla zapytań innych niż @c getData).
+ * @param control Sposób korzystania z pamięci podręcznej.
+ * @param context Obiekt kontekstu wywołania zwrotnego.
+ * @param done Wywołanie zwrotne z wynikiem i parserem.
+ */
+template <typename Parser>
+void GiosClient::enqueue(const QUrl &url, Priority priority, int sensorId, QNetworkRequest::CacheLoadControl control, QObject *context,
+                         std::function<void(const GiosResult &, Parser &)> done) {
+    QPointer<QObject> guard(context);
+    pending.append({nextSequence++, priority, sensorId, guard, [this, url, control, guard, done]() {
+                        /**
+                         * @brief Lambda wysyłająca zapytanie zdjęte z kolejki.
+                         */
+                        get<Parser>(url, control, guard, done);
+                    }});
+    startPending();
+}
+
+/**
+ * @brief Wysyła zapytania z kolejki, dopóki jest wolne miejsce.
+ *
+ * Zapytania, których obiekt kontekstu już nie istnieje, są pomijane.
+ */
+void GiosClient::startPending() {
+    while (running < maxConcurrent && !pending.isEmpty()) {
+        auto next = std::min_element(pending.begin(), pending.end(), [](const PendingRequest &a, const PendingRequest &b) {
+            /**
+             * @brief Lambda porządkująca zapytania według priorytetu i kolejności zgłoszenia.
+             */
+            return a.priority != b.priority ? a.priority < b.priority : a.sequence < b.sequence;
+        });
+        PendingRequest request = *next;
+        pending.erase(next);
+        if (!request.context) {
+            continue;
+        }
+        running++;
+        request.start();
+    }
+}
+
+/**
+ * @brief Wysyła zapytanie i przekazuje odpowiedź do parsera strumieniowego.
+ * @param url Adres zasobu.
+ * @param control Sposób korzystania z pamięci podręcznej.
+ * @param context Obiekt kontekstu wywołania zwrotnego.
+ * @param done Wywołanie zwrotne z wynikiem i parserem.
+ *
+ * Przy braku połączenia z serwerem zapytanie jest powtarzane z kopii w pamięci podręcznej (w tym samym
+ * miejscu kolejki). Po zakończeniu zwalniane jest miejsce dla następnego zapytania z kolejki.
+ */
+template <typename Parser>
+void GiosClient::get(const QUrl &url, QNetworkRequest::CacheLoadControl control, const QPointer<QObject> &context,
+                     std::function<void(const GiosResult &, Parser &)> done) {
+    qDebug() << "Wysyłanie zapytania do:" << url.toString();
+    QNetworkRequest request = GiosResponseCache::request(url, control);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    QNetworkReply *reply = manager->get(request);
+    auto parser = std::make_shared<Parser>();
+    connect(reply, &QNetworkReply::readyRead, this, [reply, parser]() {
+        /**
+         * @brief Lambda przekazująca kolejne fragmenty odpowiedzi do parsera strumieniowego.
+         */
+        parser->feed(reply->readAll());
+    });
+    connect(reply, &QNetworkReply::finished, this, [this, url, context, done, reply, parser]() {
+        /**
+         * @brief Lambda kończąca parsowanie i przekazująca wynik do wywołania zwrotnego.
+         */
+        if (context && GiosResponseCache::canRetryFromCache(reply)) {
+            qDebug() << "Brak połączenia z GIOŚ (" << reply->errorString() << ") - używam zapisanej odpowiedzi" << url.toString();
+            get<Parser>(url, QNetworkRequest::AlwaysCache, context, done);
+            return;
+        }
+
+        GiosResult result;
+        result.fromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+        if (reply->error() != QNetworkReply::NoError) {
+            result.status = GiosResult::NetworkError;
+            result.errorString = reply->errorString();
+        } else {
+            // Dokończ parsowanie danych, które nie zostały jeszcze odczytane w readyRead
+            parser->feed(reply->readAll());
+            if (!parser->finish()) {
+                result.status = GiosResult::ParseError;
+                result.errorString = parser->errorString();
+            }
+        }
+        running--;
+        if (context) {
+            done(result, *parser);
+        }
+        startPending();
+    });
+    connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
+    // Zapytanie bez odbiorcy nie jest potrzebne
+    if (context) {
+        connect(context.data(), &QObject::destroyed, reply, &QNetworkReply::abort);
+    }
+}
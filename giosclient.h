@@ -0,0 +1,178 @@
+/**
+ * @file giosclient.h
+ * @brief Wspólny dla całej aplikacji klient API GIOŚ z jednym menadżerem sieci.
+ */
+
+#ifndef GIOSCLIENT_H
+#define GIOSCLIENT_H
+
+#include <QObject>
+#include <QPointer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+#include <functional>
+#include "giosstreamparsers.h"
+
+/**
+ * @struct GiosResult
+ * @brief Wynik zapytania do API GIOŚ.
+ */
+struct GiosResult {
+    /// Rodzaj wyniku.
+    enum Status { Ok, NetworkError, ParseError };
+
+    Status status = Ok; ///< Rodzaj wyniku.
+    QString errorString; ///< Opis błędu (pusty dla Ok).
+    bool fromCache = false; ///< Czy odpowiedź pochodzi z pamięci podręcznej.
+
+    bool ok() const { return status == Ok; } ///< Czy zapytanie się powiodło.
+};
+
+/**
+ * @class GiosClient
+ * @brief Klient API GIOŚ z typowanymi, asynchronicznymi zapytaniami.
+ *
+ * Wszystkie zapytania (także geokodowanie) idą przez jeden QNetworkAccessManager z pamięcią podręczną
+ * GiosResponseCache, po HTTPS z dopuszczonym HTTP/2. Zapytania do tego samego hosta współdzielą więc
+ * jedną rozgrzaną sesję TLS, a równoległe pobieranie danych sensorów jest multipleksowane w jednym
+ * połączeniu zamiast otwierania kilku osobnych.
+ *
+ * Odpowiedzi są parsowane strumieniowo w miarę nadchodzenia danych. Wywołanie zwrotne wykonywane jest
+ * w wątku GUI, o ile obiekt kontekstu nadal istnieje. Przy braku połączenia z serwerem zapytanie jest
+ * automatycznie powtarzane z kopii zapisanej w pamięci podręcznej.
+ *
+ * Jednocześnie trwa co najwyżej maxConcurrentRequests() zapytań; pozostałe czekają w kolejce
+ * uporządkowanej priorytetem, a w ramach priorytetu kolejnością zgłoszenia. Dzięki temu dane sensora
+ * widocznego na wykresie nie czekają na pobranie wszystkich pozostałych.
+ */
+class GiosClient : public QObject {
+    Q_OBJECT
+
+public:
+    /// Wywołanie zwrotne z katalogiem stacji (katalog można przenieść).
+    using CatalogCallback = std::function<void(const GiosResult &result, StationCatalog &catalog)>;
+    /// Wywołanie zwrotne z listą sensorów stacji.
+    using SensorsCallback = std::function<void(const GiosResult &result, const QVector<SensorDescriptor> &sensors)>;
+    /// Wywołanie zwrotne z szeregiem pomiarów sensora (szereg można przenieść).
+    using SeriesCallback = std::function<void(const GiosResult &result, SensorSeries &series)>;
+    /// Wywołanie zwrotne z indeksem jakości powietrza stacji.
+    using IndexCallback = std::function<void(const GiosResult &result, const StationIndex &index)>;
+
+    /// Priorytet zapytania (mniejsza wartość - wcześniejsze wysłanie).
+    enum Priority {
+        Visible = 0, ///< Dane wyświetlane w tej chwili (wybrany sensor, katalog, lista sensorów).
+        Table = 1, ///< Pozostałe dane otwartej karty.
+        Prefetch = 2 ///< Pobieranie w tle.
+    };
+
+    /**
+     * @brief Tworzy klienta i otwiera z wyprzedzeniem połączenie z API GIOŚ.
+     * @param parent Obiekt nadrzędny.
+     */
+    explicit GiosClient(QObject *parent = nullptr);
+
+    /**
+     * @brief Pobiera katalog wszystkich stacji (@c station/findAll).
+     * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+     * @param done Wywołanie zwrotne.
+     * @param control Sposób korzystania z pamięci podręcznej (AlwaysNetwork - okresowe odświeżanie katalogu).
+     */
+    void fetchCatalog(QObject *context, CatalogCallback done,
+                      QNetworkRequest::CacheLoadControl control = QNetworkRequest::PreferNetwork);
+    /**
+     * @brief Pobiera listę sensorów stacji (@c station/sensors/{id}).
+     * @param stationId Identyfikator stacji.
+     * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+     * @param done Wywołanie zwrotne.
+     * @param priority Priorytet zapytania w kolejce.
+     */
+    void fetchSensors(int stationId, QObject *context, SensorsCallback done, Priority priority = Visible);
+    /**
+     * @brief Pobiera dane pomiarowe sensora (@c data/getData/{id}).
+     * @param sensorId Identyfikator sensora.
+     * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+     * @param done Wywołanie zwrotne.
+     * @param priority Priorytet zapytania w kolejce.
+     */
+    void fetchData(int sensorId, QObject *context, SeriesCallback done, Priority priority = Table);
+    /**
+     * @brief Pobiera indeks jakości powietrza stacji (@c aqindex/getIndex/{id}).
+     * @param stationId Identyfikator stacji.
+     * @param context Obiekt, którego usunięcie anuluje wywołanie zwrotne.
+     * @param done Wywołanie zwrotne.
+     * @param priority Priorytet zapytania w kolejce.
+     */
+    void fetchIndex(int stationId, QObject *context, IndexCallback done, Priority priority = Prefetch);
+    /**
+     * @brief Zmienia priorytet oczekujących zapytań o dane sensora.
+     * @param sensorId Identyfikator sensora.
+     * @param context Obiekt kontekstu, z którym zapytania zostały dodane.
+     * @param priority Nowy priorytet.
+     *
+     * Zapytania już wysłane nie są zmieniane; zapytania o ten sam sensor z innym kontekstem
+     * (np. dane mapy ciepła) zachowują swój priorytet.
+     */
+    void setDataPriority(int sensorId, QObject *context, Priority priority);
+
+    /**
+     * @brief Ustawia maksymalną liczbę jednocześnie trwających zapytań.
+     * @param count Liczba zapytań (co najmniej 1).
+     */
+    void setMaxConcurrentRequests(int count);
+    int maxConcurrentRequests() const { return maxConcurrent; } ///< Maksymalna liczba jednoczesnych zapytań.
+
+    /**
+     * @brief Zwraca wspólny menadżer sieci (np. dla zapytań do innych usług).
+     * @return Menadżer sieci klienta.
+     */
+    QNetworkAccessManager *networkManager() const { return manager; }
+
+private:
+    /// Zapytanie oczekujące w kolejce.
+    struct PendingRequest {
+        quint64 sequence; ///< Kolejność zgłoszenia.
+        Priority priority; ///< Priorytet.
+        int sensorId; ///< ID sensora (-1 dla zapytań innych niż @c getData).
+        QPointer<QObject> context; ///< Obiekt kontekstu wywołania zwrotnego.
+        std::function<void()> start; ///< Wysyła zapytanie.
+    };
+
+    /**
+     * @brief Dodaje zapytanie do kolejki.
+     * @param url Adres zasobu.
+     * @param priority Priorytet.
+     * @param sensorId ID sensora (-1 dla zapytań innych niż @c getData).
+     * @param control Sposób korzystania z pamięci podręcznej.
+     * @param context Obiekt kontekstu wywołania zwrotnego.
+     * @param done Wywołanie zwrotne z wynikiem i parserem.
+     */
+    template <typename Parser>
+    void enqueue(const QUrl &url, Priority priority, int sensorId, QNetworkRequest::CacheLoadControl control, QObject *context,
+                 std::function<void(const GiosResult &, Parser &)> done);
+    /**
+     * @brief Wysyła zapytania z kolejki, dopóki jest wolne miejsce.
+     */
+    void startPending();
+    /**
+     * @brief Wysyła zapytanie i przekazuje odpowiedź do parsera strumieniowego.
+     * @param url Adres zasobu.
+     * @param control Sposób korzystania z pamięci podręcznej.
+     * @param context Obiekt kontekstu wywołania zwrotnego.
+     * @param done Wywołanie zwrotne z wynikiem i parserem.
+     */
+    template <typename Parser>
+    void get(const QUrl &url, QNetworkRequest::CacheLoadControl control, const QPointer<QObject> &context,
+             std::function<void(const GiosResult &, Parser &)> done);
+
+    QNetworkAccessManager *manager; ///< Jedyny menadżer sieci aplikacji.
+    QVector<PendingRequest> pending; ///< Zapytania oczekujące na wysłanie.
+    quint64 nextSequence = 0; ///< Numer kolejnego zgłoszenia.
+    int running = 0; ///< Liczba trwających zapytań.
+    int maxConcurrent = 4; ///< Maksymalna liczba jednoczesnych zapytań.
+};
+
+#endif // GIOSCLIENT_H
@@ -0,0 +1,150 @@
+/**
+ * @file giosresponsecache.cpp
+ * @brief Implementacja pamięci podręcznej odpowiedzi API GIOŚ.
+ */
+
+#include "giosresponsecache.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QStandardPaths>
+
+namespace {
+
+constexpr qint64 CatalogTimeToLive = 7 * 24 * 3600; ///< Ważność listy stacji (s).
+constexpr qint64 SensorListTimeToLive = 7 * 24 * 3600; ///< Ważność listy sensorów stacji (s).
+constexpr qint64 IndexTimeToLive = 20 * 60; ///< Ważność indeksu jakości powietrza stacji (s).
+constexpr qint64 MaximumCacheSize = 64 * 1024 * 1024; ///< Maksymalny rozmiar pamięci podręcznej (B).
+
+} // namespace
+
+/**
+ * @brief Tworzy pamięć podręczną w katalogu podręcznym aplikacji.
+ * @param parent Obiekt nadrzędny.
+ */
+GiosResponseCache::GiosResponseCache(QObject *parent) : QNetworkDiskCache(parent) {
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (directory.isEmpty()) {
+        directory = QDir::tempPath() + "/GIOSrevamp";
+    }
+    setCacheDirectory(directory + "/http");
+    setMaximumCacheSize(MaximumCacheSize);
+}
+
+/**
+ * @brief Instaluje pamięć podręczną w menadżerze sieci.
+ * @param manager Menadżer, który przejmuje własność pamięci podręcznej.
+ */
+void GiosResponseCache::install(QNetworkAccessManager *manager) {
+    manager->setCache(new GiosResponseCache(manager));
+}
+
+/**
+ * @brief Zwraca czas ważności odpowiedzi dla adresu.
+ * @param url Adres zasobu.
+ * @return Czas w sekundach lub -1 dla zasobów spoza API GIOŚ.
+ */
+qint64 GiosResponseCache::timeToLive(const QUrl &url) {
+    if (url.host() != QLatin1String("api.gios.gov.pl")) {
+        return -1;
+    }
+    const QString path = url.path();
+    if (path.contains(QLatin1String("/station/findAll"))) {
+        return CatalogTimeToLive;
+    }
+    if (path.contains(QLatin1String("/station/sensors/"))) {
+        return SensorListTimeToLive;
+    }
+    if (path.contains(QLatin1String("/data/getData/"))) {
+        return DataTimeToLive;
+    }
+    if (path.contains(QLatin1String("/aqindex/getIndex/"))) {
+        return IndexTimeToLive;
+    }
+    return -1;
+}
+
+/**
+ * @brief Tworzy zapytanie GET do API GIOŚ.
+ * @param url Adres zasobu.
+ * @param control Sposób korzystania z pamięci podręcznej.
+ * @return Zapytanie z nagłówkiem User-Agent aplikacji.
+ */
+QNetworkRequest GiosResponseCache::request(const QUrl &url, QNetworkRequest::CacheLoadControl control) {
+    QNetworkRequest request;
+    request.setUrl(url);
+    request.setHeader(QNetworkRequest::UserAgentHeader, "MyStationFinderApp/1.0");
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, control);
+    return request;
+}
+
+/**
+ * @brief Sprawdza, czy nieudane zapytanie można powtórzyć z kopii zapisanej na dysku.
+ * @param reply Zakończona odpowiedź.
+ * @return true przy braku połączenia z serwerem, jeśli zapisana kopia istnieje.
+ */
+bool GiosResponseCache::canRetryFromCache(QNetworkReply *reply) {
+    const QNetworkReply::NetworkError error = reply->error();
+    // Kody 1-99 to błędy połączenia, 101-199 błędy proxy; przerwane zapytanie nie jest ponawiane
+    const bool connectionError = (error > QNetworkReply::NoError && error < QNetworkReply::ProxyConnectionRefusedError
+                                  && error != QNetworkReply::OperationCanceledError)
+                                 || (error >= QNetworkReply::ProxyConnectionRefusedError && error < QNetworkReply::ContentAccessDenied)
+                                 || error == QNetworkReply::ServiceUnavailableError
+                                 || error == QNetworkReply::InternalServerError;
+    if (!connectionError) {
+        return false;
+    }
+    const QNetworkRequest request = reply->request();
+    if (request.attribute(QNetworkRequest::CacheLoadControlAttribute).toInt() == QNetworkRequest::AlwaysCache) {
+        return false;
+    }
+    QAbstractNetworkCache *cache = reply->manager() ? reply->manager()->cache() : nullptr;
+    return cache && cache->metaData(request.url()).isValid();
+}
+
+/**
+ * @brief Rozpoczyna zapis odpowiedzi do pamięci podręcznej.
+ * @param metaData Metadane odpowiedzi.
+ * @return Urządzenie, do którego zapisywana jest treść (lub nullptr).
+ */
+QIODevice *GiosResponseCache::prepare(const QNetworkCacheMetaData &metaData) {
+    return QNetworkDiskCache::prepare(withPolicy(metaData));
+}
+
+/**
+ * @brief Aktualizuje metadane po odświeżeniu odpowiedzi (odpowiedź 304 Not Modified).
+ * @param metaData Nowe metadane.
+ *
+ * Potwierdzona przez serwer odpowiedź otrzymuje nowy czas ważności.
+ */
+void GiosResponseCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
+    QNetworkDiskCache::updateMetaData(withPolicy(metaData));
+}
+
+/**
+ * @brief Nadaje metadanym odpowiedzi GIOŚ czas ważności i usuwa blokujące zapis nagłówki.
+ * @param metaData Metadane odpowiedzi.
+ * @return Metadane do zapisania.
+ */
+QNetworkCacheMetaData GiosResponseCache::withPolicy(const QNetworkCacheMetaData &metaData) {
+    const qint64 ttl = timeToLive(metaData.url());
+    if (ttl < 0 || !metaData.isValid()) {
+        return metaData;
+    }
+
+    QNetworkCacheMetaData result = metaData;
+    result.setSaveToDisk(true);
+    result.setExpirationDate(QDateTime::currentDateTimeUtc().addSecs(ttl));
+
+    // Nagłówki no-cache/must-revalidate wymusiłyby zapytanie przy każdym użyciu - ważność określa TTL
+    QNetworkCacheMetaData::RawHeaderList headers;
+    for (const QNetworkCacheMetaData::RawHeader &header : metaData.rawHeaders()) {
+        if (header.first.compare("Cache-Control", Qt::CaseInsensitive) != 0
+            && header.first.compare("Pragma", Qt::CaseInsensitive) != 0
+            && header.first.compare("Expires", Qt::CaseInsensitive) != 0) {
+            headers.append(header);
+        }
+    }
+    result.setRawHeaders(headers);
+    return result;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file giosresponsecache.h
+ * @brief Trwała pamięć podręczna odpowiedzi HTTP z czasem ważności zależnym od zasobu API GIOŚ.
+ */
+
+#ifndef GIOSRESPONSECACHE_H
+#define GIOSRESPONSECACHE_H
+
+#include <QNetworkDiskCache>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QUrl>
+
+/**
+ * @class GiosResponseCache
+ * @brief Dyskowa pamięć podręczna QNetworkAccessManager z własnymi czasami ważności odpowiedzi GIOŚ.
+ *
+ * API GIOŚ nie podaje sensownych nagłówków Cache-Control, dlatego odpowiedzi są zapisywane zawsze,
+ * a czas ważności wynika z rodzaju zasobu: lista stacji i listy sensorów zmieniają się rzadko,
+ * dane pomiarowe są ważne ok. godziny. Świeża odpowiedź jest zwracana bez połączenia z serwerem;
+ * przeterminowana jest odświeżana zapytaniem warunkowym (If-None-Match / If-Modified-Since),
+ * więc niezmieniona treść nie jest pobierana ponownie. Odpowiedzi spoza API GIOŚ obsługiwane są
+ * zgodnie z nagłówkami serwera.
+ */
+class GiosResponseCache : public QNetworkDiskCache {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Tworzy pamięć podręczną w katalogu podręcznym aplikacji.
+     * @param parent Obiekt nadrzędny.
+     */
+    explicit GiosResponseCache(QObject *parent = nullptr);
+
+    static constexpr qint64 DataTimeToLive = 3600; ///< Ważność danych pomiarowych (s).
+
+    /**
+     * @brief Instaluje pamięć podręczną w menadżerze sieci.
+     * @param manager Menadżer, który przejmuje własność pamięci podręcznej.
+     */
+    static void install(QNetworkAccessManager *manager);
+    /**
+     * @brief Zwraca czas ważności odpowiedzi dla adresu.
+     * @param url Adres zasobu.
+     * @return Czas w sekundach lub -1 dla zasobów spoza API GIOŚ.
+     */
+    static qint64 timeToLive(const QUrl &url);
+    /**
+     * @brief Tworzy zapytanie GET do API GIOŚ.
+     * @param url Adres zasobu.
+     * @param control Sposób korzystania z pamięci podręcznej.
+     * @return Zapytanie z nagłówkiem User-Agent aplikacji.
+     */
+    static QNetworkRequest request(const QUrl &url, QNetworkRequest::CacheLoadControl control = QNetworkRequest::PreferNetwork);
+    /**
+     * @brief Sprawdza, czy nieudane zapytanie można powtórzyć z kopii zapisanej na dysku.
+     * @param reply Zakończona odpowiedź.
+     * @return true przy braku połączenia z serwerem, jeśli zapisana kopia istnieje.
+     *
+     * Dzięki temu aplikacja działa bez sieci na danych, które były kiedyś pobrane (nawet przeterminowanych).
+     */
+    static bool canRetryFromCache(QNetworkReply *reply);
+
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+
+private:
+    /**
+     * @brief Nadaje metadanym odpowiedzi GIOŚ czas ważności i usuwa blokujące zapis nagłówki.
+     * @param metaData Metadane odpowiedzi.
+     * @return Metadane do zapisania.
+     */
+    static QNetworkCacheMetaData withPolicy(const QNetworkCacheMetaData &metaData);
+};
+
+#endif // GIOSRESPONSECACHE_H
@@ -0,0 +1,299 @@
+/**
+ * @file giosstreamparsers.cpp
+ * @brief Implementacja strumieniowych parserów odpowiedzi API GIOŚ.
+ */
+
+#include "giosstreamparsers.h"
+#include "giostime.h"
+#include <QtNumeric>
+
+/**
+ * @brief Konstruktor klasy GiosStreamParser.
+ */
+GiosStreamParser::GiosStreamParser()
+    : reader(this) {}
+
+/**
+ * @brief Kończy parsowanie i sprawdza kompletność odpowiedzi.
+ * @return true, jeśli odpowiedź była kompletna i poprawna.
+ */
+bool GiosStreamParser::finish() {
+    if (!reader.finish()) {
+        return false;
+    }
+    documentFinished();
+    return true;
+}
+
+/**
+ * @brief Zamienia wartość tekstową lub liczbową współrzędnej na liczbę.
+ * @param text Tekst wartości.
+ * @return Liczba lub NaN.
+ */
+double GiosStreamParser::parseDouble(QByteArrayView text) {
+    bool ok = false;
+    double value = text.trimmed().toDouble(&ok);
+    return ok ? value : qQNaN();
+}
+
+/**
+ * @brief Konstruktor klasy CatalogStreamParser.
+ */
+CatalogStreamParser::CatalogStreamParser()
+    : field(Other), inCity(false), inCommune(false), stationId(0), lat(qQNaN()), lon(qQNaN()) {}
+
+/**
+ * @brief Obsługuje początek obiektu (stacja, miejscowość lub gmina).
+ */
+void CatalogStreamParser::startObject() {
+    if (depth() == 2) {
+        // Nowa stacja w tablicy najwyższego poziomu
+        stationId = 0;
+        stationName.clear();
+        cityName.clear();
+        communeName.clear();
+        provinceName.clear();
+        lat = qQNaN();
+        lon = qQNaN();
+    } else if (depth() == 3 && field == City) {
+        inCity = true;
+    } else if (depth() == 4 && inCity && field == Commune) {
+        inCommune = true;
+    }
+    field = Other;
+}
+
+/**
+ * @brief Obsługuje koniec obiektu; po zamknięciu stacji dodaje ją do katalogu.
+ */
+void CatalogStreamParser::endObject() {
+    if (depth() == 3) {
+        inCommune = false;
+    } else if (depth() == 2) {
+        inCity = false;
+    } else if (depth() == 1) {
+        catalog.append(stationId, stationName, cityName, communeName, provinceName, lat, lon);
+    }
+    field = Other;
+}
+
+/**
+ * @brief Rozpoznaje klucz w obiekcie stacji, miejscowości lub gminy.
+ * @param name Nazwa klucza.
+ */
+void CatalogStreamParser::key(QByteArrayView name) {
+    field = Other;
+    if (inCommune) {
+        if (depth() != 4) return;
+        if (name == "communeName") field = CommuneName;
+        else if (name == "provinceName") field = ProvinceName;
+    } else if (inCity) {
+        if (depth() != 3) return;
+        if (name == "name") field = CityName;
+        else if (name == "commune") field = Commune;
+    } else if (depth() == 2) {
+        if (name == "id") field = Id;
+        else if (name == "stationName") field = StationName;
+        else if (name == "gegrLat") field = GegrLat;
+        else if (name == "gegrLon") field = GegrLon;
+        else if (name == "city") field = City;
+    }
+}
+
+/**
+ * @brief Zapisuje wartość napisową bieżącego pola.
+ * @param text Wartość w UTF-8.
+ */
+void CatalogStreamParser::stringValue(QByteArrayView text) {
+    switch (field) {
+    case StationName: stationName = QString::fromUtf8(text); break;
+    case GegrLat: lat = parseDouble(text); break;
+    case GegrLon: lon = parseDouble(text); break;
+    case CityName: cityName = QString::fromUtf8(text); break;
+    case CommuneName: communeName = QString::fromUtf8(text); break;
+    case ProvinceName: provinceName = QString::fromUtf8(text); break;
+    default: break;
+    }
+    field = Other;
+}
+
+/**
+ * @brief Zapisuje wartość liczbową bieżącego pola.
+ * @param value Wartość.
+ */
+void CatalogStreamParser::numberValue(double value) {
+    switch (field) {
+    case Id: stationId = int(value); break;
+    case GegrLat: lat = value; break;
+    case GegrLon: lon = value; break;
+    default: break;
+    }
+    field = Other;
+}
+
+/**
+ * @brief Obsługuje początek obiektu sensora.
+ */
+void SensorListStreamParser::startObject() {
+    if (depth() == 2) {
+        current = SensorDescriptor();
+    }
+    field = Other;
+}
+
+/**
+ * @brief Obsługuje koniec obiektu; po zamknięciu sensora dodaje go do listy.
+ */
+void SensorListStreamParser::endObject() {
+    if (depth() == 1) {
+        result.append(current);
+    }
+    field = Other;
+}
+
+/**
+ * @brief Rozpoznaje klucz w obiekcie sensora lub parametru.
+ * @param name Nazwa klucza.
+ */
+void SensorListStreamParser::key(QByteArrayView name) {
+    field = Other;
+    if (depth() == 2 && name == "id") field = Id;
+    else if (depth() == 3 && name == "paramCode") field = ParamCode;
+    else if (depth() == 3 && name == "paramName") field = ParamName;
+}
+
+/**
+ * @brief Zapisuje wartość napisową bieżącego pola.
+ * @param text Wartość w UTF-8.
+ */
+void SensorListStreamParser::stringValue(QByteArrayView text) {
+    if (field == ParamCode) current.paramCode = QString::fromUtf8(text);
+    else if (field == ParamName) current.paramName = QString::fromUtf8(text);
+    field = Other;
+}
+
+/**
+ * @brief Zapisuje wartość liczbową bieżącego pola.
+ * @param value Wartość.
+ */
+void SensorListStreamParser::numberValue(double value) {
+    if (field == Id) current.id = int(value);
+    field = Other;
+}
+
+/**
+ * @brief Obsługuje początek obiektu pomiaru w tablicy @c values.
+ */
+void SeriesStreamParser::startObject() {
+    if (depth() == 3) {
+        hasDate = false;
+        hasValue = false;
+        valueIsNull = true;
+        value = 0.0f;
+    }
+    field = Other;
+}
+
+/**
+ * @brief Obsługuje koniec obiektu; kompletny pomiar trafia do szeregu.
+ */
+void SeriesStreamParser::endObject() {
+    if (depth() == 2 && hasDate && hasValue) {
+        series.append(timestamp, value, valueIsNull);
+    }
+    field = Other;
+}
+
+/**
+ * @brief Rozpoznaje klucz w obiekcie pomiaru.
+ * @param name Nazwa klucza.
+ */
+void SeriesStreamParser::key(QByteArrayView name) {
+    field = Other;
+    if (depth() == 3) {
+        if (name == "date") field = Date;
+        else if (name == "value") field = Value;
+    }
+}
+
+/**
+ * @brief Zapisuje datę (lub wartość przesłaną jako tekst) bieżącego pomiaru.
+ * @param text Wartość w UTF-8.
+ */
+void SeriesStreamParser::stringValue(QByteArrayView text) {
+    if (field == Date) {
+        hasDate = GiosTime::parse(text, &timestamp);
+        if (!hasDate) {
+            timestamp = 0;
+        }
+    } else if (field == Value) {
+        double parsed = parseDouble(text);
+        hasValue = true;
+        valueIsNull = qIsNaN(parsed);
+        value = valueIsNull ? 0.0f : float(parsed);
+    }
+    field = Other;
+}
+
+/**
+ * @brief Zapisuje wartość liczbową bieżącego pomiaru.
+ * @param number Wartość.
+ */
+void SeriesStreamParser::numberValue(double number) {
+    if (field == Value) {
+        hasValue = true;
+        valueIsNull = false;
+        value = float(number);
+    }
+    field = Other;
+}
+
+/**
+ * @brief Oznacza bieżący pomiar jako brakujący.
+ */
+void SeriesStreamParser::nullValue() {
+    if (field == Value) {
+        hasValue = true;
+        valueIsNull = true;
+    }
+    field = Other;
+}
+
+/**
+ * @brief Porządkuje szereg po wczytaniu całej odpowiedzi (API zwraca dane od najnowszych).
+ */
+void SeriesStreamParser::documentFinished() {
+    series.sortByTime();
+}
+
+/**
+ * @brief Rozpoznaje klucz; pola klasy indeksu odczytywane są tylko z obiektu @c stIndexLevel.
+ * @param name Nazwa klucza.
+ *
+ * Obiekty indeksów poszczególnych parametrów (np. @c pm10IndexLevel) mają te same pola, więc
+ * o znaczeniu klucza decyduje klucz obiektu nadrzędnego.
+ */
+void IndexStreamParser::key(QByteArrayView name) {
+    field = Other;
+    if (depth() == 1) inStationLevel = name == "stIndexLevel";
+    else if (depth() == 2 && inStationLevel && name == "id") field = Id;
+    else if (depth() == 2 && inStationLevel && name == "indexLevelName") field = Name;
+}
+
+/**
+ * @brief Zapisuje nazwę klasy indeksu.
+ * @param text Wartość w UTF-8.
+ */
+void IndexStreamParser::stringValue(QByteArrayView text) {
+    if (field == Name) result.levelName = QString::fromUtf8(text);
+    field = Other;
+}
+
+/**
+ * @brief Zapisuje numer klasy indeksu.
+ * @param value Wartość.
+ */
+void IndexStreamParser::numberValue(double value) {
+    if (field == Id) result.level = int(value);
+    field = Other;
+}
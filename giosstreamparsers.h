@@ -0,0 +1,194 @@
+/**
+ * @file giosstreamparsers.h
+ * @brief Strumieniowe parsery odpowiedzi API GIOŚ (lista stacji, sensory, dane pomiarowe).
+ */
+
+#ifndef GIOSSTREAMPARSERS_H
+#define GIOSSTREAMPARSERS_H
+
+#include <QString>
+#include <QVector>
+#include "jsonstreamreader.h"
+#include "stationcatalog.h"
+#include "sensorseries.h"
+
+/**
+ * @class GiosStreamParser
+ * @brief Klasa bazowa parserów GIOŚ: łączy JsonStreamReader z odbiorcą zdarzeń.
+ *
+ * Fragmenty odpowiedzi podawane są metodą feed() (np. w QNetworkReply::readyRead), a wartości trafiają
+ * bezpośrednio do struktur docelowych - bez budowania QJsonDocument.
+ */
+class GiosStreamParser : protected JsonStreamHandler {
+public:
+    GiosStreamParser();
+    virtual ~GiosStreamParser() = default;
+
+    /**
+     * @brief Przetwarza kolejny fragment odpowiedzi.
+     * @param chunk Fragment danych.
+     * @return false, jeśli dane są nieprawidłowe.
+     */
+    bool feed(QByteArrayView chunk) { return reader.feed(chunk); }
+    /**
+     * @brief Kończy parsowanie i sprawdza kompletność odpowiedzi.
+     * @return true, jeśli odpowiedź była kompletna i poprawna.
+     */
+    bool finish();
+    QString errorString() const { return reader.errorString(); } ///< Opis błędu parsowania.
+
+protected:
+    /**
+     * @brief Wywoływana po poprawnym zakończeniu dokumentu.
+     */
+    virtual void documentFinished() {}
+    /**
+     * @brief Zamienia wartość tekstową lub liczbową współrzędnej na liczbę.
+     * @param text Tekst wartości.
+     * @return Liczba lub NaN.
+     */
+    static double parseDouble(QByteArrayView text);
+
+    int depth() const { return reader.depth(); } ///< Bieżąca głębokość zagnieżdżenia.
+
+private:
+    JsonStreamReader reader; ///< Tokenizer JSON.
+};
+
+/**
+ * @class CatalogStreamParser
+ * @brief Parser odpowiedzi @c station/findAll wypełniający StationCatalog.
+ */
+class CatalogStreamParser : public GiosStreamParser {
+public:
+    CatalogStreamParser();
+    /**
+     * @brief Zwraca zbudowany katalog (przenosząc go z parsera).
+     * @return Katalog stacji.
+     */
+    StationCatalog takeCatalog() { return std::move(catalog); }
+
+protected:
+    void startObject() override;
+    void endObject() override;
+    void key(QByteArrayView name) override;
+    void stringValue(QByteArrayView text) override;
+    void numberValue(double value) override;
+
+private:
+    /// Rozpoznawane pola obiektu stacji.
+    enum Field { Other, Id, StationName, GegrLat, GegrLon, City, CityName, Commune, CommuneName, ProvinceName };
+
+    StationCatalog catalog; ///< Budowany katalog.
+    Field field; ///< Ostatnio wczytany klucz.
+    bool inCity; ///< Czy parser jest w obiekcie @c city.
+    bool inCommune; ///< Czy parser jest w obiekcie @c commune.
+    int stationId; ///< ID bieżącej stacji.
+    QString stationName; ///< Nazwa bieżącej stacji.
+    QString cityName; ///< Miejscowość bieżącej stacji.
+    QString communeName; ///< Gmina bieżącej stacji.
+    QString provinceName; ///< Województwo bieżącej stacji.
+    double lat; ///< Szerokość geograficzna bieżącej stacji.
+    double lon; ///< Długość geograficzna bieżącej stacji.
+};
+
+/**
+ * @struct SensorDescriptor
+ * @brief Opis sensora stacji z odpowiedzi @c station/sensors.
+ */
+struct SensorDescriptor {
+    int id = 0; ///< Identyfikator sensora.
+    QString paramCode; ///< Kod parametru (np. PM10).
+    QString paramName; ///< Pełna nazwa parametru.
+};
+
+/**
+ * @class SensorListStreamParser
+ * @brief Parser odpowiedzi @c station/sensors/{id}.
+ */
+class SensorListStreamParser : public GiosStreamParser {
+public:
+    const QVector<SensorDescriptor> &sensors() const { return result; } ///< Wczytane sensory.
+
+protected:
+    void startObject() override;
+    void endObject() override;
+    void key(QByteArrayView name) override;
+    void stringValue(QByteArrayView text) override;
+    void numberValue(double value) override;
+
+private:
+    /// Rozpoznawane pola obiektu sensora.
+    enum Field { Other, Id, ParamCode, ParamName };
+
+    QVector<SensorDescriptor> result; ///< Wczytane sensory.
+    SensorDescriptor current; ///< Bieżący sensor.
+    Field field = Other; ///< Ostatnio wczytany klucz.
+};
+
+/**
+ * @class SeriesStreamParser
+ * @brief Parser odpowiedzi @c data/getData/{id} wypełniający SensorSeries.
+ */
+class SeriesStreamParser : public GiosStreamParser {
+public:
+    /**
+     * @brief Zwraca wczytany szereg (przenosząc go z parsera).
+     * @return Szereg czasowy posortowany rosnąco.
+     */
+    SensorSeries takeSeries() { return std::move(series); }
+
+protected:
+    void startObject() override;
+    void endObject() override;
+    void key(QByteArrayView name) override;
+    void stringValue(QByteArrayView text) override;
+    void numberValue(double number) override;
+    void nullValue() override;
+    void documentFinished() override;
+
+private:
+    /// Rozpoznawane pola obiektu pomiaru.
+    enum Field { Other, Date, Value };
+
+    SensorSeries series; ///< Budowany szereg.
+    Field field = Other; ///< Ostatnio wczytany klucz.
+    qint64 timestamp = 0; ///< Czas bieżącego pomiaru.
+    bool hasDate = false; ///< Czy bieżący pomiar ma poprawną datę.
+    bool hasValue = false; ///< Czy bieżący pomiar ma pole @c value.
+    bool valueIsNull = true; ///< Czy wartość bieżącego pomiaru to null.
+    float value = 0.0f; ///< Wartość bieżącego pomiaru.
+};
+
+/**
+ * @struct StationIndex
+ * @brief Indeks jakości powietrza stacji z odpowiedzi @c aqindex/getIndex.
+ */
+struct StationIndex {
+    int level = -1; ///< Klasa indeksu (0 - bardzo dobry ... 5 - bardzo zły, -1 - brak indeksu).
+    QString levelName; ///< Nazwa klasy indeksu.
+};
+
+/**
+ * @class IndexStreamParser
+ * @brief Parser odpowiedzi @c aqindex/getIndex/{id} (odczytuje ogólny indeks stacji, @c stIndexLevel).
+ */
+class IndexStreamParser : public GiosStreamParser {
+public:
+    const StationIndex &index() const { return result; } ///< Wczytany indeks.
+
+protected:
+    void key(QByteArrayView name) override;
+    void stringValue(QByteArrayView text) override;
+    void numberValue(double value) override;
+
+private:
+    /// Rozpoznawane pola obiektu klasy indeksu.
+    enum Field { Other, Id, Name };
+
+    StationIndex result; ///< Wczytany indeks.
+    bool inStationLevel = false; ///< Czy bieżący obiekt to @c stIndexLevel.
+    Field field = Other; ///< Ostatnio wczytany klucz.
+};
+
+#endif // GIOSSTREAMPARSERS_H
@@ -0,0 +1,289 @@
+/**
+ * @file giostime.cpp
+ * @brief Implementacja kodera/dekodera dat GIOŚ.
+ */
+
+#include "giostime.h"
+#include <limits>
+
+namespace {
+
+/**
+ * @struct DstCache
+ * @brief Zapamiętane granice roku i czasu letniego (w sekundach UTC) dla ostatnio użytego roku.
+ */
+struct DstCache {
+    qint64 yearStart = std::numeric_limits<qint64>::max(); ///< Początek roku (1 stycznia 00:00 UTC).
+    qint64 yearEnd = std::numeric_limits<qint64>::min(); ///< Początek następnego roku.
+    qint64 dstStart = 0; ///< Początek czasu letniego (ostatnia niedziela marca, 01:00 UTC).
+    qint64 dstEnd = 0; ///< Koniec czasu letniego (ostatnia niedziela października, 01:00 UTC).
+};
+
+/**
+ * @brief Zwraca liczbę dni od 1970-01-01 dla daty kalendarza gregoriańskiego.
+ * @param y Rok.
+ * @param m Miesiąc (1-12).
+ * @param d Dzień miesiąca.
+ * @return Liczba dni (ujemna dla dat przed 1970).
+ */
+qint64 daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const qint64 era = (y >= 0 ? y : y - 399) / 400;
+    const qint64 yoe = y - era * 400;
+    const qint64 doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const qint64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Zamienia liczbę dni od 1970-01-01 na datę kalendarzową.
+ * @param z Liczba dni.
+ * @param y Rok (wynik).
+ * @param m Miesiąc (wynik).
+ * @param d Dzień (wynik).
+ */
+void civilFromDays(qint64 z, int *y, int *m, int *d) {
+    z += 719468;
+    const qint64 era = (z >= 0 ? z : z - 146096) / 146097;
+    const qint64 doe = z - era * 146097;
+    const qint64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const qint64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const qint64 mp = (5 * doy + 2) / 153;
+    *d = int(doy - (153 * mp + 2) / 5 + 1);
+    *m = int(mp < 10 ? mp + 3 : mp - 9);
+    *y = int(yoe + era * 400 + (*m <= 2));
+}
+
+/**
+ * @brief Dzielenie z zaokrągleniem w dół (także dla liczb ujemnych).
+ */
+qint64 floorDiv(qint64 a, qint64 b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+/**
+ * @brief Zwraca dzień (liczony od epoki) ostatniej niedzieli miesiąca mającego 31 dni.
+ * @param y Rok.
+ * @param m Miesiąc (marzec lub październik).
+ * @return Liczba dni od 1970-01-01.
+ */
+qint64 lastSunday(int y, int m) {
+    const qint64 lastDay = daysFromCivil(y, m, 31);
+    const qint64 weekday = ((lastDay % 7) + 11) % 7; // 0 = niedziela (1970-01-01 to czwartek)
+    return lastDay - weekday;
+}
+
+/**
+ * @brief Sprawdza, czy w danej chwili obowiązuje czas letni w Polsce.
+ * @param utc Czas w sekundach od epoki Unix.
+ * @param cache Pamięć podręczna granic roku.
+ * @return true dla CEST (UTC+2), false dla CET (UTC+1).
+ */
+bool isDst(qint64 utc, DstCache *cache) {
+    if (utc < cache->yearStart || utc >= cache->yearEnd) {
+        int y, m, d;
+        civilFromDays(floorDiv(utc, 86400), &y, &m, &d);
+        cache->yearStart = daysFromCivil(y, 1, 1) * 86400;
+        cache->yearEnd = daysFromCivil(y + 1, 1, 1) * 86400;
+        cache->dstStart = lastSunday(y, 3) * 86400 + 3600;
+        cache->dstEnd = lastSunday(y, 10) * 86400 + 3600;
+    }
+    return utc >= cache->dstStart && utc < cache->dstEnd;
+}
+
+/**
+ * @brief Zamienia dwie lub cztery cyfry na liczbę.
+ * @param p Wskaźnik na pierwszą cyfrę.
+ * @param count Liczba cyfr.
+ * @param ok Ustawiane na false, jeśli napotkano znak niebędący cyfrą.
+ * @return Wartość liczbowa.
+ */
+template <typename Char>
+int readDigits(const Char *p, int count, bool *ok) {
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        const unsigned digit = unsigned(p[i]) - unsigned('0');
+        if (digit > 9) {
+            *ok = false;
+            return 0;
+        }
+        value = value * 10 + int(digit);
+    }
+    return value;
+}
+
+/**
+ * @brief Parsuje tekst daty (ASCII lub UTF-16) do czasu UTC.
+ * @param p Znaki daty (co najmniej TextLength).
+ * @param epochSecs Wynik.
+ * @param cache Pamięć podręczna granic roku.
+ * @return false dla niepoprawnej daty.
+ */
+template <typename Char>
+bool parseChars(const Char *p, qint64 *epochSecs, DstCache *cache) {
+    if (p[4] != '-' || p[7] != '-' || p[10] != ' ' || p[13] != ':' || p[16] != ':') {
+        return false;
+    }
+    bool ok = true;
+    const int year = readDigits(p, 4, &ok);
+    const int month = readDigits(p + 5, 2, &ok);
+    const int day = readDigits(p + 8, 2, &ok);
+    const int hour = readDigits(p + 11, 2, &ok);
+    const int minute = readDigits(p + 14, 2, &ok);
+    const int second = readDigits(p + 17, 2, &ok);
+    if (!ok || month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+    static const int monthDays[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > monthDays[month - 1] || (month == 2 && day == 29 && !leap)) {
+        return false;
+    }
+
+    const qint64 local = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    // Najpierw zakładamy czas letni (UTC+2); jeśli wynik nie wypada w okresie CEST, obowiązuje CET (UTC+1)
+    const qint64 summer = local - 7200;
+    *epochSecs = isDst(summer, cache) ? summer : local - 3600;
+    return true;
+}
+
+/**
+ * @brief Zapisuje liczbę jako stałą liczbę cyfr.
+ * @param out Bufor wyjściowy.
+ * @param value Wartość.
+ * @param count Liczba cyfr.
+ */
+void writeDigits(char *out, int value, int count) {
+    for (int i = count - 1; i >= 0; --i) {
+        out[i] = char('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/**
+ * @brief Formatuje czas UTC jako datę GIOŚ w czasie polskim.
+ * @param epochSecs Czas w sekundach od epoki Unix.
+ * @param out Bufor na TextLength znaków.
+ * @param cache Pamięć podręczna granic roku.
+ */
+void formatChars(qint64 epochSecs, char *out, DstCache *cache) {
+    const qint64 local = epochSecs + (isDst(epochSecs, cache) ? 7200 : 3600);
+    const qint64 days = floorDiv(local, 86400);
+    const int secs = int(local - days * 86400);
+    int y, m, d;
+    civilFromDays(days, &y, &m, &d);
+
+    writeDigits(out, y, 4);
+    out[4] = '-';
+    writeDigits(out + 5, m, 2);
+    out[7] = '-';
+    writeDigits(out + 8, d, 2);
+    out[10] = ' ';
+    writeDigits(out + 11, secs / 3600, 2);
+    out[13] = ':';
+    writeDigits(out + 14, (secs / 60) % 60, 2);
+    out[16] = ':';
+    writeDigits(out + 17, secs % 60, 2);
+}
+
+} // namespace
+
+namespace GiosTime {
+
+/**
+ * @brief Parsuje datę w formacie GIOŚ.
+ * @param text Tekst daty (dokładnie 19 znaków ASCII).
+ * @param epochSecs Wynik w sekundach od epoki Unix (UTC).
+ * @return false, jeśli tekst nie jest poprawną datą.
+ */
+bool parse(QByteArrayView text, qint64 *epochSecs) {
+    if (text.size() != TextLength) {
+        return false;
+    }
+    DstCache cache;
+    return parseChars(text.data(), epochSecs, &cache);
+}
+
+/**
+ * @brief Parsuje datę w formacie GIOŚ podaną jako QString.
+ * @param text Tekst daty.
+ * @param epochSecs Wynik w sekundach od epoki Unix (UTC).
+ * @return false, jeśli tekst nie jest poprawną datą.
+ */
+bool parse(QStringView text, qint64 *epochSecs) {
+    if (text.size() != TextLength) {
+        return false;
+    }
+    DstCache cache;
+    return parseChars(text.utf16(), epochSecs, &cache);
+}
+
+/**
+ * @brief Zapisuje datę w formacie GIOŚ do bufora.
+ * @param epochSecs Czas w sekundach od epoki Unix (UTC).
+ * @param out Bufor na co najmniej TextLength znaków (bez kończącego zera).
+ */
+void formatTo(qint64 epochSecs, char *out) {
+    DstCache cache;
+    formatChars(epochSecs, out, &cache);
+}
+
+/**
+ * @brief Zwraca datę w formacie GIOŚ.
+ * @param epochSecs Czas w sekundach od epoki Unix (UTC).
+ * @return Tekst daty w czasie Europe/Warsaw.
+ */
+QString format(qint64 epochSecs) {
+    char buffer[TextLength];
+    formatTo(epochSecs, buffer);
+    return QString::fromLatin1(buffer, TextLength);
+}
+
+/**
+ * @brief Parsuje całą kolumnę dat naraz.
+ * @param texts Teksty dat.
+ * @param epochSecs Wyniki (rozmiar zostanie dopasowany do texts).
+ * @param valid Opcjonalna maska poprawności poszczególnych dat.
+ * @return Liczba poprawnie sparsowanych dat.
+ */
+int parseColumn(const QStringList &texts, QVector<qint64> *epochSecs, QVector<bool> *valid) {
+    const int count = texts.size();
+    epochSecs->resize(count);
+    if (valid) {
+        valid->resize(count);
+    }
+
+    DstCache cache;
+    qint64 *out = epochSecs->data();
+    int parsed = 0;
+    for (int i = 0; i < count; ++i) {
+        const QString &text = texts[i];
+        bool ok = text.size() == TextLength && parseChars(text.utf16(), &out[i], &cache);
+        if (!ok) {
+            out[i] = 0;
+        }
+        if (valid) {
+            (*valid)[i] = ok;
+        }
+        parsed += ok;
+    }
+    return parsed;
+}
+
+/**
+ * @brief Formatuje całą kolumnę znaczników czasu naraz.
+ * @param epochSecs Czasy w sekundach od epoki Unix (UTC).
+ * @return Bufor z rekordami po TextLength znaków, jeden za drugim.
+ */
+QByteArray formatColumn(const QVector<qint64> &epochSecs) {
+    QByteArray buffer(epochSecs.size() * TextLength, Qt::Uninitialized);
+    char *out = buffer.data();
+    DstCache cache;
+    for (qint64 secs : epochSecs) {
+        formatChars(secs, out, &cache);
+        out += TextLength;
+    }
+    return buffer;
+}
+
+} // namespace GiosTime
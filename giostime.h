@@ -0,0 +1,87 @@
+/**
+ * @file giostime.h
+ * @brief Szybki koder/dekoder dat w stałym formacie GIOŚ @c "yyyy-MM-dd HH:mm:ss" (czas Europe/Warsaw).
+ */
+
+#ifndef GIOSTIME_H
+#define GIOSTIME_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+/**
+ * @namespace GiosTime
+ * @brief Konwersja dat GIOŚ bezpośrednio na sekundy od epoki Unix i z powrotem.
+ *
+ * Daty w API GIOŚ podawane są w czasie lokalnym Polski. Funkcje stosują strefę Europe/Warsaw
+ * (CET/CEST, zmiana czasu w ostatnią niedzielę marca i października o 01:00 UTC, zgodnie z zasadami UE)
+ * niezależnie od strefy systemu i bez kosztownego, zależnego od lokalizacji QDateTime::fromString().
+ *
+ * Niejednoznaczna godzina przy zmianie czasu w październiku (02:00-02:59 występuje dwukrotnie) jest
+ * interpretowana jako czas letni; nieistniejąca godzina w marcu jest przesuwana do przodu.
+ */
+namespace GiosTime {
+
+constexpr int TextLength = 19; ///< Długość tekstu daty @c "yyyy-MM-dd HH:mm:ss".
+
+/**
+ * @brief Parsuje datę w formacie GIOŚ.
+ * @param text Tekst daty (dokładnie 19 znaków ASCII).
+ * @param epochSecs Wynik w sekundach od epoki Unix (UTC).
+ * @return false, jeśli tekst nie jest poprawną datą.
+ */
+bool parse(QByteArrayView text, qint64 *epochSecs);
+/**
+ * @brief Parsuje datę w formacie GIOŚ podaną jako QString.
+ * @param text Tekst daty.
+ * @param epochSecs Wynik w sekundach od epoki Unix (UTC).
+ * @return false, jeśli tekst nie jest poprawną datą.
+ */
+bool parse(QStringView text, qint64 *epochSecs);
+
+/**
+ * @brief Zapisuje datę w formacie GIOŚ do bufora.
+ * @param epochSecs Czas w sekundach od epoki Unix (UTC).
+ * @param out Bufor na co najmniej TextLength znaków (bez kończącego zera).
+ */
+void formatTo(qint64 epochSecs, char *out);
+/**
+ * @brief Zwraca datę w formacie GIOŚ.
+ * @param epochSecs Czas w sekundach od epoki Unix (UTC).
+ * @return Tekst daty w czasie Europe/Warsaw.
+ */
+QString format(qint64 epochSecs);
+
+/**
+ * @brief Parsuje całą kolumnę dat naraz.
+ * @param texts Teksty dat.
+ * @param epochSecs Wyniki (rozmiar zostanie dopasowany do texts).
+ * @param valid Opcjonalna maska poprawności poszczególnych dat.
+ * @return Liczba poprawnie sparsowanych dat.
+ *
+ * Granice czasu letniego wyznaczane są raz na rok kalendarzowy, a nie dla każdej daty.
+ */
+int parseColumn(const QStringList &texts, QVector<qint64> *epochSecs, QVector<bool> *valid = nullptr);
+/**
+ * @brief Formatuje całą kolumnę znaczników czasu naraz.
+ * @param epochSecs Czasy w sekundach od epoki Unix (UTC).
+ * @return Bufor z rekordami po TextLength znaków, jeden za drugim.
+ */
+QByteArray formatColumn(const QVector<qint64> &epochSecs);
+
+/**
+ * @brief Zaokrągla czas w dół do pełnej godziny czasu polskiego.
+ * @param epochSecs Czas w sekundach od epoki Unix (UTC).
+ * @return Początek godziny (przesunięcia CET/CEST są pełnogodzinne).
+ */
+inline qint64 floorToHour(qint64 epochSecs) {
+    return epochSecs - (((epochSecs % 3600) + 3600) % 3600);
+}
+
+} // namespace GiosTime
+
+#endif // GIOSTIME_H
@@ -0,0 +1,270 @@
+/**
+ * @file haversinebatch.cpp
+ * @brief Implementacja wsadowego jądra haversine.
+ */
+
+#include "haversinebatch.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define HAVERSINE_SSE2
+#include <immintrin.h>
+#endif
+
+// AVX2 kompilowany jest osobno dla jednej funkcji i włączany po sprawdzeniu procesora (GCC/Clang),
+// a w MSVC tylko przy budowaniu z /arch:AVX2
+#if defined(HAVERSINE_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define HAVERSINE_AVX2
+#define HAVERSINE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#elif defined(HAVERSINE_SSE2) && defined(__AVX2__)
+#define HAVERSINE_AVX2
+#define HAVERSINE_AVX2_TARGET
+#endif
+
+namespace {
+
+constexpr double Pi = 3.14159265358979323846; ///< Liczba π.
+
+// Współczynniki szeregu sin x = x·(1 - x²/3! + x⁴/5! - ... - x¹⁴/15!), liczone metodą Hornera względem x²
+constexpr double S0 = 1.0;
+constexpr double S1 = -1.0 / 6.0;
+constexpr double S2 = 1.0 / 120.0;
+constexpr double S3 = -1.0 / 5040.0;
+constexpr double S4 = 1.0 / 362880.0;
+constexpr double S5 = -1.0 / 39916800.0;
+constexpr double S6 = 1.0 / 6227020800.0;
+constexpr double S7 = -1.0 / 1307674368000.0;
+
+/// Wariant jądra dostępny na danym procesorze.
+enum class Kernel { Scalar, Sse2, Avx2 };
+
+/**
+ * @brief Oblicza sin²(Δ/2) wielomianem.
+ * @param delta Różnica kątów (radiany, |Δ| ≤ 2π).
+ * @return sin²(Δ/2).
+ *
+ * sin² jest symetryczny względem π/2, więc argument |Δ/2| ∈ [0, π] sprowadzany jest do [0, π/2],
+ * gdzie szereg do x¹⁵ ma błąd poniżej (π/2)¹⁷/17! ≈ 6e-12.
+ */
+inline double sinSquaredHalf(double delta) {
+    double x = std::abs(delta * 0.5);
+    x = std::min(x, Pi - x);
+    const double x2 = x * x;
+    double p = S7;
+    p = p * x2 + S6;
+    p = p * x2 + S5;
+    p = p * x2 + S4;
+    p = p * x2 + S3;
+    p = p * x2 + S2;
+    p = p * x2 + S1;
+    p = p * x2 + S0;
+    const double s = x * p;
+    return s * s;
+}
+
+/**
+ * @brief Skalarna wersja jądra.
+ * @param latRad Szerokości stacji (radiany).
+ * @param lonRad Długości stacji (radiany).
+ * @param cosLat Cosinusy szerokości stacji.
+ * @param begin Pierwsza stacja do obliczenia.
+ * @param count Liczba stacji.
+ * @param queryLat Szerokość punktu zapytania (radiany).
+ * @param queryLon Długość punktu zapytania (radiany).
+ * @param queryCos Cosinus szerokości punktu zapytania.
+ * @param terms Wynik: wartości @c a.
+ */
+void computeScalar(const double *latRad, const double *lonRad, const double *cosLat, int begin, int count,
+                   double queryLat, double queryLon, double queryCos, double *terms) {
+    for (int i = begin; i < count; ++i) {
+        terms[i] = std::min(1.0, sinSquaredHalf(latRad[i] - queryLat)
+                                     + queryCos * cosLat[i] * sinSquaredHalf(lonRad[i] - queryLon));
+    }
+}
+
+#ifdef HAVERSINE_SSE2
+/**
+ * @brief Oblicza sin²(Δ/2) wielomianem dla dwóch różnic naraz (SSE2).
+ * @param delta Różnice kątów.
+ * @return sin²(Δ/2).
+ */
+inline __m128d sinSquaredHalfSse2(__m128d delta) {
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    __m128d x = _mm_andnot_pd(signMask, _mm_mul_pd(delta, _mm_set1_pd(0.5)));
+    x = _mm_min_pd(x, _mm_sub_pd(_mm_set1_pd(Pi), x));
+    const __m128d x2 = _mm_mul_pd(x, x);
+    __m128d p = _mm_set1_pd(S7);
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S6));
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S5));
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S4));
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S3));
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S2));
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S1));
+    p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(S0));
+    const __m128d s = _mm_mul_pd(x, p);
+    return _mm_mul_pd(s, s);
+}
+
+/**
+ * @brief Wersja jądra SSE2 (po dwie stacje, reszta skalarnie).
+ * @param latRad Szerokości stacji (radiany).
+ * @param lonRad Długości stacji (radiany).
+ * @param cosLat Cosinusy szerokości stacji.
+ * @param count Liczba stacji.
+ * @param queryLat Szerokość punktu zapytania (radiany).
+ * @param queryLon Długość punktu zapytania (radiany).
+ * @param queryCos Cosinus szerokości punktu zapytania.
+ * @param terms Wynik: wartości @c a.
+ */
+void computeSse2(const double *latRad, const double *lonRad, const double *cosLat, int count,
+                 double queryLat, double queryLon, double queryCos, double *terms) {
+    const __m128d lat = _mm_set1_pd(queryLat);
+    const __m128d lon = _mm_set1_pd(queryLon);
+    const __m128d cosQuery = _mm_set1_pd(queryCos);
+    const __m128d one = _mm_set1_pd(1.0);
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d sinLat = sinSquaredHalfSse2(_mm_sub_pd(_mm_loadu_pd(latRad + i), lat));
+        const __m128d sinLon = sinSquaredHalfSse2(_mm_sub_pd(_mm_loadu_pd(lonRad + i), lon));
+        const __m128d weight = _mm_mul_pd(cosQuery, _mm_loadu_pd(cosLat + i));
+        _mm_storeu_pd(terms + i, _mm_min_pd(one, _mm_add_pd(sinLat, _mm_mul_pd(weight, sinLon))));
+    }
+    computeScalar(latRad, lonRad, cosLat, i, count, queryLat, queryLon, queryCos, terms);
+}
+#endif
+
+#ifdef HAVERSINE_AVX2
+/**
+ * @brief Oblicza sin²(Δ/2) wielomianem dla czterech różnic naraz (AVX2 + FMA).
+ * @param delta Różnice kątów.
+ * @return sin²(Δ/2).
+ */
+HAVERSINE_AVX2_TARGET inline __m256d sinSquaredHalfAvx2(__m256d delta) {
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d x = _mm256_andnot_pd(signMask, _mm256_mul_pd(delta, _mm256_set1_pd(0.5)));
+    x = _mm256_min_pd(x, _mm256_sub_pd(_mm256_set1_pd(Pi), x));
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(S7);
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S6));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S5));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S4));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S3));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S2));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S1));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(S0));
+    const __m256d s = _mm256_mul_pd(x, p);
+    return _mm256_mul_pd(s, s);
+}
+
+/**
+ * @brief Wersja jądra AVX2 (po cztery stacje, reszta skalarnie).
+ * @param latRad Szerokości stacji (radiany).
+ * @param lonRad Długości stacji (radiany).
+ * @param cosLat Cosinusy szerokości stacji.
+ * @param count Liczba stacji.
+ * @param queryLat Szerokość punktu zapytania (radiany).
+ * @param queryLon Długość punktu zapytania (radiany).
+ * @param queryCos Cosinus szerokości punktu zapytania.
+ * @param terms Wynik: wartości @c a.
+ */
+HAVERSINE_AVX2_TARGET void computeAvx2(const double *latRad, const double *lonRad, const double *cosLat, int count,
+                                       double queryLat, double queryLon, double queryCos, double *terms) {
+    const __m256d lat = _mm256_set1_pd(queryLat);
+    const __m256d lon = _mm256_set1_pd(queryLon);
+    const __m256d cosQuery = _mm256_set1_pd(queryCos);
+    const __m256d one = _mm256_set1_pd(1.0);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d sinLat = sinSquaredHalfAvx2(_mm256_sub_pd(_mm256_loadu_pd(latRad + i), lat));
+        const __m256d sinLon = sinSquaredHalfAvx2(_mm256_sub_pd(_mm256_loadu_pd(lonRad + i), lon));
+        const __m256d weight = _mm256_mul_pd(cosQuery, _mm256_loadu_pd(cosLat + i));
+        _mm256_storeu_pd(terms + i, _mm256_min_pd(one, _mm256_fmadd_pd(weight, sinLon, sinLat)));
+    }
+    computeScalar(latRad, lonRad, cosLat, i, count, queryLat, queryLon, queryCos, terms);
+}
+#endif
+
+/**
+ * @brief Wybiera najszybszy wariant jądra dostępny na procesorze.
+ * @return Wariant jądra.
+ */
+Kernel detectKernel() {
+#if defined(HAVERSINE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Kernel::Avx2;
+    }
+#elif defined(HAVERSINE_AVX2)
+    return Kernel::Avx2;
+#endif
+#ifdef HAVERSINE_SSE2
+    return Kernel::Sse2;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+/**
+ * @brief Zwraca wariant jądra wybrany przy pierwszym użyciu.
+ * @return Wariant jądra.
+ */
+Kernel kernel() {
+    static const Kernel selected = detectKernel();
+    return selected;
+}
+
+} // namespace
+
+namespace HaversineBatch {
+
+/**
+ * @brief Oblicza składnik @c a wzoru haversine dla tablicy stacji.
+ * @param latRad Szerokości stacji (radiany).
+ * @param lonRad Długości stacji (radiany).
+ * @param cosLat Cosinusy szerokości stacji.
+ * @param count Liczba stacji.
+ * @param queryLatRad Szerokość punktu zapytania (radiany).
+ * @param queryLonRad Długość punktu zapytania (radiany).
+ * @param terms Wynik: @p count wartości @c a z przedziału [0, 1].
+ */
+void computeTerms(const double *latRad, const double *lonRad, const double *cosLat, int count,
+                  double queryLatRad, double queryLonRad, double *terms) {
+    const double queryCos = std::cos(queryLatRad);
+    switch (kernel()) {
+#ifdef HAVERSINE_AVX2
+    case Kernel::Avx2:
+        computeAvx2(latRad, lonRad, cosLat, count, queryLatRad, queryLonRad, queryCos, terms);
+        return;
+#endif
+#ifdef HAVERSINE_SSE2
+    case Kernel::Sse2:
+        computeSse2(latRad, lonRad, cosLat, count, queryLatRad, queryLonRad, queryCos, terms);
+        return;
+#endif
+    default:
+        computeScalar(latRad, lonRad, cosLat, 0, count, queryLatRad, queryLonRad, queryCos, terms);
+        return;
+    }
+}
+
+/**
+ * @brief Zamienia składnik @c a na odległość.
+ * @param term Wartość @c a.
+ * @return Odległość w kilometrach.
+ */
+double distanceKm(double term) {
+    return 2.0 * EarthRadiusKm * std::asin(std::sqrt(std::min(1.0, std::max(0.0, term))));
+}
+
+/**
+ * @brief Zwraca składnik @c a odpowiadający odległości (próg filtrowania po promieniu).
+ * @param distanceKm Odległość w kilometrach.
+ * @return Wartość @c a (1 dla odległości obejmujących całą kulę).
+ */
+double termForDistance(double distanceKm) {
+    const double halfAngle = std::min(Pi / 2, std::max(0.0, distanceKm) / (2.0 * EarthRadiusKm));
+    const double s = std::sin(halfAngle);
+    return s * s;
+}
+
+} // namespace HaversineBatch
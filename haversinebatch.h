@@ -0,0 +1,56 @@
+/**
+ * @file haversinebatch.h
+ * @brief Wsadowe obliczanie odległości wzorem haversine dla tablic współrzędnych (SSE2/AVX2).
+ */
+
+#ifndef HAVERSINEBATCH_H
+#define HAVERSINEBATCH_H
+
+/**
+ * @namespace HaversineBatch
+ * @brief Jądro obliczające składnik @c a wzoru haversine dla wielu stacji naraz.
+ *
+ * Dane wejściowe to tablice struktury tablic (szerokości i długości w radianach oraz przeliczone cosinusy
+ * szerokości), a wynik to a = sin²(Δφ/2) + cos φ1 cos φ2 sin²(Δλ/2) dla każdej stacji. Wartość @c a jest
+ * monotoniczna względem odległości, więc filtrowanie po promieniu i porządkowanie według odległości nie
+ * wymaga asin(); odległość w kilometrach liczy distanceKm() tylko dla potrzebnych stacji.
+ *
+ * Sinus liczony jest wielomianem (szereg Taylora do x¹⁵ po sprowadzeniu argumentu do [0, π/2]),
+ * którego błąd bezwzględny nie przekracza 1e-11; względny błąd odległości jest rzędu 1e-8
+ * (poniżej 0,2 m nawet dla punktów leżących po przeciwnych stronach Ziemi).
+ * Dzięki temu te same obliczenia wykonują się w wektorach AVX2 (4 stacje, FMA), SSE2 (2 stacje)
+ * lub skalarnie, a wybór następuje przy pierwszym wywołaniu na podstawie możliwości procesora.
+ */
+namespace HaversineBatch {
+
+constexpr double EarthRadiusKm = 6371.0; ///< Średni promień Ziemi.
+
+/**
+ * @brief Oblicza składnik @c a wzoru haversine dla tablicy stacji.
+ * @param latRad Szerokości stacji (radiany).
+ * @param lonRad Długości stacji (radiany).
+ * @param cosLat Cosinusy szerokości stacji.
+ * @param count Liczba stacji.
+ * @param queryLatRad Szerokość punktu zapytania (radiany).
+ * @param queryLonRad Długość punktu zapytania (radiany).
+ * @param terms Wynik: @p count wartości @c a z przedziału [0, 1].
+ */
+void computeTerms(const double *latRad, const double *lonRad, const double *cosLat, int count,
+                  double queryLatRad, double queryLonRad, double *terms);
+
+/**
+ * @brief Zamienia składnik @c a na odległość.
+ * @param term Wartość @c a.
+ * @return Odległość w kilometrach.
+ */
+double distanceKm(double term);
+/**
+ * @brief Zwraca składnik @c a odpowiadający odległości (próg filtrowania po promieniu).
+ * @param distanceKm Odległość w kilometrach.
+ * @return Wartość @c a.
+ */
+double termForDistance(double distanceKm);
+
+} // namespace HaversineBatch
+
+#endif // HAVERSINEBATCH_H
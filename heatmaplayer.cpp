@@ -0,0 +1,409 @@
+/**
+ * @file heatmaplayer.cpp
+ * @brief Implementacja warstwy mapy ciepła.
+ */
+
+#include "heatmaplayer.h"
+#include "airqualityindex.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QPainter>
+#include <QtConcurrent/QtConcurrentMap>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+namespace {
+
+constexpr int PaletteSize = 256; ///< Liczba kolorów palety poziomów indeksu.
+
+/// Zlecenie obliczenia rastra (współdzielone przez kafelki liczone w puli wątków).
+struct HeatmapJob {
+    quint64 generation = 0; ///< Numer zlecenia.
+    QString key; ///< Klucz pamięci podręcznej.
+    QString paramCode; ///< Kod parametru.
+    QVector<QPointF> points; ///< Położenia stacji w pikselach rastra.
+    QVector<float> values; ///< Stężenia stacji.
+    int gridColumns = 0; ///< Liczba kolumn siatki stacji (komórka TileSize × TileSize pikseli).
+    int gridRows = 0; ///< Liczba wierszy siatki stacji.
+    QVector<int> cellStart; ///< Początek stacji komórki w cellStations (gridRows × gridColumns + 1 wartości).
+    QVector<int> cellStations; ///< Stacje posortowane kubełkowo według komórek siatki.
+    QVector<QRgb> palette; ///< Kolory poziomów indeksu (PaletteSize wartości).
+    QImage image; ///< Wynikowy raster (Format_ARGB32_Premultiplied).
+    uchar *pixels = nullptr; ///< Dane rastra (pobrane w wątku GUI, bez odłączania w wątkach roboczych).
+    qsizetype stride = 0; ///< Długość wiersza rastra w bajtach.
+    QImage mask; ///< Maska kształtu mapy (Format_Alpha8, pusta - bez maski).
+    QVector<QRect> tiles; ///< Kafelki rastra.
+    QElapsedTimer timer; ///< Czas od zlecenia.
+};
+
+/**
+ * @brief Zwraca kolumnę siatki stacji dla współrzędnej x (ograniczoną do siatki).
+ * @param job Zlecenie.
+ * @param x Współrzędna w pikselach rastra.
+ * @return Kolumna siatki.
+ */
+int gridColumn(const HeatmapJob &job, double x) {
+    return qBound(0, int(std::floor(x / HeatmapLayer::TileSize)), job.gridColumns - 1);
+}
+
+/**
+ * @brief Zwraca wiersz siatki stacji dla współrzędnej y (ograniczony do siatki).
+ * @param job Zlecenie.
+ * @param y Współrzędna w pikselach rastra.
+ * @return Wiersz siatki.
+ */
+int gridRow(const HeatmapJob &job, double y) {
+    return qBound(0, int(std::floor(y / HeatmapLayer::TileSize)), job.gridRows - 1);
+}
+
+/**
+ * @brief Rozmieszcza stacje zlecenia w siatce komórek o boku kafelka.
+ * @param job Zlecenie (z wypełnionymi points).
+ * @param rasterSize Rozmiar rastra.
+ *
+ * Stacje są sortowane kubełkowo w dwóch przebiegach (zliczanie, rozmieszczenie), jak w StationSpatialIndex.
+ * Stacje poza rastrem trafiają do skrajnych komórek.
+ */
+void buildGrid(HeatmapJob &job, const QSize &rasterSize) {
+    constexpr int size = HeatmapLayer::TileSize;
+    job.gridColumns = (rasterSize.width() + size - 1) / size;
+    job.gridRows = (rasterSize.height() + size - 1) / size;
+    const int count = job.points.size();
+    QVector<int> cellOf(count);
+    job.cellStart.fill(0, job.gridRows * job.gridColumns + 1);
+    for (int i = 0; i < count; ++i) {
+        cellOf[i] = gridRow(job, job.points[i].y()) * job.gridColumns + gridColumn(job, job.points[i].x());
+        job.cellStart[cellOf[i] + 1]++;
+    }
+    for (int cell = 0; cell < job.gridRows * job.gridColumns; ++cell) {
+        job.cellStart[cell + 1] += job.cellStart[cell];
+    }
+    job.cellStations.resize(count);
+    QVector<int> fill(job.cellStart.begin(), job.cellStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        job.cellStations[fill[cellOf[i]]++] = i;
+    }
+}
+
+/**
+ * @brief Wybiera stacje, wśród których są Neighbours najbliższe stacje każdego piksela kafelka.
+ * @param job Zlecenie.
+ * @param tile Kafelek (współrzędne pikseli rastra).
+ * @return Indeksy stacji kandydujących.
+ *
+ * Wokół komórek kafelka dokładane są kolejne pierścienie komórek, aż znajdzie się Neighbours stacji.
+ * Największa odległość R k-tej z nich od kafelka ogranicza odległość k-tej najbliższej stacji
+ * od dowolnego piksela kafelka, więc kandydatami są wszystkie stacje bliższe kafelkowi niż R.
+ */
+QVector<int> tileCandidates(const HeatmapJob &job, const QRect &tile) {
+    constexpr int k = HeatmapLayer::Neighbours;
+    const int count = job.points.size();
+    QVector<int> result;
+    if (count <= k) {
+        result.resize(count);
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+    const QRectF area(tile);
+    auto farthest = [&area](const QPointF &point) {
+        /**
+         * @brief Lambda zwracająca kwadrat największej odległości punktu od prostokąta kafelka.
+         * @param point Punkt.
+         * @return Kwadrat odległości.
+         */
+        const double dx = qMax(point.x() - area.left(), area.right() - point.x());
+        const double dy = qMax(point.y() - area.top(), area.bottom() - point.y());
+        return dx * dx + dy * dy;
+    };
+    auto nearest = [&area](const QPointF &point) {
+        /**
+         * @brief Lambda zwracająca kwadrat najmniejszej odległości punktu od prostokąta kafelka.
+         * @param point Punkt.
+         * @return Kwadrat odległości (0 wewnątrz prostokąta).
+         */
+        const double dx = qMax(0.0, qMax(area.left() - point.x(), point.x() - area.right()));
+        const double dy = qMax(0.0, qMax(area.top() - point.y(), point.y() - area.bottom()));
+        return dx * dx + dy * dy;
+    };
+    auto forCells = [&job](int firstColumn, int lastColumn, int firstRow, int lastRow, auto visit) {
+        /**
+         * @brief Lambda przeglądająca stacje w prostokącie komórek siatki.
+         * @param firstColumn Pierwsza kolumna.
+         * @param lastColumn Ostatnia kolumna.
+         * @param firstRow Pierwszy wiersz.
+         * @param lastRow Ostatni wiersz.
+         * @param visit Funkcja wywoływana dla indeksu każdej stacji.
+         */
+        for (int row = qMax(0, firstRow); row <= qMin(job.gridRows - 1, lastRow); ++row) {
+            for (int column = qMax(0, firstColumn); column <= qMin(job.gridColumns - 1, lastColumn); ++column) {
+                const int cell = row * job.gridColumns + column;
+                for (int slot = job.cellStart[cell]; slot < job.cellStart[cell + 1]; ++slot) {
+                    visit(job.cellStations[slot]);
+                }
+            }
+        }
+    };
+
+    const int firstColumn = gridColumn(job, area.left());
+    const int lastColumn = gridColumn(job, area.right() - 1);
+    const int firstRow = gridRow(job, area.top());
+    const int lastRow = gridRow(job, area.bottom() - 1);
+    QVector<double> distances;
+    for (int ring = 0; distances.size() < k; ++ring) {
+        distances.clear();
+        forCells(firstColumn - ring, lastColumn + ring, firstRow - ring, lastRow + ring, [&](int i) {
+            /**
+             * @brief Lambda zapamiętująca największą odległość stacji od kafelka.
+             * @param i Indeks stacji.
+             */
+            distances.append(farthest(job.points[i]));
+        });
+    }
+    std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+    const double radiusSquared = distances[k - 1];
+    const double radius = std::sqrt(radiusSquared);
+
+    forCells(gridColumn(job, area.left() - radius), gridColumn(job, area.right() + radius),
+             gridRow(job, area.top() - radius), gridRow(job, area.bottom() + radius), [&](int i) {
+        /**
+         * @brief Lambda dopisująca stację, jeśli może być jedną z najbliższych dla piksela kafelka.
+         * @param i Indeks stacji.
+         */
+        if (nearest(job.points[i]) <= radiusSquared) {
+            result.append(i);
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Oblicza piksele jednego kafelka rastra.
+ * @param job Zlecenie.
+ * @param tile Kafelek (współrzędne pikseli rastra).
+ *
+ * Dla każdego piksela wybierane są Neighbours najbliższe stacje spośród kandydatów kafelka
+ * (sortowanie przez wstawianie w małej tablicy), a stężenie jest ich średnią ważoną 1/d².
+ * Piksel pokrywający się ze stacją przyjmuje jej wartość.
+ */
+void renderTile(const HeatmapJob &job, const QRect &tile) {
+    constexpr int k = HeatmapLayer::Neighbours;
+    const QVector<int> candidates = tileCandidates(job, tile);
+    const int count = candidates.size();
+    for (int y = tile.top(); y <= tile.bottom(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(job.pixels + y * job.stride);
+        const uchar *maskLine = job.mask.isNull() ? nullptr : job.mask.constScanLine(y);
+        const double py = y + 0.5;
+        for (int x = tile.left(); x <= tile.right(); ++x) {
+            const int coverage = maskLine ? maskLine[x] : 255;
+            if (coverage == 0 || count == 0) {
+                line[x] = 0;
+                continue;
+            }
+            const double px = x + 0.5;
+            double nearestDistance[k];
+            int nearest[k];
+            int found = 0;
+            for (int c = 0; c < count; ++c) {
+                const int i = candidates[c];
+                const double dx = job.points[i].x() - px;
+                const double dy = job.points[i].y() - py;
+                const double distance = dx * dx + dy * dy;
+                if (found == k && distance >= nearestDistance[k - 1]) {
+                    continue;
+                }
+                int slot = found < k ? found++ : k - 1;
+                while (slot > 0 && nearestDistance[slot - 1] > distance) {
+                    nearestDistance[slot] = nearestDistance[slot - 1];
+                    nearest[slot] = nearest[slot - 1];
+                    --slot;
+                }
+                nearestDistance[slot] = distance;
+                nearest[slot] = i;
+            }
+
+            double value;
+            if (nearestDistance[0] < 1e-6) {
+                value = job.values[nearest[0]];
+            } else {
+                double weightedSum = 0.0;
+                double weightSum = 0.0;
+                for (int n = 0; n < found; ++n) {
+                    const double weight = 1.0 / nearestDistance[n];
+                    weightedSum += weight * job.values[nearest[n]];
+                    weightSum += weight;
+                }
+                value = weightedSum / weightSum;
+            }
+            const double level = AirQualityIndex::level(job.paramCode, value);
+            const int index = qBound(0, int(level / AirQualityIndex::BandCount * (PaletteSize - 1) + 0.5), PaletteSize - 1);
+            const QRgb color = job.palette[index];
+            line[x] = qPremultiply(qRgba(qRed(color), qGreen(color), qBlue(color), HeatmapLayer::Opacity * coverage / 255));
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Tworzy pustą warstwę.
+ * @param mapRect Prostokąt obrazu mapy we współrzędnych sceny.
+ * @param parent Element nadrzędny.
+ */
+HeatmapLayer::HeatmapLayer(const QRectF &mapRect, QGraphicsItem *parent)
+    : QGraphicsObject(parent), rect(mapRect),
+      rasterSize(RasterWidth, qMax(1, qRound(RasterWidth * mapRect.height() / qMax(1.0, mapRect.width())))) {
+    cache.setMaxCost(32 * 1024); // 32 MB
+}
+
+/**
+ * @brief Przerywa trwające obliczenia i czeka na zakończenie kafelków w toku.
+ */
+HeatmapLayer::~HeatmapLayer() {
+    running.cancel();
+    running.waitForFinished();
+}
+
+/**
+ * @brief Ustawia maskę kształtu mapy (piksele poza krajem pozostają przezroczyste).
+ * @param mask Obraz z kanałem alfa (dowolny rozmiar; pusty - bez maski).
+ */
+void HeatmapLayer::setMask(const QImage &mask) {
+    this->mask = mask.isNull() ? QImage()
+                               : mask.scaled(rasterSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_Alpha8);
+    cache.clear();
+    currentKey.clear();
+}
+
+/**
+ * @brief Pokazuje mapę parametru dla godziny, w razie potrzeby zlecając jej obliczenie.
+ * @param paramCode Kod parametru.
+ * @param hour Początek godziny (sekundy od epoki).
+ * @param samples Pomiary stacji dla tej godziny.
+ *
+ * Do czasu zakończenia obliczeń pokazywana jest poprzednia mapa. Nowe zlecenie przerywa poprzednie
+ * (kafelki jeszcze nierozpoczęte są pomijane).
+ */
+void HeatmapLayer::showHeatmap(const QString &paramCode, qint64 hour, const QVector<HeatmapSample> &samples) {
+    const QString key = cacheKey(paramCode, hour);
+    if (key == currentKey) {
+        return; // Ta sama mapa jest już pokazywana lub liczona
+    }
+    currentKey = key;
+    running.cancel();
+    ++generation;
+    if (const QImage *cached = cache.object(key)) {
+        image = *cached;
+        update();
+        emit heatmapShown(paramCode, hour);
+        return;
+    }
+
+    auto job = std::make_shared<HeatmapJob>();
+    job->generation = generation;
+    job->key = key;
+    job->paramCode = paramCode;
+    for (const HeatmapSample &sample : samples) {
+        if (!qIsNaN(sample.value)) {
+            job->points.append(QPointF(sample.position.x() * rasterSize.width(), sample.position.y() * rasterSize.height()));
+            job->values.append(sample.value);
+        }
+    }
+    buildGrid(*job, rasterSize);
+    job->palette.resize(PaletteSize);
+    for (int i = 0; i < PaletteSize; ++i) {
+        job->palette[i] = AirQualityIndex::levelColor(double(i) / (PaletteSize - 1) * AirQualityIndex::BandCount).rgb();
+    }
+    job->image = QImage(rasterSize, QImage::Format_ARGB32_Premultiplied);
+    job->pixels = job->image.bits();
+    job->stride = job->image.bytesPerLine();
+    job->mask = mask;
+    for (int y = 0; y < rasterSize.height(); y += TileSize) {
+        for (int x = 0; x < rasterSize.width(); x += TileSize) {
+            job->tiles.append(QRect(x, y, TileSize, TileSize).intersected(QRect(QPoint(0, 0), rasterSize)));
+        }
+    }
+    job->timer.start();
+
+    running = QtConcurrent::map(job->tiles, [job](const QRect &tile) {
+        /**
+         * @brief Lambda obliczająca kafelek w wątku puli.
+         * @param tile Kafelek rastra.
+         */
+        renderTile(*job, tile);
+    });
+    auto *watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, job, hour]() {
+        /**
+         * @brief Lambda pokazująca gotowy raster (o ile zlecenie jest nadal aktualne).
+         */
+        watcher->deleteLater();
+        if (watcher->isCanceled() || job->generation != generation) {
+            return;
+        }
+        cache.insert(job->key, new QImage(job->image), qMax<qsizetype>(1, job->image.sizeInBytes() / 1024));
+        image = job->image;
+        update();
+        qDebug() << "Mapa ciepła" << job->paramCode << "dla" << job->values.size() << "stacji obliczona w"
+                 << job->timer.elapsed() << "ms";
+        emit heatmapShown(job->paramCode, hour);
+    });
+    watcher->setFuture(running);
+}
+
+/**
+ * @brief Usuwa z pamięci podręcznej mapy parametru (np. po nadejściu nowych pomiarów).
+ * @param paramCode Kod parametru.
+ *
+ * Pokazywana mapa pozostaje widoczna do czasu obliczenia nowej.
+ */
+void HeatmapLayer::invalidate(const QString &paramCode) {
+    const QString prefix = paramCode + '@';
+    const QList<QString> keys = cache.keys();
+    for (const QString &key : keys) {
+        if (key.startsWith(prefix)) {
+            cache.remove(key);
+        }
+    }
+    if (currentKey.startsWith(prefix)) {
+        currentKey.clear();
+    }
+}
+
+/**
+ * @brief Ukrywa mapę i przerywa trwające obliczenia.
+ */
+void HeatmapLayer::clearHeatmap() {
+    running.cancel();
+    ++generation;
+    currentKey.clear();
+    image = QImage();
+    update();
+}
+
+/**
+ * @brief Rysuje raster rozciągnięty na prostokąt mapy.
+ * @param painter Obiekt rysujący.
+ * @param option Opcje stylu.
+ * @param widget Widżet, na którym odbywa się rysowanie.
+ */
+void HeatmapLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    if (image.isNull()) {
+        return;
+    }
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawImage(rect, image);
+}
+
+/**
+ * @brief Zwraca klucz pamięci podręcznej.
+ * @param paramCode Kod parametru.
+ * @param hour Początek godziny.
+ * @return Klucz "parametr@godzina".
+ */
+QString HeatmapLayer::cacheKey(const QString &paramCode, qint64 hour) {
+    return paramCode + '@' + QString::number(hour);
+}
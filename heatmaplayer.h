@@ -0,0 +1,105 @@
+/**
+ * @file heatmaplayer.h
+ * @brief Warstwa mapy z interpolowanym rozkładem stężenia parametru (mapa ciepła).
+ */
+
+#ifndef HEATMAPLAYER_H
+#define HEATMAPLAYER_H
+
+#include <QCache>
+#include <QFuture>
+#include <QGraphicsObject>
+#include <QImage>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+/**
+ * @struct HeatmapSample
+ * @brief Pomiar stacji użyty do interpolacji.
+ */
+struct HeatmapSample {
+    QPointF position; ///< Położenie stacji w jednostkowym kwadracie obrazu mapy.
+    float value; ///< Stężenie (µg/m³).
+};
+
+/**
+ * @class HeatmapLayer
+ * @brief Rastrowa mapa stężenia parametru rysowana pod znacznikami stacji.
+ *
+ * Wartość w każdym pikselu rastra to średnia stężeń Neighbours najbliższych stacji ważona odwrotnością
+ * kwadratu odległości (IDW), zamieniona na kolor klasy indeksu jakości powietrza. Raster liczony jest
+ * w kafelkach TileSize × TileSize równolegle w globalnej puli wątków, bez blokowania wątku GUI.
+ * Gotowe rastry przechowywane są w pamięci podręcznej według pary (parametr, godzina), więc powrót
+ * do wcześniej oglądanej godziny nie wymaga ponownych obliczeń.
+ */
+class HeatmapLayer : public QGraphicsObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Tworzy pustą warstwę.
+     * @param mapRect Prostokąt obrazu mapy we współrzędnych sceny.
+     * @param parent Element nadrzędny.
+     */
+    explicit HeatmapLayer(const QRectF &mapRect, QGraphicsItem *parent = nullptr);
+    ~HeatmapLayer() override;
+
+    /**
+     * @brief Ustawia maskę kształtu mapy (piksele poza krajem pozostają przezroczyste).
+     * @param mask Obraz z kanałem alfa (dowolny rozmiar; pusty - bez maski).
+     */
+    void setMask(const QImage &mask);
+    /**
+     * @brief Pokazuje mapę parametru dla godziny, w razie potrzeby zlecając jej obliczenie.
+     * @param paramCode Kod parametru.
+     * @param hour Początek godziny (sekundy od epoki).
+     * @param samples Pomiary stacji dla tej godziny.
+     */
+    void showHeatmap(const QString &paramCode, qint64 hour, const QVector<HeatmapSample> &samples);
+    /**
+     * @brief Usuwa z pamięci podręcznej mapy parametru (np. po nadejściu nowych pomiarów).
+     * @param paramCode Kod parametru.
+     */
+    void invalidate(const QString &paramCode);
+    /**
+     * @brief Ukrywa mapę i przerywa trwające obliczenia.
+     */
+    void clearHeatmap();
+
+    QRectF boundingRect() const override { return rect; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    static constexpr int RasterWidth = 320; ///< Szerokość rastra w pikselach (wysokość wg proporcji mapy).
+    static constexpr int TileSize = 32; ///< Bok kafelka obliczeń.
+    static constexpr int Neighbours = 6; ///< Liczba najbliższych stacji w interpolacji.
+    static constexpr int Opacity = 150; ///< Krycie mapy (0-255).
+
+signals:
+    /**
+     * @brief Sygnał emitowany po pokazaniu mapy.
+     * @param paramCode Kod parametru.
+     * @param hour Początek godziny (sekundy od epoki).
+     */
+    void heatmapShown(const QString &paramCode, qint64 hour);
+
+private:
+    /**
+     * @brief Zwraca klucz pamięci podręcznej.
+     * @param paramCode Kod parametru.
+     * @param hour Początek godziny.
+     * @return Klucz "parametr@godzina".
+     */
+    static QString cacheKey(const QString &paramCode, qint64 hour);
+
+    QRectF rect; ///< Prostokąt obrazu mapy.
+    QSize rasterSize; ///< Rozmiar rastra.
+    QImage mask; ///< Maska kształtu mapy w rozmiarze rastra (Format_Alpha8, pusta - bez maski).
+    QImage image; ///< Pokazywany raster.
+    QString currentKey; ///< Klucz pokazywanego lub liczonego rastra.
+    QCache<QString, QImage> cache; ///< Gotowe rastry (koszt w kilobajtach).
+    QFuture<void> running; ///< Trwające obliczenia.
+    quint64 generation = 0; ///< Numer ostatniego zlecenia (starsze wyniki są odrzucane).
+};
+
+#endif // HEATMAPLAYER_H
@@ -0,0 +1,452 @@
+/**
+ * @file jsonstreamreader.cpp
+ * @brief Implementacja klasy JsonStreamReader aplikacji GIOSrevamp.
+ */
+
+#include "jsonstreamreader.h"
+
+/**
+ * @brief Konstruktor klasy JsonStreamReader.
+ * @param handler Odbiorca zdarzeń (nie jest przejmowany na własność).
+ */
+JsonStreamReader::JsonStreamReader(JsonStreamHandler *handler)
+    : handler(handler) {
+    reset();
+}
+
+/**
+ * @brief Przywraca parser do stanu początkowego.
+ */
+void JsonStreamReader::reset() {
+    stack.clear();
+    rootExpect = Expect::Value;
+    lexeme = Lexeme::None;
+    token.clear();
+    stringIsKey = false;
+    stringHasEscapes = false;
+    escapeNext = false;
+    failed = false;
+    errorMessage.clear();
+    consumed = 0;
+}
+
+/**
+ * @brief Przetwarza kolejny fragment danych.
+ * @param chunk Fragment dokumentu JSON.
+ * @return false, jeśli wystąpił błąd składni.
+ *
+ * Token przecięty granicą fragmentu jest buforowany i dokańczany przy następnym wywołaniu.
+ */
+bool JsonStreamReader::feed(QByteArrayView chunk) {
+    if (failed) {
+        return false;
+    }
+
+    const char *p = chunk.data();
+    const char *end = p + chunk.size();
+    while (p < end && !failed) {
+        switch (lexeme) {
+        case Lexeme::None:
+            p = scanStructure(p, end);
+            break;
+        case Lexeme::String:
+            p = scanString(p, end);
+            break;
+        case Lexeme::Number:
+            p = scanNumber(p, end);
+            break;
+        case Lexeme::Literal:
+            p = scanLiteral(p, end);
+            break;
+        }
+    }
+    consumed += chunk.size();
+    return !failed;
+}
+
+/**
+ * @brief Sygnalizuje koniec danych i sprawdza kompletność dokumentu.
+ * @return true, jeśli dokument był kompletny i poprawny.
+ */
+bool JsonStreamReader::finish() {
+    if (failed) {
+        return false;
+    }
+    // Liczba lub literał na samym końcu dokumentu nie mają znaku kończącego
+    if (lexeme == Lexeme::Number) {
+        emitNumber();
+    } else if (lexeme == Lexeme::Literal) {
+        emitLiteral();
+    }
+    if (!failed && (lexeme != Lexeme::None || !stack.isEmpty() || rootExpect != Expect::Done)) {
+        fail(QStringLiteral("Nieoczekiwany koniec danych JSON"));
+    }
+    return !failed;
+}
+
+/**
+ * @brief Przetwarza znaki strukturalne i rozpoczyna wczytywanie tokenów.
+ * @param p Bieżąca pozycja.
+ * @param end Koniec fragmentu.
+ * @return Pozycja po przetworzonych znakach.
+ */
+const char *JsonStreamReader::scanStructure(const char *p, const char *end) {
+    while (p < end && lexeme == Lexeme::None && !failed) {
+        const char c = *p;
+        switch (c) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            ++p;
+            break;
+        case '{':
+            ++p;
+            if (beginValue()) {
+                stack.append({true, Expect::KeyOrEnd});
+                handler->startObject();
+            }
+            break;
+        case '[':
+            ++p;
+            if (beginValue()) {
+                stack.append({false, Expect::ValueOrEnd});
+                handler->startArray();
+            }
+            break;
+        case '}':
+        case ']': {
+            ++p;
+            const bool object = (c == '}');
+            if (stack.isEmpty() || stack.last().object != object) {
+                fail(QStringLiteral("Niedopasowany znak '%1'").arg(QLatin1Char(c)));
+                break;
+            }
+            Expect e = stack.last().expect;
+            if (e != Expect::CommaOrEnd && e != Expect::KeyOrEnd && e != Expect::ValueOrEnd) {
+                fail(QStringLiteral("Nieoczekiwany znak '%1'").arg(QLatin1Char(c)));
+                break;
+            }
+            stack.removeLast();
+            if (object) {
+                handler->endObject();
+            } else {
+                handler->endArray();
+            }
+            valueCompleted();
+            break;
+        }
+        case ':':
+            ++p;
+            if (stack.isEmpty() || expected() != Expect::Colon) {
+                fail(QStringLiteral("Nieoczekiwany znak ':'"));
+                break;
+            }
+            expected() = Expect::Value;
+            break;
+        case ',':
+            ++p;
+            if (stack.isEmpty() || expected() != Expect::CommaOrEnd) {
+                fail(QStringLiteral("Nieoczekiwany znak ','"));
+                break;
+            }
+            expected() = stack.last().object ? Expect::Key : Expect::Value;
+            break;
+        case '"':
+            ++p;
+            if (!stack.isEmpty() && (expected() == Expect::Key || expected() == Expect::KeyOrEnd)) {
+                stringIsKey = true;
+            } else if (beginValue()) {
+                stringIsKey = false;
+            } else {
+                break;
+            }
+            lexeme = Lexeme::String;
+            token.clear();
+            stringHasEscapes = false;
+            escapeNext = false;
+            break;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                if (beginValue()) {
+                    lexeme = Lexeme::Number;
+                    token.clear();
+                }
+            } else if (c >= 'a' && c <= 'z') {
+                if (beginValue()) {
+                    lexeme = Lexeme::Literal;
+                    token.clear();
+                }
+            } else {
+                fail(QStringLiteral("Nieoczekiwany znak '%1'").arg(QLatin1Char(c)));
+            }
+            break;
+        }
+    }
+    return p;
+}
+
+/**
+ * @brief Wczytuje zawartość napisu aż do zamykającego cudzysłowu.
+ * @param p Bieżąca pozycja.
+ * @param end Koniec fragmentu.
+ * @return Pozycja po przetworzonych znakach.
+ */
+const char *JsonStreamReader::scanString(const char *p, const char *end) {
+    while (p < end) {
+        if (escapeNext) {
+            token.append(*p++);
+            escapeNext = false;
+            continue;
+        }
+        const char c = *p;
+        if (c == '"') {
+            ++p;
+            lexeme = Lexeme::None;
+            emitString();
+            return p;
+        }
+        if (c == '\\') {
+            token.append(*p++);
+            escapeNext = true;
+            stringHasEscapes = true;
+            continue;
+        }
+        // Kopiuj w całości ciąg zwykłych znaków
+        const char *run = p;
+        while (p < end && *p != '"' && *p != '\\') {
+            ++p;
+        }
+        token.append(run, p - run);
+    }
+    return p;
+}
+
+/**
+ * @brief Wczytuje znaki liczby.
+ * @param p Bieżąca pozycja.
+ * @param end Koniec fragmentu.
+ * @return Pozycja pierwszego znaku, który nie należy do liczby.
+ */
+const char *JsonStreamReader::scanNumber(const char *p, const char *end) {
+    const char *run = p;
+    while (p < end) {
+        const char c = *p;
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            ++p;
+        } else {
+            token.append(run, p - run);
+            emitNumber();
+            return p;
+        }
+    }
+    token.append(run, p - run);
+    return p;
+}
+
+/**
+ * @brief Wczytuje literał (@c true, @c false, @c null).
+ * @param p Bieżąca pozycja.
+ * @param end Koniec fragmentu.
+ * @return Pozycja pierwszego znaku po literale.
+ */
+const char *JsonStreamReader::scanLiteral(const char *p, const char *end) {
+    const char *run = p;
+    while (p < end && *p >= 'a' && *p <= 'z') {
+        ++p;
+    }
+    token.append(run, p - run);
+    if (p < end) {
+        emitLiteral();
+    }
+    return p;
+}
+
+/**
+ * @brief Sprawdza, czy w bieżącym miejscu może zacząć się wartość.
+ * @return true, jeśli wartość jest dozwolona.
+ */
+bool JsonStreamReader::beginValue() {
+    Expect e = expected();
+    if (e == Expect::Value || e == Expect::ValueOrEnd) {
+        return true;
+    }
+    fail(QStringLiteral("Nieoczekiwana wartość"));
+    return false;
+}
+
+/**
+ * @brief Aktualizuje stan po zakończeniu wartości.
+ */
+void JsonStreamReader::valueCompleted() {
+    expected() = stack.isEmpty() ? Expect::Done : Expect::CommaOrEnd;
+}
+
+/**
+ * @brief Przekazuje wczytany napis odbiorcy jako klucz lub wartość.
+ */
+void JsonStreamReader::emitString() {
+    QByteArrayView text(token);
+    if (stringHasEscapes) {
+        if (!unescapeToken()) {
+            return;
+        }
+        text = QByteArrayView(unescaped);
+    }
+
+    if (stringIsKey) {
+        expected() = Expect::Colon;
+        handler->key(text);
+    } else {
+        valueCompleted();
+        handler->stringValue(text);
+    }
+}
+
+/**
+ * @brief Przekazuje wczytaną liczbę odbiorcy.
+ */
+void JsonStreamReader::emitNumber() {
+    lexeme = Lexeme::None;
+    bool ok = false;
+    double value = QByteArrayView(token).toDouble(&ok);
+    if (!ok) {
+        fail(QStringLiteral("Nieprawidłowa liczba: %1").arg(QString::fromLatin1(token)));
+        return;
+    }
+    valueCompleted();
+    handler->numberValue(value);
+}
+
+/**
+ * @brief Przekazuje wczytany literał odbiorcy.
+ */
+void JsonStreamReader::emitLiteral() {
+    lexeme = Lexeme::None;
+    if (token == "true") {
+        valueCompleted();
+        handler->boolValue(true);
+    } else if (token == "false") {
+        valueCompleted();
+        handler->boolValue(false);
+    } else if (token == "null") {
+        valueCompleted();
+        handler->nullValue();
+    } else {
+        fail(QStringLiteral("Nieznany literał: %1").arg(QString::fromLatin1(token)));
+    }
+}
+
+/**
+ * @brief Rozwija sekwencje ucieczki bieżącego napisu do bufora unescaped.
+ * @return false, jeśli sekwencja jest nieprawidłowa.
+ */
+bool JsonStreamReader::unescapeToken() {
+    unescaped.clear();
+    const char *p = token.constData();
+    const char *end = p + token.size();
+    uint pendingHighSurrogate = 0;
+
+    auto hexValue = [](const char *digits, uint *out) {
+        /**
+         * @brief Lambda zamieniająca cztery cyfry szesnastkowe na liczbę.
+         * @param digits Wskaźnik na cyfry.
+         * @param out Wynik.
+         * @return true, jeśli cyfry są poprawne.
+         */
+        uint value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = digits[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= uint(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= uint(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= uint(c - 'A' + 10);
+            else return false;
+        }
+        *out = value;
+        return true;
+    };
+    auto appendUtf8 = [this](uint codePoint) {
+        /**
+         * @brief Lambda dopisująca punkt kodowy w kodowaniu UTF-8.
+         * @param codePoint Punkt kodowy Unicode.
+         */
+        if (codePoint < 0x80) {
+            unescaped.append(char(codePoint));
+        } else if (codePoint < 0x800) {
+            unescaped.append(char(0xC0 | (codePoint >> 6)));
+            unescaped.append(char(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            unescaped.append(char(0xE0 | (codePoint >> 12)));
+            unescaped.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+            unescaped.append(char(0x80 | (codePoint & 0x3F)));
+        } else {
+            unescaped.append(char(0xF0 | (codePoint >> 18)));
+            unescaped.append(char(0x80 | ((codePoint >> 12) & 0x3F)));
+            unescaped.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+            unescaped.append(char(0x80 | (codePoint & 0x3F)));
+        }
+    };
+
+    while (p < end) {
+        if (*p != '\\') {
+            unescaped.append(*p++);
+            continue;
+        }
+        if (++p >= end) {
+            fail(QStringLiteral("Niedokończona sekwencja ucieczki"));
+            return false;
+        }
+        const char c = *p++;
+        switch (c) {
+        case '"': unescaped.append('"'); break;
+        case '\\': unescaped.append('\\'); break;
+        case '/': unescaped.append('/'); break;
+        case 'b': unescaped.append('\b'); break;
+        case 'f': unescaped.append('\f'); break;
+        case 'n': unescaped.append('\n'); break;
+        case 'r': unescaped.append('\r'); break;
+        case 't': unescaped.append('\t'); break;
+        case 'u': {
+            uint unit = 0;
+            if (end - p < 4 || !hexValue(p, &unit)) {
+                fail(QStringLiteral("Nieprawidłowa sekwencja \\u"));
+                return false;
+            }
+            p += 4;
+            if (unit >= 0xD800 && unit <= 0xDBFF) {
+                pendingHighSurrogate = unit;
+            } else if (unit >= 0xDC00 && unit <= 0xDFFF && pendingHighSurrogate) {
+                appendUtf8(0x10000 + ((pendingHighSurrogate - 0xD800) << 10) + (unit - 0xDC00));
+                pendingHighSurrogate = 0;
+            } else {
+                appendUtf8(unit);
+            }
+            break;
+        }
+        default:
+            fail(QStringLiteral("Nieprawidłowa sekwencja ucieczki: \\%1").arg(QLatin1Char(c)));
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Zapisuje błąd i zatrzymuje parser.
+ * @param message Opis błędu.
+ */
+void JsonStreamReader::fail(const QString &message) {
+    if (!failed) {
+        failed = true;
+        errorMessage = message;
+    }
+}
+
+/**
+ * @brief Zwraca referencję do oczekiwanego elementu w bieżącym kontenerze.
+ * @return Referencja do pola expect bieżącego poziomu lub rootExpect.
+ */
+JsonStreamReader::Expect &JsonStreamReader::expected() {
+    return stack.isEmpty() ? rootExpect : stack.last().expect;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file jsonstreamreader.h
+ * @brief Strumieniowy (SAX) tokenizer JSON zasilany kolejnymi fragmentami danych.
+ */
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class JsonStreamHandler
+ * @brief Interfejs odbiorcy zdarzeń generowanych przez JsonStreamReader.
+ *
+ * Napisy i klucze przekazywane są jako widoki na bajty UTF-8 (już po rozwinięciu sekwencji ucieczki),
+ * ważne wyłącznie w trakcie wywołania - odbiorca sam decyduje, czy i kiedy zamienić je na QString.
+ */
+class JsonStreamHandler {
+public:
+    virtual ~JsonStreamHandler() = default;
+
+    virtual void startObject() {} ///< Początek obiektu @c {.
+    virtual void endObject() {} ///< Koniec obiektu @c }.
+    virtual void startArray() {} ///< Początek tablicy @c [.
+    virtual void endArray() {} ///< Koniec tablicy @c ].
+    virtual void key(QByteArrayView name) { Q_UNUSED(name); } ///< Klucz w obiekcie.
+    virtual void stringValue(QByteArrayView text) { Q_UNUSED(text); } ///< Wartość napisowa.
+    virtual void numberValue(double value) { Q_UNUSED(value); } ///< Wartość liczbowa.
+    virtual void boolValue(bool value) { Q_UNUSED(value); } ///< Wartość logiczna.
+    virtual void nullValue() {} ///< Wartość @c null.
+};
+
+/**
+ * @class JsonStreamReader
+ * @brief Przyrostowy parser JSON, który nigdy nie buduje drzewa dokumentu.
+ *
+ * Dane podawane są metodą feed() w dowolnie podzielonych fragmentach (np. z QNetworkReply::readyRead).
+ * Parser przechowuje jedynie bieżący, niedokończony token i stos zagnieżdżeń, więc zużycie pamięci
+ * nie zależy od rozmiaru dokumentu.
+ */
+class JsonStreamReader {
+public:
+    /**
+     * @brief Konstruktor klasy JsonStreamReader.
+     * @param handler Odbiorca zdarzeń (nie jest przejmowany na własność).
+     */
+    explicit JsonStreamReader(JsonStreamHandler *handler);
+
+    /**
+     * @brief Przetwarza kolejny fragment danych.
+     * @param chunk Fragment dokumentu JSON.
+     * @return false, jeśli wystąpił błąd składni.
+     */
+    bool feed(QByteArrayView chunk);
+    /**
+     * @brief Sygnalizuje koniec danych i sprawdza kompletność dokumentu.
+     * @return true, jeśli dokument był kompletny i poprawny.
+     */
+    bool finish();
+    /**
+     * @brief Przywraca parser do stanu początkowego.
+     */
+    void reset();
+
+    bool hasError() const { return failed; } ///< Czy wystąpił błąd.
+    QString errorString() const { return errorMessage; } ///< Opis błędu.
+    int depth() const { return stack.size(); } ///< Bieżąca głębokość zagnieżdżenia.
+    qint64 bytesConsumed() const { return consumed; } ///< Liczba przetworzonych bajtów.
+
+private:
+    /// Rodzaj aktualnie wczytywanego tokenu.
+    enum class Lexeme { None, String, Number, Literal };
+    /// Oczekiwany następny element składni.
+    enum class Expect { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, Done };
+
+    /// Poziom zagnieżdżenia (obiekt lub tablica).
+    struct Frame {
+        bool object; ///< true dla obiektu, false dla tablicy.
+        Expect expect; ///< Oczekiwany element w tym kontenerze.
+    };
+
+    const char *scanStructure(const char *p, const char *end);
+    const char *scanString(const char *p, const char *end);
+    const char *scanNumber(const char *p, const char *end);
+    const char *scanLiteral(const char *p, const char *end);
+    bool beginValue();
+    void valueCompleted();
+    void emitString();
+    void emitNumber();
+    void emitLiteral();
+    bool unescapeToken();
+    void fail(const QString &message);
+    Expect &expected();
+
+    JsonStreamHandler *handler; ///< Odbiorca zdarzeń.
+    QVector<Frame> stack; ///< Stos otwartych kontenerów.
+    Expect rootExpect; ///< Oczekiwany element poza kontenerami.
+    Lexeme lexeme; ///< Rodzaj bieżącego tokenu.
+    QByteArray token; ///< Bajty bieżącego (niedokończonego) tokenu.
+    QByteArray unescaped; ///< Bufor napisu po rozwinięciu sekwencji ucieczki.
+    bool stringIsKey; ///< Czy bieżący napis jest kluczem.
+    bool stringHasEscapes; ///< Czy bieżący napis zawiera sekwencje ucieczki.
+    bool escapeNext; ///< Czy następny bajt napisu jest poprzedzony znakiem '\'.
+    bool failed; ///< Czy wystąpił błąd.
+    QString errorMessage; ///< Opis błędu.
+    qint64 consumed; ///< Liczba przetworzonych bajtów.
+};
+
+#endif // JSONSTREAMREADER_H
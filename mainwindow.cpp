@@ -4,6 +4,8 @@
  */
 
 #include "mainwindow.h"
+#include "airqualityindex.h"
+#include "giosresponsecache.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QJsonDocument>
@@ -13,13 +15,17 @@
 #include <QLineEdit>
 #include <QIcon>
 #include <QtMath>
-#include <QGraphicsPixmapItem>
-#include <QGraphicsEllipseItem>
+#include <QSignalBlocker>
+#include <QDateTime>
 #include <QDebug>
 #include <QFileDialog>
+#include <QDialog>
+#include <QDialogButtonBox>
 #include <QFile>
 #include <QJsonDocument>
 #include <algorithm>
+#include <memory>
+#include <numeric>
 
 /**
  * @brief Konstruktor klasy MainWindow.
@@ -28,44 +34,35 @@
  * Inicjalizuje interfejs użytkownika, ustawia połączenia sygnałów i slotów oraz wysyła zapytanie do API GIOŚ.
  */
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), networkManager(new QNetworkAccessManager(this)), currentMode(0), geocodingDone(false), sortMode("none") {
+    : QMainWindow(parent), giosClient(new GiosClient(this)), currentMode(0), geocodingDone(false) {
 
     // Ustawienie ikony okna
     setWindowIcon(QIcon(":/icons/hatsune.png"));
 
-    // Tworzenie widżetu listy
-    stationListWidget = new QListWidget(this);
-    connect(stationListWidget, &QListWidget::itemClicked, this, [this](QListWidgetItem *item) {
-        if (currentMode == 0 || currentMode == 1) { // Obsługa w trybie "Wybierz Stację" i "Podaj Lokalizację"
-            QString text = item->text();
-            qDebug() << "Kliknięto stację:" << text;
-            int stationId = text.split(" - ").first().remove("ID: ").toInt();
-            QString stationName = text.split(" - ").last().split(" (").first(); // Wyodrębnij nazwę stacji
-
-            // Znajdź stację w allStations, aby uzyskać communeName i provinceName
-            QString communeName, provinceName;
-            for (const QJsonValue &value : allStations) {
-                QJsonObject station = value.toObject();
-                if (station["id"].toInt() == stationId) {
-                    QJsonObject city = station["city"].toObject();
-                    QJsonObject commune = city["commune"].toObject();
-                    communeName = commune["communeName"].toString();
-                    provinceName = commune["provinceName"].toString();
-                    break;
-                }
-            }
-
-            qDebug() << "Wyodrębnione ID stacji:" << stationId << "Nazwa:" << stationName
-                     << "Gmina:" << communeName << "Województwo:" << provinceName;
-            onStationClicked(stationId, stationName, communeName, provinceName);
-        }
-    });
-    connect(stationListWidget, &QListWidget::itemActivated, this, &MainWindow::onStationActivated);
+    // Tworzenie listy stacji (model nad katalogiem + model pośredni filtrujący i sortujący)
+    stationModel = new StationListModel(this);
+    stationProxy = new StationFilterProxyModel(this);
+    stationProxy->setStationModel(stationModel);
+    stationListView = new QListView(this);
+    stationListView->setModel(stationProxy);
+    stationListView->setUniformItemSizes(true);
+    stationListView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    connect(stationListView, &QListView::clicked, this, &MainWindow::onStationActivated);
+    connect(stationListView, &QListView::activated, this, &MainWindow::onStationActivated);
 
     // Tworzenie widżetu mapy i sceny
-    mapView = new QGraphicsView(this);
     mapScene = new QGraphicsScene(this);
-    mapView->setScene(mapScene);
+    mapScene->setSceneRect(0, 0, 600, 465);
+    mapView = new StationMapView(mapScene, this);
+
+    // Podkład mapy (obraz dekodowany raz) i odwzorowanie dopasowane do jego prostokąta
+    basemapItem = new BasemapItem(":/images/poland_map.png", mapScene->sceneRect());
+    mapScene->addItem(basemapItem);
+    projection.setTargetRect(basemapItem->mapRect());
+    heatmapLayer = new HeatmapLayer(basemapItem->mapRect());
+    heatmapLayer->setMask(basemapItem->shapeMask());
+    heatmapLayer->setZValue(0.5); // Pod znacznikami stacji
+    mapScene->addItem(heatmapLayer);
     mapView->setVisible(false);
 
     // Tworzenie przycisku z tytułem
@@ -90,6 +87,30 @@ MainWindow::MainWindow(QWidget *parent)
     radiusEdit->setPlaceholderText("Promień (km)...");
     radiusEdit->setStyleSheet("padding: 5px; font-size: 14px;");
     radiusEdit->setVisible(false);
+    connect(radiusEdit, &QLineEdit::textChanged, this, [this]() {
+        /**
+         * @brief Lambda odświeżająca wyniki w trakcie edycji promienia (lub liczby stacji).
+         */
+        if (currentMode == 1 && geocodingDone) {
+            showLocationResults();
+        }
+    });
+
+    // Tworzenie listy rozwijanej trybu zapytania (promień lub N najbliższych stacji)
+    queryModeComboBox = new QComboBox(this);
+    queryModeComboBox->addItems({"W promieniu", "N najbliższych"});
+    queryModeComboBox->setStyleSheet("padding: 5px; font-size: 14px;");
+    queryModeComboBox->setVisible(false);
+    connect(queryModeComboBox, &QComboBox::currentIndexChanged, this, [this](int index) {
+        /**
+         * @brief Lambda obsługująca zmianę trybu zapytania.
+         * @param index Indeks wybranego trybu (0 - promień, 1 - N najbliższych).
+         */
+        radiusEdit->setPlaceholderText(index == 1 ? "Liczba stacji..." : "Promień (km)...");
+        if (currentMode == 1 && geocodingDone) {
+            showLocationResults(); // Punkt jest już znany - bez ponownego geokodowania
+        }
+    });
 
     // Tworzenie przycisku Szukaj
     searchButton = new QPushButton("Szukaj", this);
@@ -105,20 +126,63 @@ MainWindow::MainWindow(QWidget *parent)
          * @brief Lambda obsługująca zmianę trybu sortowania.
          * @param text Wybrany tekst w liście rozwijanej.
          */
+        // Model pośredni sortuje bieżące wyniki lokalnie - bez ponownego wyszukiwania i geokodowania
         if (text == "Sortuj po ID") {
-            sortMode = "id";
+            stationProxy->setSortKey(StationFilterProxyModel::ById);
         } else if (text == "Sortuj po km") {
-            sortMode = "distance";
+            stationProxy->setSortKey(StationFilterProxyModel::ByDistance);
         } else {
-            sortMode = "none";
-        }
-        onSearchTextChanged(searchEdit->text()); // Odśwież listę w trybie "Wybierz Stację"
-        if (currentMode == 1 && geocodingDone) {
-            // Odśwież listę w trybie "Podaj Lokalizację"
-            onSearchButtonClicked();
+            stationProxy->setSortKey(StationFilterProxyModel::GivenOrder);
         }
     });
 
+    // Tworzenie list rozwijanych filtrów (województwo, gmina, parametr) i sposobu ich łączenia
+    provinceFilterComboBox = new QComboBox(this);
+    provinceFilterComboBox->addItem("Wszystkie województwa");
+    communeFilterComboBox = new QComboBox(this);
+    communeFilterComboBox->addItem("Wszystkie gminy");
+    parameterFilterComboBox = new QComboBox(this);
+    parameterFilterComboBox->addItem("Wszystkie parametry");
+    filterModeComboBox = new QComboBox(this);
+    filterModeComboBox->addItems({"Wszystkie warunki (AND)", "Dowolny warunek (OR)"});
+    for (QComboBox *comboBox : {provinceFilterComboBox, communeFilterComboBox, parameterFilterComboBox, filterModeComboBox}) {
+        comboBox->setStyleSheet("padding: 5px; font-size: 14px;");
+        connect(comboBox, &QComboBox::currentIndexChanged, this, &MainWindow::applyFilters);
+    }
+
+    // Tworzenie wyboru mapy ciepła (parametr i godzina pomiaru)
+    heatmapComboBox = new QComboBox(this);
+    heatmapComboBox->addItem("Bez mapy ciepła");
+    heatmapComboBox->addItems(AirQualityIndex::parameters());
+    heatmapComboBox->setStyleSheet("padding: 5px; font-size: 14px;");
+    heatmapComboBox->setVisible(false);
+    heatmapHourSlider = new QSlider(Qt::Horizontal, this);
+    heatmapHourSlider->setRange(-47, 0); // Ostatnie 48 godzin
+    heatmapHourSlider->setValue(0);
+    heatmapHourSlider->setVisible(false);
+    heatmapHourLabel = new QLabel(this);
+    heatmapHourLabel->setVisible(false);
+    heatmapTimer = new QTimer(this);
+    heatmapTimer->setSingleShot(true);
+    heatmapTimer->setInterval(200);
+    connect(heatmapComboBox, &QComboBox::currentIndexChanged, this, &MainWindow::updateHeatmap);
+    connect(heatmapHourSlider, &QSlider::valueChanged, this, &MainWindow::updateHeatmap);
+    connect(heatmapTimer, &QTimer::timeout, this, &MainWindow::updateHeatmap);
+    indexTimer = new QTimer(this);
+    indexTimer->setInterval(20 * 60 * 1000); // Indeksy GIOŚ aktualizowane są co godzinę
+    connect(indexTimer, &QTimer::timeout, this, &MainWindow::requestStationIndexes);
+    // Bieżąca godzina mapy ciepła przesuwa się, a pomiary się starzeją - także bez działań użytkownika
+    connect(indexTimer, &QTimer::timeout, this, &MainWindow::updateHeatmap);
+    indexTimer->start();
+    catalogTimer = new QTimer(this);
+    catalogTimer->setInterval(6 * 3600 * 1000); // Nowe stacje bez ponownego uruchamiania aplikacji
+    connect(catalogTimer, &QTimer::timeout, this, &MainWindow::refreshCatalog);
+    catalogTimer->start();
+    parametersTimer = new QTimer(this);
+    parametersTimer->setSingleShot(true);
+    parametersTimer->setInterval(200);
+    connect(parametersTimer, &QTimer::timeout, this, &MainWindow::applyStationParameters);
+
     // Tworzenie przycisku Odczytaj Dane z Pliku
     loadFileButton = new QPushButton("Odczytaj Dane z Pliku", this);
     loadFileButton->setStyleSheet("padding: 5px; font-size: 16px; font-weight: bold; background-color: #6BB8D8; color: white; border: none; height: 30px; min-width: 200px;");
@@ -126,13 +190,14 @@ MainWindow::MainWindow(QWidget *parent)
     connect(loadFileButton, &QPushButton::clicked, this, &MainWindow::onLoadFileButtonClicked);
 
     // Tworzenie karty informacyjnej jako nakładki
-    infoCard = new StationInfoCard(this); // Bez kontenera, bezpośrednio w MainWindow
+    infoCard = new StationInfoCard(giosClient, this); // Bez kontenera, bezpośrednio w MainWindow
     infoCard->setVisible(false); // Początkowo niewidoczna
+    connect(infoCard, &StationInfoCard::sensorsLoaded, this, &MainWindow::setStationSensors);
     connect(infoCard, &StationInfoCard::cardClosed, this, [this]() {
         /**
          * @brief Lambda obsługująca zamknięcie karty informacyjnej.
          */
-        stationListWidget->setEnabled(true); // Włącz interakcję z listą po zamknięciu karty
+        stationListView->setEnabled(true); // Włącz interakcję z listą po zamknięciu karty
         qDebug() << "Karta zamknięta, interakcja z listą włączona";
     });
 
@@ -148,16 +213,30 @@ MainWindow::MainWindow(QWidget *parent)
     searchLayout->addWidget(searchEdit);
     searchLayout->addWidget(sortComboBox);
 
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(provinceFilterComboBox);
+    filterLayout->addWidget(communeFilterComboBox);
+    filterLayout->addWidget(parameterFilterComboBox);
+    filterLayout->addWidget(filterModeComboBox);
+
     QHBoxLayout *radiusLayout = new QHBoxLayout();
+    radiusLayout->addWidget(queryModeComboBox);
     radiusLayout->addWidget(radiusEdit);
     radiusLayout->addWidget(searchButton);
     radiusLayout->addStretch();
 
+    QHBoxLayout *heatmapLayout = new QHBoxLayout();
+    heatmapLayout->addWidget(heatmapComboBox);
+    heatmapLayout->addWidget(heatmapHourSlider);
+    heatmapLayout->addWidget(heatmapHourLabel);
+
     mainLayout->addLayout(headerLayout);
     mainLayout->addLayout(searchLayout);
+    mainLayout->addLayout(filterLayout);
     mainLayout->addLayout(radiusLayout);
-    mainLayout->addWidget(stationListWidget);
+    mainLayout->addWidget(stationListView);
     mainLayout->addWidget(loadFileButton);
+    mainLayout->addLayout(heatmapLayout);
     mainLayout->addWidget(mapView);
     centralWidget->setLayout(mainLayout);
     setCentralWidget(centralWidget);
@@ -165,18 +244,12 @@ MainWindow::MainWindow(QWidget *parent)
     // Ustawienie rozmiaru okna
     resize(600, 800);
 
-    // Wysłanie zapytania HTTP do API GIOŚ
-    QUrl url("http://api.gios.gov.pl/pjp-api/rest/station/findAll");
-    QNetworkRequest request;
-    request.setUrl(url);
-    request.setHeader(QNetworkRequest::UserAgentHeader, "MyStationFinderApp/1.0");
-    QNetworkReply *reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+    // Wysłanie zapytania do API GIOŚ (odpowiedź może pochodzić z pamięci podręcznej)
+    giosClient->fetchCatalog(this, [this](const GiosResult &result, StationCatalog &loaded) {
         /**
-         * @brief Lambda obsługująca zakończenie zapytania HTTP do API GIOŚ.
-         * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
+         * @brief Lambda obsługująca zakończenie pobierania listy stacji.
          */
-        onReplyFinished(reply);
+        onReplyFinished(result, loaded);
     });
 
     // Połączenie sygnałów
@@ -191,134 +264,149 @@ MainWindow::MainWindow(QWidget *parent)
 MainWindow::~MainWindow() {}
 
 /**
- * @brief Obsługuje zakończenie odpowiedzi HTTP z API.
- * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
+ * @brief Obsługuje zakończenie pobierania listy stacji z API.
+ * @param result Wynik zapytania.
+ * @param loaded Katalog zbudowany przez parser strumieniowy.
  *
- * Parsuje dane JSON z listy stacji, rysuje kropki na mapie i aktualizuje listę stacji.
+ * Przejmuje katalog, rysuje kropki na mapie i aktualizuje listę stacji.
+ * Bez połączenia z serwerem katalog pochodzi z ostatniej zapisanej odpowiedzi.
  */
-void MainWindow::onReplyFinished(QNetworkReply *reply) {
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray rawData = reply->readAll();
-        qDebug() << "Surowa odpowiedź API GIOŚ (lista stacji):" << rawData;
-
-        QJsonDocument doc = QJsonDocument::fromJson(rawData);
-        if (doc.isNull()) {
-            qDebug() << "Błąd: Nie udało się sparsować JSON z GIOŚ.";
-            QMessageBox::critical(this, "Błąd", "Nieprawidłowy format danych JSON z GIOŚ.");
-            reply->deleteLater();
+void MainWindow::onReplyFinished(const GiosResult &result, StationCatalog &loaded) {
+    if (result.ok()) {
+        catalog = std::move(loaded);
+        qDebug() << "Pobrano" << catalog.size() << "stacji" << (result.fromCache ? "(z pamięci podręcznej)" : "");
+        spatialIndex.build(catalog);
+        textIndex.build(catalog);
+        gazetteer.build(catalog);
+        stationModel->setCatalog(&catalog);
+        facetIndex.build(catalog);
+        filterMask = facetIndex.allStations();
+        populateFilterComboBox(provinceFilterComboBox, StationFacetIndex::Province);
+        populateFilterComboBox(communeFilterComboBox, StationFacetIndex::Commune);
+        populateFilterComboBox(parameterFilterComboBox, StationFacetIndex::Parameter);
+
+        // Podkład mapy wczytywany jest raz, w konstruktorze
+        if (basemapItem->isNull()) {
+            QMessageBox::critical(this, "Błąd", "Nie udało się załadować obrazu mapy.");
             return;
         }
 
-        allStations = doc.array();
-        qDebug() << "Pobrano" << allStations.size() << "stacji";
-        if (!allStations.isEmpty()) {
-            QJsonObject firstStation = allStations[0].toObject();
-            qDebug() << "Przykładowa stacja:" << firstStation;
+        // Usuń znaczniki poprzedniego katalogu
+        delete markerLayer;
+        markerLayer = nullptr;
+        mapView->resetZoom();
+
+        // Pozycje stacji liczone są raz dla katalogu (stały zasięg obrazu mapy)
+        projection.setCatalog(catalog);
+        parameterSensors.clear();
+        sensorFetchTimes.clear();
+        for (const QString &paramCode : AirQualityIndex::parameters()) {
+            heatmapLayer->invalidate(paramCode);
         }
+        QVector<StationMarkerLayer::Marker> markers;
+        markers.reserve(catalog.size());
+        for (int i = 0; i < catalog.size(); ++i) {
+            if (projection.hasPosition(i)) {
+                markers.append({i, catalog.id(i), projection.position(i), catalog.name(i)});
+            }
+        }
+        markerLayer = new StationMarkerLayer();
+        markerLayer->setMarkers(markers);
+        markerLayer->setZValue(1);
+        mapScene->addItem(markerLayer);
+        connect(markerLayer, &StationMarkerLayer::stationClicked, this, &MainWindow::onMarkerClicked);
+        connect(markerLayer, &StationMarkerLayer::clusterClicked, mapView, &StationMapView::zoomInAt);
+
+        QVector<int> stations(catalog.size());
+        std::iota(stations.begin(), stations.end(), 0);
+        requestStationParameters(stations);
+        requestStationIndexes();
+        applyFilters();
+        updateHeatmap();
+    } else if (result.status == GiosResult::ParseError) {
+        qDebug() << "Błąd: Nie udało się sparsować JSON z GIOŚ:" << result.errorString;
+        QMessageBox::critical(this, "Błąd", "Nieprawidłowy format danych JSON z GIOŚ.");
+    } else {
+        qDebug() << "Błąd pobierania listy stacji:" << result.errorString;
+        QMessageBox::critical(this, "Błąd", "Nie udało się pobrać danych z GIOŚ: " + result.errorString);
+    }
+}
 
-        // Wyczyść scenę mapy
-        mapScene->clear();
-
-        // Ustaw rozmiar sceny
-        const double mapWidth = 600;
-        const double mapHeight = 465;
-        mapScene->setSceneRect(0, 0, mapWidth, mapHeight);
+/**
+ * @brief Pobiera z serwera aktualną listę stacji (z pominięciem pamięci podręcznej).
+ *
+ * Bez połączenia z serwerem odpowiedź pochodzi z pamięci podręcznej, więc katalog się nie zmienia.
+ */
+void MainWindow::refreshCatalog() {
+    giosClient->fetchCatalog(this, [this](const GiosResult &result, StationCatalog &loaded) {
+        /**
+         * @brief Lambda obsługująca zakończenie odświeżania listy stacji.
+         */
+        onCatalogRefreshed(result, loaded);
+    }, QNetworkRequest::AlwaysNetwork);
+}
 
-        // Wczytaj i przeskaluj mapę
-        QPixmap mapPixmap(":/images/poland_map.png");
-        if (mapPixmap.isNull()) {
-            qDebug() << "Błąd: Nie udało się załadować obrazu mapy!";
-            QMessageBox::critical(this, "Błąd", "Nie udało się załadować obrazu mapy.");
-            reply->deleteLater();
-            return;
-        }
+/**
+ * @brief Uzgadnia katalog z odświeżoną listą stacji, aktualizując tylko zmienione stacje.
+ * @param result Wynik zapytania.
+ * @param loaded Nowa wersja katalogu.
+ *
+ * Stacje porównywane są według ID (StationCatalog::merge()), a indeksy pozostałych stacji się
+ * nie zmieniają. Do modelu listy dopisywane są tylko nowe wiersze, a warstwa znaczników dodaje,
+ * przesuwa i usuwa tylko znaczniki zmienionych stacji, więc zaznaczenie na liście, przybliżenie
+ * mapy i otwarta karta stacji pozostają bez zmian. Jeśli katalog nie został jeszcze wczytany,
+ * jest wczytywany w całości.
+ */
+void MainWindow::onCatalogRefreshed(const GiosResult &result, StationCatalog &loaded) {
+    if (!result.ok()) {
+        qDebug() << "Błąd odświeżania listy stacji:" << result.errorString;
+        return;
+    }
+    if (catalog.isEmpty() || !markerLayer) {
+        onReplyFinished(result, loaded);
+        return;
+    }
+    const StationCatalog::Changes changes = catalog.merge(loaded);
+    qDebug() << "Odświeżono listę stacji: nowe" << changes.added.size() << "zmienione" << changes.changed.size()
+             << "usunięte" << changes.removed.size();
+    if (changes.isEmpty()) {
+        return;
+    }
 
-        mapPixmap = mapPixmap.scaled(mapWidth, mapHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        QGraphicsPixmapItem *mapItem = new QGraphicsPixmapItem(mapPixmap);
-
-        // Oblicz przesunięcie, jeśli mapa nie wypełnia całej sceny
-        double mapPixmapWidth = mapPixmap.width();
-        double mapPixmapHeight = mapPixmap.height();
-        double offsetX = (mapWidth - mapPixmapWidth) / 2.0;
-        double offsetY = (mapHeight - mapPixmapHeight) / 2.0;
-        mapItem->setPos(offsetX, offsetY);
-        mapScene->addItem(mapItem);
-
-        // Oblicz rzeczywiste granice stacji
-        double actualLonMin = std::numeric_limits<double>::max();
-        double actualLonMax = std::numeric_limits<double>::min();
-        double actualLatMin = std::numeric_limits<double>::max();
-        double actualLatMax = std::numeric_limits<double>::min();
-
-        for (const QJsonValue &value : allStations) {
-            QJsonObject station = value.toObject();
-            if (station.contains("gegrLat") && station.contains("gegrLon")) {
-                double lat = station["gegrLat"].toString().toDouble();
-                double lon = station["gegrLon"].toString().toDouble();
-                if (lon < actualLonMin) actualLonMin = lon;
-                if (lon > actualLonMax) actualLonMax = lon;
-                if (lat < actualLatMin) actualLatMin = lat;
-                if (lat > actualLatMax) actualLatMax = lat;
-            }
+    // Indeksy wyszukiwania budowane są od nowa (bez zmian w interfejsie)
+    spatialIndex.build(catalog);
+    textIndex.build(catalog);
+    gazetteer.build(catalog);
+    facetIndex.update(catalog, changes.added + changes.changed + changes.removed);
+    stationModel->updateStations(changes.changed + changes.removed);
+    populateFilterComboBox(provinceFilterComboBox, StationFacetIndex::Province);
+    populateFilterComboBox(communeFilterComboBox, StationFacetIndex::Commune);
+    populateFilterComboBox(parameterFilterComboBox, StationFacetIndex::Parameter);
+
+    projection.setCatalog(catalog);
+    QVector<StationMarkerLayer::Marker> markers;
+    QVector<int> removedMarkers = changes.removed;
+    for (int i : changes.added + changes.changed) {
+        if (projection.hasPosition(i)) {
+            markers.append({i, catalog.id(i), projection.position(i), catalog.name(i)});
+        } else {
+            removedMarkers.append(i);
         }
-        qDebug() << "Actual lon range:" << actualLonMin << "to" << actualLonMax;
-        qDebug() << "Actual lat range:" << actualLatMin << "to" << actualLatMax;
+    }
+    markerLayer->updateMarkers(markers, removedMarkers);
 
-        // Oblicz wartości dla projekcji Mercator (oś Y)
-        auto mercatorY = [](double lat) {
-            /**
-             * @brief Lambda obliczająca współrzędną Y w projekcji Mercator.
-             * @param lat Szerokość geograficzna w stopniach.
-             * @return Współrzędna Y w projekcji Mercator.
-             */
-            const double R = 6371.0;
-            double latRad = qDegreesToRadians(lat);
-            return R * log(tan(M_PI / 4 + latRad / 2));
-        };
-
-        double mercatorMin = mercatorY(actualLatMin);
-        double mercatorMax = mercatorY(actualLatMax);
-        double mercatorRange = mercatorMax - mercatorMin;
-
-        // Skaluj kropki do rozmiaru mapy (nie sceny)
-        double scaleX = mapPixmapWidth / (actualLonMax - actualLonMin);
-        double scaleY = mapPixmapHeight / mercatorRange;
-
-        // Narysuj kropki dla stacji
-        for (const QJsonValue &value : allStations) {
-            QJsonObject station = value.toObject();
-            if (station.contains("gegrLat") && station.contains("gegrLon") && station.contains("stationName")) {
-                double lat = station["gegrLat"].toString().toDouble();
-                double lon = station["gegrLon"].toString().toDouble();
-                QString name = station["stationName"].toString();
-                int stationId = station["id"].toInt();
-
-                // Oblicz pozycję kropki w skali mapy
-                double x = (lon - actualLonMin) * scaleX;
-                double mercatorLat = mercatorY(lat);
-                double y = (mercatorMax - mercatorLat) * scaleY;
-
-                // Dodaj przesunięcie, aby kropki były wyrównane z mapą
-                x += offsetX;
-                y += offsetY;
-
-                ClickableEllipseItem *dot = new ClickableEllipseItem(stationId, x - 5, y - 5, 10, 10);
-                dot->setBrush(QBrush(Qt::red));
-                dot->setPen(QPen(Qt::black, 1));
-                dot->setToolTip(name);
-                dot->setZValue(1);
-                mapScene->addItem(dot);
-
-                connect(dot, &ClickableEllipseItem::clicked, this, &MainWindow::onEllipseClicked);
-            }
+    for (QHash<int, int> &sensors : parameterSensors) {
+        for (int i : changes.removed) {
+            sensors.remove(i);
         }
-
-        onSearchTextChanged(searchEdit->text());
-    } else {
-        qDebug() << "Błąd pobierania listy stacji:" << reply->errorString();
-        QMessageBox::critical(this, "Błąd", "Nie udało się pobrać danych z GIOŚ: " + reply->errorString());
     }
-    reply->deleteLater();
+    for (const QString &paramCode : AirQualityIndex::parameters()) {
+        heatmapLayer->invalidate(paramCode);
+    }
+    requestStationParameters(changes.added);
+    requestStationIndexes();
+    applyFilters();
+    updateHeatmap();
 }
 
 /**
@@ -328,44 +416,20 @@ void MainWindow::onReplyFinished(QNetworkReply *reply) {
  * Aktualizuje listę stacji w trybie "Wybierz Stację" na podstawie wprowadzonego tekstu wyszukiwania.
  */
 void MainWindow::onSearchTextChanged(const QString &text) {
-    stationListWidget->clear();
-
     if (currentMode == 0) {
-        QString searchText = text.trimmed().toLower();
-        QList<QPair<int, QString>> stationItems; // Para: ID, tekst elementu
-
-        for (const QJsonValue &value : allStations) {
-            QJsonObject station = value.toObject();
-            if (station.contains("city") && station["city"].isObject()) {
-                QJsonObject city = station["city"].toObject();
-                QString cityName = city["name"].toString().toLower();
-                if (cityName.contains(searchText) || searchText.isEmpty()) {
-                    QString stationName = station["stationName"].toString();
-                    int stationId = station["id"].toInt();
-                    QString itemText = QString("ID: %1 - %2").arg(stationId).arg(stationName);
-                    stationItems.append(qMakePair(stationId, itemText));
-                }
-            }
-        }
-
-        // Sortowanie, jeśli wybrano sortowanie po ID
-        if (sortMode == "id") {
-            std::sort(stationItems.begin(), stationItems.end(),
-                      [](const QPair<int, QString> &a, const QPair<int, QString> &b) {
+        // Indeks zawęża poprzedni wynik, gdy tekst jest tylko uzupełniany; model pośredni tylko filtruje wiersze
+        QVector<int> matches = textIndex.search(text);
+        matches.erase(std::remove_if(matches.begin(), matches.end(), [this](int index) {
                           /**
-                           * @brief Lambda porównująca elementy do sortowania po ID.
-                           * @param a Pierwszy element (para ID i tekst).
-                           * @param b Drugi element (para ID i tekst).
-                           * @return Wartość logiczna określająca kolejność.
+                           * @brief Lambda odrzucająca stacje niespełniające filtrów.
+                           * @param index Indeks stacji w katalogu.
+                           * @return true, jeśli stację należy usunąć z listy.
                            */
-                          return a.first < b.first;
-                      });
-        }
-
-        // Dodaj posortowane elementy do listy
-        for (const auto &item : stationItems) {
-            stationListWidget->addItem(item.second);
-        }
+                          return !filterMask.testBit(index);
+                      }),
+                      matches.end());
+        stationModel->clearDistances();
+        stationProxy->setStations(matches);
     } else if (currentMode == 1) {
         // W trybie "Podaj Lokalizację" lista jest aktualizowana po kliknięciu "Szukaj"
     } else if (currentMode == 2) {
@@ -380,9 +444,9 @@ void MainWindow::onSearchTextChanged(const QString &text) {
  */
 void MainWindow::onTitleButtonClicked() {
     currentMode = (currentMode + 1) % 3;
-    stationListWidget->clear();
+    stationProxy->setStations({});
     infoCard->setVisible(false); // Ukryj kartę przy zmianie trybu
-    stationListWidget->setEnabled(true); // Włącz interakcję z listą
+    stationListView->setEnabled(true); // Włącz interakcję z listą
 
     sortComboBox->clear();
     if (currentMode == 0) {
@@ -392,7 +456,6 @@ void MainWindow::onTitleButtonClicked() {
     } else {
         sortComboBox->addItems({"Bez sortowania"});
     }
-    sortMode = "none";
 
     switch (currentMode) {
     case 0:
@@ -402,9 +465,13 @@ void MainWindow::onTitleButtonClicked() {
         searchEdit->setVisible(true);
         searchButton->setVisible(false);
         radiusEdit->setVisible(false);
-        stationListWidget->setVisible(true);
+        queryModeComboBox->setVisible(false);
+        stationListView->setVisible(true);
         loadFileButton->setVisible(true);
         mapView->setVisible(false);
+        heatmapComboBox->setVisible(false);
+        heatmapHourSlider->setVisible(false);
+        heatmapHourLabel->setVisible(false);
         sortComboBox->setVisible(true);
         onSearchTextChanged(searchEdit->text());
         break;
@@ -415,9 +482,13 @@ void MainWindow::onTitleButtonClicked() {
         searchEdit->setVisible(true);
         searchButton->setVisible(true);
         radiusEdit->setVisible(true);
-        stationListWidget->setVisible(true);
+        queryModeComboBox->setVisible(true);
+        stationListView->setVisible(true);
         loadFileButton->setVisible(false);
         mapView->setVisible(false);
+        heatmapComboBox->setVisible(false);
+        heatmapHourSlider->setVisible(false);
+        heatmapHourLabel->setVisible(false);
         sortComboBox->setVisible(true);
         break;
     case 2:
@@ -426,9 +497,13 @@ void MainWindow::onTitleButtonClicked() {
         searchEdit->setVisible(false);
         searchButton->setVisible(false);
         radiusEdit->setVisible(false);
-        stationListWidget->setVisible(false);
+        queryModeComboBox->setVisible(false);
+        stationListView->setVisible(false);
         loadFileButton->setVisible(false);
         mapView->setVisible(true);
+        heatmapComboBox->setVisible(true);
+        heatmapHourSlider->setVisible(true);
+        heatmapHourLabel->setVisible(true);
         sortComboBox->setVisible(false);
         break;
     }
@@ -437,12 +512,21 @@ void MainWindow::onTitleButtonClicked() {
 /**
  * @brief Obsługuje kliknięcie przycisku wyszukiwania.
  *
- * Inicjuje geokodowanie lokalizacji wprowadzonej w polu wyszukiwania.
+ * Inicjuje geokodowanie lokalizacji wprowadzonej w polu wyszukiwania. Jeśli lokalizacja została już
+ * geokodowana, wyniki są wyznaczane ponownie z zapamiętanego punktu, bez zapytania do Nominatim.
  */
 void MainWindow::onSearchButtonClicked() {
     QString location = searchEdit->text().trimmed();
-    if (location.length() >= 5) {
+    GeoPoint point;
+    if (geocodingDone && location == geocodedLocation) {
+        // Ta sama lokalizacja - wyniki liczone są ponownie z zapamiętanego punktu
+        if (showLocationResults() == 0) {
+            QMessageBox::information(this, "Informacja", "Brak stacji spełniających kryteria.");
+        }
+    } else if (location.length() >= 5 || gazetteer.lookup(location, &point) || geocodeCache.lookup(location, &point)) {
+        // Krótsze nazwy (np. "Łódź") są dopuszczalne, jeśli zna je spis miejscowości lub pamięć podręczna
         geocodingDone = false;
+        geocodedLocation = location;
         geocodeLocation(location);
     } else {
         QMessageBox::warning(this, "Błąd", "Wprowadź co najmniej 5 znaków, aby wyszukać lokalizację.");
@@ -456,6 +540,19 @@ void MainWindow::onSearchButtonClicked() {
  * Wysyła zapytanie do API Nominatim w celu uzyskania współrzędnych geograficznych.
  */
 void MainWindow::geocodeLocation(const QString &location) {
+    // Najpierw odpowiedzi lokalne: zapamiętane wyniki Nominatim, potem spis miejscowości z katalogu
+    GeoPoint point;
+    if (geocodeCache.lookup(location, &point)) {
+        qDebug() << "Lokalizacja z pamięci podręcznej:" << location;
+        onLocationResolved(point);
+        return;
+    }
+    if (gazetteer.lookup(location, &point)) {
+        qDebug() << "Lokalizacja ze spisu miejscowości GIOŚ:" << location;
+        onLocationResolved(point);
+        return;
+    }
+
     QString encodedLocation = QUrl::toPercentEncoding(location);
     QString urlString = QString("https://nominatim.openstreetmap.org/search?q=%1&format=json&limit=1").arg(encodedLocation);
 
@@ -464,23 +561,25 @@ void MainWindow::geocodeLocation(const QString &location) {
     request.setUrl(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, "MyStationFinderApp/1.0");
 
-    QNetworkReply *reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+    QNetworkReply *reply = giosClient->networkManager()->get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, location]() {
         /**
          * @brief Lambda obsługująca zakończenie zapytania geokodowania.
          * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
          */
-        onGeocodingReplyFinished(reply);
+        onGeocodingReplyFinished(reply, location);
     });
 }
 
 /**
  * @brief Obsługuje odpowiedź geokodowania z API Nominatim.
- * @param reply W regulations pointer to the network reply object.
+ * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
+ * @param location Geokodowany tekst lokalizacji.
  *
- * Parsuje odpowiedź, aktualizuje współrzędne użytkownika i odświeża listę stacji w trybie "Podaj Lokalizację".
+ * Parsuje odpowiedź, zapamiętuje współrzędne w pamięci podręcznej geokodowania i odświeża listę stacji
+ * w trybie "Podaj Lokalizację".
  */
-void MainWindow::onGeocodingReplyFinished(QNetworkReply *reply) {
+void MainWindow::onGeocodingReplyFinished(QNetworkReply *reply, const QString &location) {
     if (reply->error() == QNetworkReply::NoError) {
         QByteArray rawData = reply->readAll();
         qDebug() << "Surowa odpowiedź Nominatim:" << rawData;
@@ -491,62 +590,9 @@ void MainWindow::onGeocodingReplyFinished(QNetworkReply *reply) {
         if (!results.isEmpty()) {
             QJsonObject result = results[0].toObject();
             if (result.contains("lat") && result.contains("lon")) {
-                userLat = result["lat"].toString().toDouble();
-                userLon = result["lon"].toString().toDouble();
-                geocodingDone = true;
-
-                stationListWidget->clear();
-
-                bool ok;
-                double radiusKm = radiusEdit->text().toDouble(&ok);
-                if (!ok || radiusKm <= 0) {
-                    radiusKm = 10.0;
-                }
-
-                QList<QPair<QPair<double, int>, QString>> stationItems; // Para: (odległość/ID, ID), tekst elementu
-
-                for (const QJsonValue &value : allStations) {
-                    QJsonObject station = value.toObject();
-                    if (station.contains("gegrLat") && station.contains("gegrLon")) {
-                        double stationLat = station["gegrLat"].toString().toDouble();
-                        double stationLon = station["gegrLon"].toString().toDouble();
-                        double distance = calculateDistance(userLat, userLon, stationLat, stationLon);
-
-                        if (distance <= radiusKm) {
-                            QString stationName = station["stationName"].toString();
-                            int stationId = station["id"].toInt();
-                            QString itemText = QString("ID: %1 - %2 (%3 km)")
-                                                   .arg(stationId)
-                                                   .arg(stationName)
-                                                   .arg(distance, 0, 'f', 1);
-                            double sortKey = (sortMode == "distance") ? distance : stationId;
-                            stationItems.append(qMakePair(qMakePair(sortKey, stationId), itemText));
-                        }
-                    }
-                }
-
-                // Sortowanie
-                if (sortMode == "id" || sortMode == "distance") {
-                    std::sort(stationItems.begin(), stationItems.end(),
-                              [](const QPair<QPair<double, int>, QString> &a, const QPair<QPair<double, int>, QString> &b) {
-                                  /**
-                                   * @brief Lambda porównująca elementy do sortowania po kluczu (ID lub odległość).
-                                   * @param a Pierwszy element (para klucz-ID i tekst).
-                                   * @param b Drugi element (para klucz-ID i tekst).
-                                   * @return Wartość logiczna określająca kolejność.
-                                   */
-                                  return a.first.first < b.first.first;
-                              });
-                }
-
-                // Dodaj posortowane elementy do listy
-                for (const auto &item : stationItems) {
-                    stationListWidget->addItem(item.second);
-                }
-
-                if (stationItems.isEmpty()) {
-                    QMessageBox::information(this, "Informacja", "Brak stacji w zadanym promieniu.");
-                }
+                const GeoPoint point{result["lat"].toString().toDouble(), result["lon"].toString().toDouble()};
+                geocodeCache.insert(location, point);
+                onLocationResolved(point);
             } else {
                 QMessageBox::warning(this, "Błąd", "Nieprawidłowe dane lokalizacji z Nominatim.");
             }
@@ -560,63 +606,323 @@ void MainWindow::onGeocodingReplyFinished(QNetworkReply *reply) {
 }
 
 /**
- * @brief Obsługuje kliknięcie elipsy na mapie.
- * @param stationId Identyfikator stacji powiązanej z elipsą.
- *
- * Wyświetla dane klikniętej stacji w trybie "Mapa Stacji".
+ * @brief Zapamiętuje wyznaczony punkt i pokazuje stacje wokół niego.
+ * @param point Współrzędne lokalizacji.
  */
-void MainWindow::onEllipseClicked(int stationId) {
-    if (currentMode == 2) { // Obsługa tylko w trybie "Mapa Stacji"
-        qDebug() << "Kliknięto kropkę stacji o ID:" << stationId;
+void MainWindow::onLocationResolved(const GeoPoint &point) {
+    userLat = point.lat;
+    userLon = point.lon;
+    geocodingDone = true;
+
+    if (showLocationResults() == 0) {
+        QMessageBox::information(this, "Informacja", queryModeComboBox->currentIndex() == 1
+                                                         ? "Brak stacji spełniających filtry."
+                                                         : "Brak stacji w zadanym promieniu.");
+    }
+}
 
-        // Znajdź stację w allStations, aby uzyskać dane
-        QString stationName, communeName, provinceName;
-        for (const QJsonValue &value : allStations) {
-            QJsonObject station = value.toObject();
-            if (station["id"].toInt() == stationId) {
-                stationName = station["stationName"].toString();
-                QJsonObject city = station["city"].toObject();
-                QJsonObject commune = city["commune"].toObject();
-                communeName = commune["communeName"].toString();
-                provinceName = commune["provinceName"].toString();
+/**
+ * @brief Wyszukuje stacje wokół geokodowanego punktu i pokazuje je na liście.
+ * @return Liczba pokazanych stacji.
+ *
+ * W trybie "W promieniu" zwracane są stacje w promieniu spełniające filtry. W trybie "N najbliższych"
+ * zapytanie jest powtarzane z podwojonym k, dopóki nie znajdzie się N stacji spełniających filtry
+ * (lub nie zostaną sprawdzone wszystkie stacje).
+ *
+ * Geokodowany punkt (userLat, userLon) jest zapamiętany, a zapytanie do indeksu przestrzennego trwa
+ * mikrosekundy, więc wywoływana jest przy każdej zmianie promienia, trybu zapytania lub filtrów.
+ * Odległości trafiają do modelu listy, który sortuje je lokalnie.
+ */
+int MainWindow::showLocationResults() {
+    QVector<StationSpatialIndex::Hit> hits;
+    if (queryModeComboBox->currentIndex() == 1) {
+        bool ok;
+        int count = radiusEdit->text().toInt(&ok);
+        if (!ok || count <= 0) {
+            count = 10;
+        }
+        // Wyniki przychodzą już posortowane według odległości
+        for (int k = count;; k *= 2) {
+            const QVector<StationSpatialIndex::Hit> nearest = spatialIndex.nearest(userLat, userLon, k);
+            hits.clear();
+            for (const StationSpatialIndex::Hit &hit : nearest) {
+                if (filterMask.testBit(hit.index) && hits.size() < count) {
+                    hits.append(hit);
+                }
+            }
+            if (hits.size() == count || nearest.size() < k || k >= spatialIndex.size()) {
                 break;
             }
         }
+    } else {
+        bool ok;
+        double radiusKm = radiusEdit->text().toDouble(&ok);
+        if (!ok || radiusKm <= 0) {
+            radiusKm = 10.0;
+        }
+        // Indeks przestrzenny sprawdza tylko stacje z komórek siatki w pobliżu punktu
+        for (const StationSpatialIndex::Hit &hit : spatialIndex.withinRadius(userLat, userLon, radiusKm)) {
+            if (filterMask.testBit(hit.index)) {
+                hits.append(hit);
+            }
+        }
+    }
 
-        qDebug() << "Wyodrębnione ID stacji:" << stationId << "Nazwa:" << stationName
-                 << "Gmina:" << communeName << "Województwo:" << provinceName;
-        onStationClicked(stationId, stationName, communeName, provinceName);
+    QVector<int> stations;
+    stations.reserve(hits.size());
+    for (const StationSpatialIndex::Hit &hit : hits) {
+        stations.append(hit.index);
     }
+    stationModel->setDistances(hits);
+    stationProxy->setStations(stations);
+    return hits.size();
 }
 
 /**
- * @brief Oblicza odległość między dwoma punktami geograficznymi.
- * @param lat1 Szerokość geograficzna pierwszego punktu.
- * @param lon1 Długość geograficzna pierwszego punktu.
- * @param lat2 Szerokość geograficzna drugiego punktu.
- * @param lon2 Długość geograficzna drugiego punktu.
- * @return Odległość w kilometrach.
+ * @brief Łączy wybrane filtry cech w mapę bitową stacji i odświeża listę oraz mapę.
  *
- * Używa wzoru haversine do obliczenia odległości na powierzchni Ziemi.
+ * Wartości wybrane w listach filtrów łączone są częścią wspólną (AND) lub sumą (OR) map bitowych
+ * z StationFacetIndex. Filtry bez wybranej wartości są pomijane.
  */
-double MainWindow::calculateDistance(double lat1, double lon1, double lat2, double lon2) {
-    const double R = 6371.0;
+void MainWindow::applyFilters() {
+    const bool matchAny = filterModeComboBox->currentIndex() == 1;
+    const QPair<QComboBox *, StationFacetIndex::Facet> filters[] = {
+        {provinceFilterComboBox, StationFacetIndex::Province},
+        {communeFilterComboBox, StationFacetIndex::Commune},
+        {parameterFilterComboBox, StationFacetIndex::Parameter},
+    };
+    QBitArray mask = facetIndex.allStations();
+    bool first = true;
+    for (const auto &filter : filters) {
+        if (filter.first->currentIndex() <= 0) {
+            continue;
+        }
+        const QBitArray selected = facetIndex.stations(filter.second, filter.first->currentText());
+        if (first) {
+            mask = selected;
+        } else if (matchAny) {
+            mask |= selected;
+        } else {
+            mask &= selected;
+        }
+        first = false;
+    }
+    filterMask = mask;
 
-    double lat1Rad = qDegreesToRadians(lat1);
-    double lon1Rad = qDegreesToRadians(lon1);
-    double lat2Rad = qDegreesToRadians(lat2);
-    double lon2Rad = qDegreesToRadians(lon2);
+    if (markerLayer) {
+        markerLayer->setVisibleStations(filterMask);
+    }
+    if (currentMode == 0) {
+        onSearchTextChanged(searchEdit->text());
+    } else if (currentMode == 1 && geocodingDone) {
+        showLocationResults();
+    }
+}
+
+/**
+ * @brief Wypełnia listę rozwijaną filtra wartościami cechy, zachowując bieżący wybór.
+ * @param comboBox Lista rozwijana filtra (pierwsza pozycja oznacza brak filtra).
+ * @param facet Cecha.
+ */
+void MainWindow::populateFilterComboBox(QComboBox *comboBox, StationFacetIndex::Facet facet) {
+    const QString allLabel = comboBox->itemText(0);
+    const QString current = comboBox->currentIndex() > 0 ? comboBox->currentText() : QString();
+    QSignalBlocker blocker(comboBox);
+    comboBox->clear();
+    comboBox->addItem(allLabel);
+    comboBox->addItems(facetIndex.values(facet));
+    comboBox->setCurrentIndex(qMax(0, comboBox->findText(current)));
+}
+
+/**
+ * @brief Pobiera w tle listy sensorów stacji, aby uzupełnić filtr parametrów.
+ * @param stations Indeksy stacji w katalogu.
+ *
+ * Stacje o znanych już parametrach (np. z otwartej karty stacji) są pomijane. Zapytania mają
+ * najniższy priorytet, a odpowiedzi są zapisywane w pamięci podręcznej (7 dni), więc po pierwszym
+ * uruchomieniu filtr parametrów nie wymaga połączenia z siecią.
+ */
+void MainWindow::requestStationParameters(const QVector<int> &stations) {
+    for (int i : stations) {
+        if (catalog.isRemoved(i) || facetIndex.hasParameters(i)) {
+            continue;
+        }
+        const int stationId = catalog.id(i);
+        giosClient->fetchSensors(stationId, this, [this, stationId](const GiosResult &result, const QVector<SensorDescriptor> &sensors) {
+            /**
+             * @brief Lambda dopisująca parametry stacji do indeksu cech.
+             * @param result Wynik zapytania.
+             * @param sensors Sensory stacji.
+             */
+            if (result.ok()) {
+                setStationSensors(stationId, sensors);
+            }
+        }, GiosClient::Prefetch);
+    }
+}
+
+/**
+ * @brief Zapisuje parametry i sensory stacji (z pobierania w tle lub z karty stacji).
+ * @param stationId Identyfikator stacji.
+ * @param sensors Sensory stacji.
+ *
+ * Filtry i mapa ciepła aktualizowane są z opóźnieniem (parametersTimer), więc seria odpowiedzi
+ * powoduje jedno grupowanie znaczników i jedno odświeżenie listy zamiast jednego na stację.
+ */
+void MainWindow::setStationSensors(int stationId, const QVector<SensorDescriptor> &sensors) {
+    const int index = catalog.indexOf(stationId);
+    if (index < 0) {
+        return; // Stacja mogła zostać usunięta przy odświeżeniu katalogu
+    }
+    for (const SensorDescriptor &sensor : sensors) {
+        parameterSensors[sensor.paramCode].insert(index, sensor.id);
+    }
+    parameterValuesChanged |= facetIndex.setParameters(index, sensors);
+    parametersTimer->start();
+}
+
+/**
+ * @brief Uwzględnia zebrane listy sensorów stacji w filtrze parametrów i mapie ciepła.
+ */
+void MainWindow::applyStationParameters() {
+    if (parameterValuesChanged) {
+        parameterValuesChanged = false;
+        populateFilterComboBox(parameterFilterComboBox, StationFacetIndex::Parameter);
+    }
+    if (heatmapComboBox->currentIndex() > 0) {
+        requestHeatmapData(heatmapComboBox->currentText());
+    }
+    // Nowo poznane parametry mogą zmienić wynik aktywnego filtra parametru
+    if (parameterFilterComboBox->currentIndex() > 0) {
+        applyFilters();
+    }
+}
+
+/**
+ * @brief Pobiera w tle indeksy jakości powietrza wszystkich stacji i koloruje nimi znaczniki.
+ *
+ * API nie udostępnia zbiorczego zapytania o indeksy, więc zapytania (po jednym na stację) trafiają
+ * do kolejki klienta z najniższym priorytetem, a odpowiedzi są zapisywane w pamięci podręcznej
+ * (20 minut). Warstwa znaczników przerysowuje tylko stacje, których klasa się zmieniła.
+ * Odświeżenie jest pomijane, dopóki poprzednie nie zostało zakończone.
+ */
+void MainWindow::requestStationIndexes() {
+    if (!markerLayer || pendingIndexRequests > 0) {
+        return;
+    }
+    for (int i = 0; i < catalog.size(); ++i) {
+        if (catalog.isRemoved(i)) {
+            continue;
+        }
+        const int stationId = catalog.id(i);
+        ++pendingIndexRequests;
+        giosClient->fetchIndex(stationId, this, [this, stationId](const GiosResult &result, const StationIndex &index) {
+            /**
+             * @brief Lambda ustawiająca klasę indeksu na znaczniku stacji.
+             * @param result Wynik zapytania.
+             * @param index Indeks jakości powietrza stacji.
+             */
+            --pendingIndexRequests;
+            if (!result.ok() || !markerLayer) {
+                return;
+            }
+            markerLayer->setStationBand(catalog.indexOf(stationId), index.level);
+        }, GiosClient::Prefetch);
+    }
+}
+
+/**
+ * @brief Pobiera pomiary sensorów parametru, które nie były pobierane lub są nieaktualne.
+ * @param paramCode Kod parametru.
+ *
+ * Pomiary sensora są pobierane ponownie po czasie ważności danych w pamięci podręcznej, a po
+ * nieudanym zapytaniu - przy następnym wywołaniu. Każdy nadchodzący szereg unieważnia zapamiętane
+ * mapy parametru; przeliczenie jest opóźniane (heatmapTimer), aby seria odpowiedzi dała jedno
+ * obliczenie zamiast wielu.
+ */
+void MainWindow::requestHeatmapData(const QString &paramCode) {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const QHash<int, int> sensors = parameterSensors.value(paramCode);
+    for (int sensorId : sensors) {
+        auto fetched = sensorFetchTimes.constFind(sensorId);
+        if (fetched != sensorFetchTimes.constEnd() && now - fetched.value() < GiosResponseCache::DataTimeToLive) {
+            continue;
+        }
+        sensorFetchTimes.insert(sensorId, now);
+        giosClient->fetchData(sensorId, this, [this, sensorId, paramCode](const GiosResult &result, SensorSeries &series) {
+            /**
+             * @brief Lambda zapamiętująca pomiary sensora i planująca przeliczenie mapy ciepła.
+             * @param result Wynik zapytania.
+             * @param series Szereg pomiarów sensora.
+             */
+            if (!result.ok()) {
+                sensorFetchTimes.remove(sensorId); // Ponowienie przy następnej aktualizacji mapy
+                return;
+            }
+            sensorSeries[sensorId] = std::move(series);
+            heatmapLayer->invalidate(paramCode);
+            heatmapTimer->start();
+        }, GiosClient::Table);
+    }
+}
+
+/**
+ * @brief Zwraca godzinę wybraną dla mapy ciepła.
+ * @return Początek godziny (sekundy od epoki).
+ */
+qint64 MainWindow::heatmapHour() const {
+    return (QDateTime::currentSecsSinceEpoch() / 3600 + heatmapHourSlider->value()) * 3600;
+}
 
-    double dLat = lat2Rad - lat1Rad;
-    double dLon = lon2Rad - lon1Rad;
+/**
+ * @brief Pokazuje mapę ciepła wybranego parametru dla wybranej godziny (lub ją ukrywa).
+ *
+ * Dla każdej stacji mierzącej parametr brany jest najnowszy pomiar z przedziału dwóch godzin
+ * kończącego się wybraną godziną (ostatnie pomiary bywają publikowane z opóźnieniem).
+ */
+void MainWindow::updateHeatmap() {
+    const qint64 hour = heatmapHour();
+    heatmapHourLabel->setText(QDateTime::fromSecsSinceEpoch(hour).toString("dd.MM HH:00"));
+    if (heatmapComboBox->currentIndex() <= 0) {
+        heatmapLayer->clearHeatmap();
+        return;
+    }
+    const QString paramCode = heatmapComboBox->currentText();
+    requestHeatmapData(paramCode);
+
+    QVector<HeatmapSample> samples;
+    const QHash<int, int> sensors = parameterSensors.value(paramCode);
+    for (auto it = sensors.constBegin(); it != sensors.constEnd(); ++it) {
+        auto series = sensorSeries.constFind(it.value());
+        if (series == sensorSeries.constEnd() || !projection.hasPosition(it.key())) {
+            continue;
+        }
+        for (int i = series->lowerBound(hour + 1) - 1; i >= 0 && series->timestamp(i) >= hour - 2 * 3600; --i) {
+            if (!series->isNull(i)) {
+                samples.append({projection.unitPosition(it.key()), series->value(i)});
+                break;
+            }
+        }
+    }
+    if (samples.isEmpty()) {
+        heatmapLayer->clearHeatmap(); // Pomiary jeszcze nie nadeszły lub brak danych dla tej godziny
+        return;
+    }
+    heatmapLayer->showHeatmap(paramCode, hour, samples);
+}
 
-    double a = qSin(dLat / 2) * qSin(dLat / 2) +
-               qCos(lat1Rad) * qCos(lat2Rad) *
-                   qSin(dLon / 2) * qSin(dLon / 2);
-    double c = 2 * qAtan2(qSqrt(a), qSqrt(1 - a));
-    double distance = R * c;
+/**
+ * @brief Obsługuje kliknięcie znacznika stacji na mapie.
+ * @param stationId Identyfikator stacji powiązanej ze znacznikiem.
+ *
+ * Wyświetla dane klikniętej stacji w trybie "Mapa Stacji".
+ */
+void MainWindow::onMarkerClicked(int stationId) {
+    if (currentMode == 2) { // Obsługa tylko w trybie "Mapa Stacji"
+        qDebug() << "Kliknięto kropkę stacji o ID:" << stationId;
 
-    return distance;
+        openStation(stationId);
+    }
 }
 
 /**
@@ -631,55 +937,96 @@ double MainWindow::calculateDistance(double lat1, double lon1, double lat2, doub
 void MainWindow::onStationClicked(int stationId, const QString &stationName, const QString &communeName, const QString &provinceName) {
     qDebug() << "Wywołano onStationClicked dla ID:" << stationId << "Nazwa:" << stationName
              << "Gmina:" << communeName << "Województwo:" << provinceName;
-    stationListWidget->setEnabled(false); // Wyłącz interakcję z listą stacji
+    stationListView->setEnabled(false); // Wyłącz interakcję z listą stacji
     infoCard->setVisible(true); // Pokaż kartę jako nakładkę
     infoCard->showStationData(stationId, stationName, communeName, provinceName);
 }
 
 /**
- * @brief Obsługuje aktywację stacji na liście.
- * @param item Wskaźnik do elementu listy.
+ * @brief Obsługuje kliknięcie lub aktywację stacji na liście.
+ * @param index Indeks wiersza w modelu pośrednim.
  *
- * Wyświetla dane aktywowanej stacji w trybie "Wybierz Stację" lub "Podaj Lokalizację".
+ * Wyświetla dane stacji w trybie "Wybierz Stację" lub "Podaj Lokalizację". Wiersz przechowuje indeks
+ * stacji w katalogu, więc nie jest potrzebne wyszukiwanie.
  */
-void MainWindow::onStationActivated(QListWidgetItem *item) {
-    if (currentMode == 0 || currentMode == 1) { // Obsługa w trybie "Wybierz Stację" i "Podaj Lokalizację"
-        QString text = item->text();
-        qDebug() << "Aktywowano stację:" << text;
-        int stationId = text.split(" - ").first().remove("ID: ").toInt();
-        QString stationName = text.split(" - ").last().split(" (").first(); // Wyodrębnij nazwę stacji
-
-        // Znajdź stację w allStations, aby uzyskać communeName i provinceName
-        QString communeName, provinceName;
-        for (const QJsonValue &value : allStations) {
-            QJsonObject station = value.toObject();
-            if (station["id"].toInt() == stationId) {
-                QJsonObject city = station["city"].toObject();
-                QJsonObject commune = city["commune"].toObject();
-                communeName = commune["communeName"].toString();
-                provinceName = commune["provinceName"].toString();
-                break;
-            }
-        }
+void MainWindow::onStationActivated(const QModelIndex &index) {
+    if (index.isValid() && (currentMode == 0 || currentMode == 1)) { // Obsługa w trybie "Wybierz Stację" i "Podaj Lokalizację"
+        const int stationIndex = index.data(StationListModel::StationIndexRole).toInt();
+        qDebug() << "Wybrano stację:" << index.data().toString();
+        openStationAt(stationIndex);
+    }
+}
 
-        qDebug() << "Wyodrębnione ID stacji:" << stationId << "Nazwa:" << stationName
-                 << "Gmina:" << communeName << "Województwo:" << provinceName;
-        onStationClicked(stationId, stationName, communeName, provinceName);
+/**
+ * @brief Otwiera kartę stacji na podstawie jej identyfikatora.
+ * @param stationId Identyfikator stacji.
+ *
+ * Indeks stacji odczytywany jest z katalogu (wyszukiwanie w czasie O(1)).
+ */
+void MainWindow::openStation(int stationId) {
+    int index = catalog.indexOf(stationId);
+    if (index < 0) {
+        qDebug() << "Nie znaleziono stacji o ID:" << stationId;
+        return;
     }
+    openStationAt(index);
+}
+
+/**
+ * @brief Otwiera kartę stacji o podanym indeksie w katalogu.
+ * @param index Indeks stacji w katalogu.
+ *
+ * Nazwę, gminę i województwo pobiera bezpośrednio z kolumn katalogu.
+ */
+void MainWindow::openStationAt(int index) {
+    const int stationId = catalog.id(index);
+    qDebug() << "Wyodrębnione ID stacji:" << stationId << "Nazwa:" << catalog.name(index)
+             << "Gmina:" << catalog.commune(index) << "Województwo:" << catalog.province(index);
+    onStationClicked(stationId, catalog.name(index), catalog.commune(index), catalog.province(index));
 }
 
 /**
- * @brief Obsługuje kliknięcie przycisku wczytywania pliku JSON.
+ * @brief Obsługuje kliknięcie przycisku wczytywania pliku z danymi.
  *
- * Otwiera okno dialogowe do wyboru pliku JSON i wyświetla dane stacji z pliku.
+ * Otwiera okno dialogowe do wyboru archiwum (lub starszego pliku JSON) i wyświetla dane stacji z pliku.
  */
 void MainWindow::onLoadFileButtonClicked() {
-    QString fileName = QFileDialog::getOpenFileName(this, tr("Otwórz plik JSON"), QCoreApplication::applicationDirPath(), tr("Pliki JSON (*.json)"));
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Otwórz plik z danymi"), QCoreApplication::applicationDirPath() + "/data",
+                                                    tr("Archiwa GIOŚ (*.gios);;Pliki JSON (*.json)"));
     if (fileName.isEmpty()) {
         qDebug() << "Odczyt anulowany przez użytkownika.";
         return;
     }
 
+    if (!fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        // Archiwum jest mapowane do pamięci; odczytywany jest tylko indeks, a dane sensorów dopiero na żądanie
+        auto archive = std::make_shared<StationArchiveReader>();
+        if (!archive->open(fileName)) {
+            QMessageBox::warning(this, tr("Błąd"), tr("Nie można otworzyć pliku: %1").arg(archive->errorString()));
+            return;
+        }
+        if (archive->stations().isEmpty()) {
+            QMessageBox::warning(this, tr("Błąd"), tr("Plik nie zawiera żadnych stacji."));
+            return;
+        }
+
+        QStringList labels;
+        for (const ArchivedStation &station : archive->stations()) {
+            labels.append(QString("%1 (%2)").arg(station.stationName, station.location));
+        }
+        int stationIndex = chooseStation(labels);
+        if (stationIndex < 0) {
+            return;
+        }
+
+        // Wyłącz interakcję z listą stacji
+        stationListView->setEnabled(false);
+        // Pokaż kartę z danymi z pliku
+        infoCard->setVisible(true);
+        infoCard->showDataFromArchive(archive, stationIndex);
+        return;
+    }
+
     QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly)) {
         QMessageBox::warning(this, tr("Błąd"), tr("Nie można otworzyć pliku: %1").arg(file.errorString()));
@@ -707,8 +1054,17 @@ void MainWindow::onLoadFileButtonClicked() {
         return;
     }
 
-    // Pobierz pierwszą stację z pliku
-    QJsonObject stationObj = stationsArray[0].toObject();
+    // Pozwól wybrać stację, jeśli plik zawiera ich kilka
+    QStringList labels;
+    for (const QJsonValue &stationValue : stationsArray) {
+        QJsonObject station = stationValue.toObject();
+        labels.append(QString("%1 (%2)").arg(station["stationName"].toString(), station["location"].toString()));
+    }
+    int stationIndex = chooseStation(labels);
+    if (stationIndex < 0) {
+        return;
+    }
+    QJsonObject stationObj = stationsArray[stationIndex].toObject();
     QString stationName = stationObj["stationName"].toString();
     QString location = stationObj["location"].toString();
     QJsonArray sensorsArray = stationObj["sensors"].toArray();
@@ -719,8 +1075,39 @@ void MainWindow::onLoadFileButtonClicked() {
     }
 
     // Wyłącz interakcję z listą stacji
-    stationListWidget->setEnabled(false);
+    stationListView->setEnabled(false);
     // Pokaż kartę z danymi z pliku
     infoCard->setVisible(true);
     infoCard->showDataFromFile(stationName, location, sensorsArray);
 }
+
+/**
+ * @brief Pozwala wybrać jedną ze stacji zapisanych w pliku.
+ * @param labels Opisy stacji.
+ * @return Indeks wybranej stacji lub -1, jeśli wybór anulowano.
+ *
+ * Przy jednej stacji okno wyboru nie jest pokazywane.
+ */
+int MainWindow::chooseStation(const QStringList &labels) {
+    if (labels.size() == 1) {
+        return 0;
+    }
+    // Opisy stacji nie muszą być unikalne, więc wynikiem jest pozycja na liście, a nie wybrany tekst
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Wybierz stację"));
+    QVBoxLayout *dialogLayout = new QVBoxLayout(&dialog);
+    dialogLayout->addWidget(new QLabel(tr("Stacje zapisane w pliku:"), &dialog));
+    QComboBox *stationComboBox = new QComboBox(&dialog);
+    stationComboBox->addItems(labels);
+    dialogLayout->addWidget(stationComboBox);
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    dialogLayout->addWidget(buttons);
+
+    if (dialog.exec() != QDialog::Accepted) {
+        qDebug() << "Wybór stacji anulowany przez użytkownika.";
+        return -1;
+    }
+    return stationComboBox->currentIndex();
+}
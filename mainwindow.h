@@ -9,16 +9,31 @@
 #include <QMainWindow>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
-#include <QListWidget>
+#include <QListView>
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QComboBox>
+#include <QHash>
+#include <QSlider>
+#include <QTimer>
+#include "basemapitem.h"
 #include "custombutton.h"
+#include "geocodecache.h"
+#include "heatmaplayer.h"
+#include "mapprojection.h"
 #include "stationinfocard.h"
-#include "clickableellipseitem.h"
+#include "stationcatalog.h"
+#include "stationfacetindex.h"
+#include "stationlistmodel.h"
+#include "stationmapview.h"
+#include "stationmarkerlayer.h"
+#include "stationspatialindex.h"
+#include "stationtextindex.h"
+#include "giosstreamparsers.h"
+#include "giosclient.h"
 
 /**
  * @class MainWindow
@@ -41,11 +56,6 @@ public:
     ~MainWindow();
 
 private slots:
-    /**
-     * @brief Obsługuje zakończenie odpowiedzi HTTP z API.
-     * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
-     */
-    void onReplyFinished(QNetworkReply *reply);
     /**
      * @brief Obsługuje zmianę tekstu w polu wyszukiwania.
      * @param text Nowy tekst w polu wyszukiwania.
@@ -62,8 +72,9 @@ private slots:
     /**
      * @brief Obsługuje odpowiedź geokodowania z API Nominatim.
      * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
+     * @param location Geokodowany tekst lokalizacji.
      */
-    void onGeocodingReplyFinished(QNetworkReply *reply);
+    void onGeocodingReplyFinished(QNetworkReply *reply, const QString &location);
     /**
      * @brief Obsługuje kliknięcie stacji na liście lub mapie.
      * @param stationId Identyfikator stacji.
@@ -73,52 +84,159 @@ private slots:
      */
     void onStationClicked(int stationId, const QString &stationName, const QString &communeName, const QString &provinceName);
     /**
-     * @brief Obsługuje aktywację stacji na liście.
-     * @param item Wskaźnik do elementu listy.
+     * @brief Obsługuje kliknięcie lub aktywację stacji na liście.
+     * @param index Indeks wiersza w modelu pośrednim.
      */
-    void onStationActivated(QListWidgetItem *item);
+    void onStationActivated(const QModelIndex &index);
     /**
-     * @brief Obsługuje kliknięcie przycisku wczytywania pliku JSON.
+     * @brief Obsługuje kliknięcie przycisku wczytywania pliku z danymi (archiwum lub JSON).
      */
     void onLoadFileButtonClicked();
     /**
-     * @brief Obsługuje kliknięcie elipsy na mapie.
-     * @param stationId Identyfikator stacji powiązanej z elipsą.
+     * @brief Obsługuje kliknięcie znacznika stacji na mapie.
+     * @param stationId Identyfikator stacji powiązanej ze znacznikiem.
+     */
+    void onMarkerClicked(int stationId);
+    /**
+     * @brief Łączy wybrane filtry cech w mapę bitową stacji i odświeża listę oraz mapę.
      */
-    void onEllipseClicked(int stationId);
+    void applyFilters();
+    /**
+     * @brief Pokazuje mapę ciepła wybranego parametru dla wybranej godziny (lub ją ukrywa).
+     */
+    void updateHeatmap();
+    /**
+     * @brief Pobiera w tle indeksy jakości powietrza wszystkich stacji i koloruje nimi znaczniki.
+     */
+    void requestStationIndexes();
+    /**
+     * @brief Pobiera z serwera aktualną listę stacji (z pominięciem pamięci podręcznej).
+     */
+    void refreshCatalog();
+    /**
+     * @brief Uwzględnia zebrane listy sensorów stacji w filtrze parametrów i mapie ciepła.
+     */
+    void applyStationParameters();
 
 private:
+    /**
+     * @brief Obsługuje zakończenie pobierania listy stacji z API.
+     * @param result Wynik zapytania.
+     * @param loaded Katalog zbudowany przez parser strumieniowy.
+     */
+    void onReplyFinished(const GiosResult &result, StationCatalog &loaded);
+    /**
+     * @brief Uzgadnia katalog z odświeżoną listą stacji, aktualizując tylko zmienione stacje.
+     * @param result Wynik zapytania.
+     * @param loaded Nowa wersja katalogu.
+     */
+    void onCatalogRefreshed(const GiosResult &result, StationCatalog &loaded);
     /**
      * @brief Wykonuje geokodowanie podanej lokalizacji.
      * @param location Nazwa lokalizacji do geokodowania.
      */
     void geocodeLocation(const QString &location);
     /**
-     * @brief Oblicza odległość między dwoma punktami geograficznymi.
-     * @param lat1 Szerokość geograficzna pierwszego punktu.
-     * @param lon1 Długość geograficzna pierwszego punktu.
-     * @param lat2 Szerokość geograficzna drugiego punktu.
-     * @param lon2 Długość geograficzna drugiego punktu.
-     * @return Odległość w kilometrach.
+     * @brief Zapamiętuje wyznaczony punkt i pokazuje stacje wokół niego.
+     * @param point Współrzędne lokalizacji.
+     */
+    void onLocationResolved(const GeoPoint &point);
+    /**
+     * @brief Otwiera kartę stacji na podstawie jej identyfikatora.
+     * @param stationId Identyfikator stacji.
+     *
+     * Nazwę, gminę i województwo pobiera z katalogu stacji.
+     */
+    void openStation(int stationId);
+    /**
+     * @brief Otwiera kartę stacji o podanym indeksie w katalogu.
+     * @param index Indeks stacji w katalogu.
+     */
+    void openStationAt(int index);
+    /**
+     * @brief Pozwala wybrać jedną ze stacji zapisanych w pliku.
+     * @param labels Opisy stacji.
+     * @return Indeks wybranej stacji lub -1, jeśli wybór anulowano.
+     */
+    int chooseStation(const QStringList &labels);
+    /**
+     * @brief Wyszukuje stacje wokół geokodowanego punktu i pokazuje je na liście.
+     * @return Liczba pokazanych stacji.
+     */
+    int showLocationResults();
+    /**
+     * @brief Wypełnia listę rozwijaną filtra wartościami cechy, zachowując bieżący wybór.
+     * @param comboBox Lista rozwijana filtra.
+     * @param facet Cecha.
+     */
+    void populateFilterComboBox(QComboBox *comboBox, StationFacetIndex::Facet facet);
+    /**
+     * @brief Pobiera w tle listy sensorów stacji, aby uzupełnić filtr parametrów.
+     * @param stations Indeksy stacji w katalogu.
+     */
+    void requestStationParameters(const QVector<int> &stations);
+    /**
+     * @brief Zapisuje parametry i sensory stacji (z pobierania w tle lub z karty stacji).
+     * @param stationId Identyfikator stacji.
+     * @param sensors Sensory stacji.
+     */
+    void setStationSensors(int stationId, const QVector<SensorDescriptor> &sensors);
+    /**
+     * @brief Pobiera pomiary wszystkich sensorów parametru, które nie były jeszcze pobierane.
+     * @param paramCode Kod parametru.
+     */
+    void requestHeatmapData(const QString &paramCode);
+    /**
+     * @brief Zwraca godzinę wybraną dla mapy ciepła.
+     * @return Początek godziny (sekundy od epoki).
      */
-    double calculateDistance(double lat1, double lon1, double lat2, double lon2);
+    qint64 heatmapHour() const;
 
-    QNetworkAccessManager *networkManager; ///< Menadżer sieci do zapytań HTTP.
-    QListWidget *stationListWidget; ///< Lista stacji pogodowych.
-    QGraphicsView *mapView; ///< Widok mapy.
+    GiosClient *giosClient; ///< Wspólny klient API GIOŚ (jedyny menadżer sieci aplikacji).
+    StationListModel *stationModel; ///< Model listy stacji nad katalogiem.
+    StationFilterProxyModel *stationProxy; ///< Model pośredni wybierający i sortujący pokazywane stacje.
+    QListView *stationListView; ///< Lista stacji pogodowych.
+    StationMapView *mapView; ///< Widok mapy (przybliżanie i przesuwanie).
     QGraphicsScene *mapScene; ///< Scena mapy.
+    BasemapItem *basemapItem; ///< Podkład mapy (należy do sceny).
+    HeatmapLayer *heatmapLayer; ///< Mapa ciepła pod znacznikami stacji (należy do sceny).
+    QComboBox *heatmapComboBox; ///< Wybór parametru mapy ciepła.
+    QSlider *heatmapHourSlider; ///< Wybór godziny mapy ciepła (liczba godzin wstecz, ze znakiem minus).
+    QLabel *heatmapHourLabel; ///< Opis wybranej godziny mapy ciepła.
+    QTimer *heatmapTimer; ///< Opóźnia przeliczenie mapy ciepła, gdy pomiary napływają seriami.
+    QTimer *indexTimer; ///< Okresowe odświeżanie indeksów jakości powietrza stacji i mapy ciepła.
+    int pendingIndexRequests = 0; ///< Liczba trwających zapytań o indeksy (odświeżenia się nie nakładają).
+    QTimer *catalogTimer; ///< Okresowe odświeżanie listy stacji.
+    QTimer *parametersTimer; ///< Łączy listy sensorów napływające seriami w jedną aktualizację filtrów.
+    bool parameterValuesChanged = false; ///< Czy od ostatniej aktualizacji pojawił się nowy kod parametru.
+    MapProjection projection; ///< Odwzorowanie mapy z pozycjami stacji katalogu.
     CustomButton *titleButton; ///< Przycisk tytułu okna.
     QLabel *iconLabel; ///< Etykieta ikony.
     QLineEdit *searchEdit; ///< Pole wyszukiwania.
-    QLineEdit *radiusEdit; ///< Pole promienia wyszukiwania.
+    QLineEdit *radiusEdit; ///< Pole promienia wyszukiwania (lub liczby stacji w trybie N najbliższych).
+    QComboBox *queryModeComboBox; ///< Lista rozwijana trybu zapytania (promień / N najbliższych).
     QPushButton *searchButton; ///< Przycisk wyszukiwania.
     QComboBox *sortComboBox; ///< Lista rozwijana sortowania.
+    QComboBox *provinceFilterComboBox; ///< Filtr województwa.
+    QComboBox *communeFilterComboBox; ///< Filtr gminy.
+    QComboBox *parameterFilterComboBox; ///< Filtr mierzonego parametru.
+    QComboBox *filterModeComboBox; ///< Sposób łączenia filtrów (AND / OR).
     QPushButton *loadFileButton; ///< Przycisk wczytywania pliku.
     StationInfoCard *infoCard; ///< Karta informacyjna stacji.
-    QJsonArray allStations; ///< Tablica wszystkich stacji z API.
+    StationCatalog catalog; ///< Katalog wszystkich stacji z API.
+    StationSpatialIndex spatialIndex; ///< Indeks przestrzenny współrzędnych stacji z katalogu.
+    StationTextIndex textIndex; ///< Indeks wyszukiwania stacji po nazwie miejscowości lub stacji.
+    GeocodeCache geocodeCache; ///< Trwała pamięć podręczna wyników geokodowania.
+    OfflineGazetteer gazetteer; ///< Spis miejscowości i gmin z katalogu (geokodowanie bez sieci).
+    StationFacetIndex facetIndex; ///< Indeksy bitowe stacji według województwa, gminy i parametru.
+    QBitArray filterMask; ///< Stacje spełniające wybrane filtry.
+    QHash<QString, QHash<int, int>> parameterSensors; ///< Kod parametru → (indeks stacji → ID sensora).
+    QHash<int, SensorSeries> sensorSeries; ///< Pobrane pomiary sensorów (ID sensora → szereg).
+    QHash<int, qint64> sensorFetchTimes; ///< Czas zapytania o pomiary sensora (ID sensora → sekundy od epoki).
+    StationMarkerLayer *markerLayer = nullptr; ///< Warstwa znaczników stacji na mapie (należy do sceny).
     int currentMode; ///< Aktualny tryb aplikacji (0: Wybierz Stację, 1: Podaj Lokalizację, 2: Mapa Stacji).
     bool geocodingDone; ///< Flaga wskazująca, czy geokodowanie zakończone.
-    QString sortMode; ///< Tryb sortowania listy stacji.
+    QString geocodedLocation; ///< Tekst lokalizacji, dla którego wyznaczono userLat/userLon.
     double userLat; ///< Szerokość geograficzna użytkownika.
     double userLon; ///< Długość geograficzna użytkownika.
 };
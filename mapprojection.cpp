@@ -0,0 +1,67 @@
+/**
+ * @file mapprojection.cpp
+ * @brief Implementacja odwzorowania mapy Polski.
+ */
+
+#include "mapprojection.h"
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Tworzy odwzorowanie dla zasięgu obrazu mapy Polski.
+ */
+MapProjection::MapProjection() : mercatorTop(mercatorY(LatMax)), mercatorBottom(mercatorY(LatMin)) {
+}
+
+/**
+ * @brief Przelicza punkt geograficzny na punkt mapy.
+ * @param lat Szerokość geograficzna (stopnie).
+ * @param lon Długość geograficzna (stopnie).
+ * @return Punkt we współrzędnych sceny.
+ */
+QPointF MapProjection::project(double lat, double lon) const {
+    const QPointF unit = unitPoint(lat, lon);
+    return QPointF(target.left() + unit.x() * target.width(), target.top() + unit.y() * target.height());
+}
+
+/**
+ * @brief Wyznacza i zapamiętuje pozycje stacji katalogu.
+ * @param catalog Katalog stacji.
+ */
+void MapProjection::setCatalog(const StationCatalog &catalog) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    unitPositions.resize(catalog.size());
+    for (int i = 0; i < catalog.size(); ++i) {
+        unitPositions[i] = catalog.hasCoordinates(i) ? unitPoint(catalog.latitude(i), catalog.longitude(i)) : QPointF(nan, nan);
+    }
+}
+
+/**
+ * @brief Zwraca zapamiętaną pozycję stacji.
+ * @param index Indeks stacji w katalogu.
+ * @return Punkt we współrzędnych sceny.
+ */
+QPointF MapProjection::position(int index) const {
+    const QPointF &unit = unitPositions[index];
+    return QPointF(target.left() + unit.x() * target.width(), target.top() + unit.y() * target.height());
+}
+
+/**
+ * @brief Oblicza współrzędną Y odwzorowania Merkatora (bez promienia Ziemi).
+ * @param lat Szerokość geograficzna (stopnie).
+ * @return ln(tan(π/4 + φ/2)).
+ */
+double MapProjection::mercatorY(double lat) {
+    return std::log(std::tan(M_PI / 4 + qDegreesToRadians(lat) / 2));
+}
+
+/**
+ * @brief Przelicza punkt geograficzny na punkt jednostkowego kwadratu obrazu.
+ * @param lat Szerokość geograficzna (stopnie).
+ * @param lon Długość geograficzna (stopnie).
+ * @return Punkt (0, 0) - lewy górny róg, (1, 1) - prawy dolny róg obrazu.
+ */
+QPointF MapProjection::unitPoint(double lat, double lon) const {
+    return QPointF((lon - LonMin) / (LonMax - LonMin), (mercatorTop - mercatorY(lat)) / (mercatorTop - mercatorBottom));
+}
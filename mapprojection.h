@@ -0,0 +1,101 @@
+/**
+ * @file mapprojection.h
+ * @brief Odwzorowanie Merkatora dla mapy Polski z zapamiętanymi pozycjami stacji.
+ */
+
+#ifndef MAPPROJECTION_H
+#define MAPPROJECTION_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QtNumeric>
+#include <QVector>
+#include "stationcatalog.h"
+
+/**
+ * @class MapProjection
+ * @brief Przelicza współrzędne geograficzne na punkty obrazu mapy (odwzorowanie Merkatora).
+ *
+ * Zasięg geograficzny obrazu jest stały (skrajne punkty Polski), więc położenie stacji nie zależy
+ * od tego, które stacje są w katalogu. Pozycje stacji katalogu w jednostkowym kwadracie obrazu
+ * wyznaczane są raz (setCatalog()); zmiana prostokąta mapy wymaga tylko przeskalowania, bez
+ * ponownego liczenia logarytmów i tangensów.
+ */
+class MapProjection {
+public:
+    static constexpr double LonMin = 14.1229; ///< Zachodnia krawędź obrazu mapy (stopnie).
+    static constexpr double LonMax = 24.1458; ///< Wschodnia krawędź obrazu mapy (stopnie).
+    static constexpr double LatMin = 49.0020; ///< Południowa krawędź obrazu mapy (stopnie).
+    static constexpr double LatMax = 54.8358; ///< Północna krawędź obrazu mapy (stopnie).
+
+    /**
+     * @brief Tworzy odwzorowanie dla zasięgu obrazu mapy Polski.
+     */
+    MapProjection();
+
+    /**
+     * @brief Ustawia prostokąt, w którym rysowany jest obraz mapy.
+     * @param rect Prostokąt obrazu we współrzędnych sceny.
+     */
+    void setTargetRect(const QRectF &rect) { target = rect; }
+    /**
+     * @brief Zwraca prostokąt, w którym rysowany jest obraz mapy.
+     * @return Prostokąt obrazu we współrzędnych sceny.
+     */
+    QRectF targetRect() const { return target; }
+
+    /**
+     * @brief Przelicza punkt geograficzny na punkt mapy.
+     * @param lat Szerokość geograficzna (stopnie).
+     * @param lon Długość geograficzna (stopnie).
+     * @return Punkt we współrzędnych sceny.
+     */
+    QPointF project(double lat, double lon) const;
+
+    /**
+     * @brief Wyznacza i zapamiętuje pozycje stacji katalogu.
+     * @param catalog Katalog stacji.
+     */
+    void setCatalog(const StationCatalog &catalog);
+    /**
+     * @brief Sprawdza, czy stacja ma zapamiętaną pozycję.
+     * @param index Indeks stacji w katalogu.
+     * @return true, jeśli stacja ma współrzędne.
+     */
+    bool hasPosition(int index) const { return index >= 0 && index < unitPositions.size() && !qIsNaN(unitPositions[index].x()); }
+    /**
+     * @brief Zwraca zapamiętaną pozycję stacji.
+     * @param index Indeks stacji w katalogu.
+     * @return Punkt we współrzędnych sceny.
+     */
+    QPointF position(int index) const;
+    /**
+     * @brief Zwraca zapamiętaną pozycję stacji w jednostkowym kwadracie obrazu.
+     * @param index Indeks stacji w katalogu.
+     * @return Punkt (0, 0) - lewy górny róg, (1, 1) - prawy dolny róg obrazu.
+     */
+    QPointF unitPosition(int index) const { return unitPositions[index]; }
+
+    /**
+     * @brief Oblicza współrzędną Y odwzorowania Merkatora (bez promienia Ziemi).
+     * @param lat Szerokość geograficzna (stopnie).
+     * @return ln(tan(π/4 + φ/2)).
+     */
+    static double mercatorY(double lat);
+
+private:
+    /**
+     * @brief Przelicza punkt geograficzny na punkt jednostkowego kwadratu obrazu.
+     * @param lat Szerokość geograficzna (stopnie).
+     * @param lon Długość geograficzna (stopnie).
+     * @return Punkt (0, 0) - lewy górny róg, (1, 1) - prawy dolny róg obrazu.
+     */
+    QPointF unitPoint(double lat, double lon) const;
+
+    double mercatorTop; ///< Współrzędna Merkatora północnej krawędzi.
+    double mercatorBottom; ///< Współrzędna Merkatora południowej krawędzi.
+    QRectF target; ///< Prostokąt obrazu we współrzędnych sceny.
+    QVector<QPointF> unitPositions; ///< Pozycje stacji w jednostkowym kwadracie (NaN bez współrzędnych).
+};
+
+#endif // MAPPROJECTION_H
@@ -0,0 +1,224 @@
+/**
+ * @file sensorseries.cpp
+ * @brief Implementacja klasy SensorSeries aplikacji GIOSrevamp.
+ */
+
+#include "sensorseries.h"
+#include "giostime.h"
+#include <QJsonObject>
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Tworzy szereg z tablicy obiektów @c {date, value} w formacie API GIOŚ.
+ * @param values Tablica pomiarów (w dowolnej kolejności, zwykle od najnowszego).
+ * @return Posortowany szereg czasowy.
+ *
+ * Daty są parsowane hurtowo (GiosTime::parseColumn); obiekty bez pola @c date lub z nieprawidłową datą są pomijane.
+ */
+SensorSeries SensorSeries::fromJson(const QJsonArray &values) {
+    QStringList dates;
+    QVector<QJsonValue> entryValues;
+    dates.reserve(values.size());
+    entryValues.reserve(values.size());
+
+    for (const QJsonValue &entry : values) {
+        QJsonObject valueObj = entry.toObject();
+        if (!valueObj.contains("date") || !valueObj.contains("value")) {
+            continue;
+        }
+        dates.append(valueObj["date"].toString());
+        entryValues.append(valueObj["value"]);
+    }
+
+    QVector<qint64> timestamps;
+    QVector<bool> valid;
+    GiosTime::parseColumn(dates, &timestamps, &valid);
+
+    SensorSeries series;
+    series.reserve(dates.size());
+    for (int i = 0; i < dates.size(); ++i) {
+        if (!valid[i]) {
+            continue;
+        }
+        const QJsonValue &value = entryValues[i];
+        series.append(timestamps[i], float(value.toDouble()), value.isNull());
+    }
+
+    series.sortByTime();
+    return series;
+}
+
+/**
+ * @brief Zamienia szereg na tablicę obiektów @c {date, value} (od najnowszego pomiaru).
+ * @return Tablica JSON zgodna z formatem zapisu plików danych.
+ */
+QJsonArray SensorSeries::toJson() const {
+    QJsonArray values;
+    const QByteArray dates = GiosTime::formatColumn(times);
+    for (int i = times.size() - 1; i >= 0; --i) {
+        QJsonObject valueObj;
+        valueObj["date"] = QString::fromLatin1(dates.constData() + i * GiosTime::TextLength, GiosTime::TextLength);
+        valueObj["value"] = isNull(i) ? QJsonValue(QJsonValue::Null) : QJsonValue(double(vals[i]));
+        values.append(valueObj);
+    }
+    return values;
+}
+
+/**
+ * @brief Usuwa wszystkie punkty.
+ */
+void SensorSeries::clear() {
+    times.clear();
+    vals.clear();
+    nullBits.clear();
+}
+
+/**
+ * @brief Rezerwuje miejsce na podaną liczbę punktów.
+ * @param count Oczekiwana liczba punktów.
+ */
+void SensorSeries::reserve(int count) {
+    times.reserve(count);
+    vals.reserve(count);
+    nullBits.reserve((count + 63) / 64);
+}
+
+/**
+ * @brief Dodaje punkt na koniec szeregu bez sortowania.
+ * @param timestamp Czas pomiaru w sekundach od epoki.
+ * @param value Wartość pomiaru (ignorowana, gdy isNull).
+ * @param isNull Czy pomiar jest brakujący.
+ */
+void SensorSeries::append(qint64 timestamp, float value, bool isNull) {
+    int index = times.size();
+    times.append(timestamp);
+    vals.append(isNull ? 0.0f : value);
+    if ((index & 63) == 0) {
+        nullBits.append(0);
+    }
+    setNull(index, isNull);
+}
+
+/**
+ * @brief Wstawia punkt z zachowaniem porządku; istniejący punkt o tym samym czasie jest nadpisywany.
+ * @param timestamp Czas pomiaru w sekundach od epoki.
+ * @param value Wartość pomiaru.
+ * @param isNull Czy pomiar jest brakujący.
+ *
+ * Najczęstszy przypadek (punkt nowszy od wszystkich) kosztuje O(1); wstawienie w środek przesuwa
+ * dalsze punkty i bity braku o jedną pozycję, bez ponownego sortowania.
+ */
+void SensorSeries::insert(qint64 timestamp, float value, bool isNull) {
+    if (times.isEmpty() || timestamp > times.last()) {
+        append(timestamp, value, isNull);
+        return;
+    }
+
+    const int index = lowerBound(timestamp);
+    if (times[index] == timestamp) {
+        vals[index] = isNull ? 0.0f : value;
+        setNull(index, isNull);
+        return;
+    }
+
+    times.insert(index, timestamp);
+    vals.insert(index, isNull ? 0.0f : value);
+    if (((times.size() - 1) & 63) == 0) {
+        nullBits.append(0);
+    }
+
+    // Przesuń bity od index w górę o jeden, przenosząc najstarszy bit każdego słowa do następnego
+    const int word = index >> 6;
+    for (int w = nullBits.size() - 1; w > word; --w) {
+        nullBits[w] = (nullBits[w] << 1) | (nullBits[w - 1] >> 63);
+    }
+    const quint64 lowMask = (quint64(1) << (index & 63)) - 1;
+    nullBits[word] = (nullBits[word] & lowMask) | ((nullBits[word] & ~lowMask) << 1);
+    setNull(index, isNull);
+}
+
+/**
+ * @brief Scala inny szereg z bieżącym; przy równych czasach wygrywają punkty z other.
+ * @param other Szereg do scalenia.
+ */
+void SensorSeries::merge(const SensorSeries &other) {
+    reserve(size() + other.size());
+    for (int i = 0; i < other.size(); ++i) {
+        append(other.times[i], other.vals[i], other.isNull(i));
+    }
+    sortByTime();
+}
+
+/**
+ * @brief Sortuje punkty rosnąco po czasie i usuwa duplikaty (zostaje ostatnio dodany).
+ */
+void SensorSeries::sortByTime() {
+    const int count = times.size();
+    bool sorted = true;
+    bool reversed = true;
+    for (int i = 1; i < count && (sorted || reversed); ++i) {
+        sorted = sorted && times[i - 1] < times[i];
+        reversed = reversed && times[i - 1] > times[i];
+    }
+    if (sorted) {
+        return;
+    }
+    if (reversed) {
+        // API GIOŚ zwraca pomiary od najnowszych - wystarczy odwrócić kolejność
+        SensorSeries reversedSeries;
+        reversedSeries.reserve(count);
+        for (int i = count - 1; i >= 0; --i) {
+            reversedSeries.append(times[i], vals[i], isNull(i));
+        }
+        *this = reversedSeries;
+        return;
+    }
+
+    QVector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        /**
+         * @brief Lambda porównująca punkty po czasie.
+         * @param a Indeks pierwszego punktu.
+         * @param b Indeks drugiego punktu.
+         * @return Wartość logiczna określająca kolejność.
+         */
+        return times[a] < times[b];
+    });
+
+    SensorSeries sortedSeries;
+    sortedSeries.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        int i = order[k];
+        // Przy równych czasach zostaje punkt dodany najpóźniej (ostatni w stabilnym porządku)
+        if (k + 1 < count && times[order[k + 1]] == times[i]) {
+            continue;
+        }
+        sortedSeries.append(times[i], vals[i], isNull(i));
+    }
+    *this = sortedSeries;
+}
+
+/**
+ * @brief Zwraca indeks pierwszego punktu o czasie >= timestamp.
+ * @param timestamp Czas w sekundach od epoki.
+ * @return Indeks w przedziale [0, size()].
+ */
+int SensorSeries::lowerBound(qint64 timestamp) const {
+    return int(std::lower_bound(times.cbegin(), times.cend(), timestamp) - times.cbegin());
+}
+
+/**
+ * @brief Ustawia bit braku dla punktu.
+ * @param index Indeks punktu.
+ * @param isNull Wartość bitu.
+ */
+void SensorSeries::setNull(int index, bool isNull) {
+    const quint64 mask = quint64(1) << (index & 63);
+    if (isNull) {
+        nullBits[index >> 6] |= mask;
+    } else {
+        nullBits[index >> 6] &= ~mask;
+    }
+}
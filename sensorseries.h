@@ -0,0 +1,101 @@
+/**
+ * @file sensorseries.h
+ * @brief Kolumnowy szereg czasowy pomiarów jednego sensora.
+ */
+
+#ifndef SENSORSERIES_H
+#define SENSORSERIES_H
+
+#include <QVector>
+#include <QJsonArray>
+#include <QtGlobal>
+
+/**
+ * @class SensorSeries
+ * @brief Szereg czasowy przechowywany jako trzy kolumny: znaczniki czasu, wartości i mapa bitowa braków.
+ *
+ * Znaczniki czasu to sekundy od epoki Unix (rosnąco, bez duplikatów), wartości są typu float,
+ * a brakujące pomiary (@c "value": null w API GIOŚ) oznaczone są bitem w mapie nullBits.
+ * Jeden punkt zajmuje ok. 12 bajtów zamiast obiektu QJsonObject z dwoma napisami.
+ */
+class SensorSeries {
+public:
+    /**
+     * @brief Tworzy szereg z tablicy obiektów @c {date, value} w formacie API GIOŚ.
+     * @param values Tablica pomiarów (w dowolnej kolejności, zwykle od najnowszego).
+     * @return Posortowany szereg czasowy.
+     */
+    static SensorSeries fromJson(const QJsonArray &values);
+    /**
+     * @brief Zamienia szereg na tablicę obiektów @c {date, value} (od najnowszego pomiaru).
+     * @return Tablica JSON zgodna z formatem zapisu plików danych.
+     */
+    QJsonArray toJson() const;
+
+    /**
+     * @brief Usuwa wszystkie punkty.
+     */
+    void clear();
+    /**
+     * @brief Rezerwuje miejsce na podaną liczbę punktów.
+     * @param count Oczekiwana liczba punktów.
+     */
+    void reserve(int count);
+    /**
+     * @brief Dodaje punkt na koniec szeregu bez sortowania.
+     * @param timestamp Czas pomiaru w sekundach od epoki.
+     * @param value Wartość pomiaru (ignorowana, gdy isNull).
+     * @param isNull Czy pomiar jest brakujący.
+     *
+     * Po serii wywołań z nieuporządkowanymi danymi należy wywołać sortByTime().
+     */
+    void append(qint64 timestamp, float value, bool isNull = false);
+    /**
+     * @brief Wstawia punkt z zachowaniem porządku; istniejący punkt o tym samym czasie jest nadpisywany.
+     * @param timestamp Czas pomiaru w sekundach od epoki.
+     * @param value Wartość pomiaru.
+     * @param isNull Czy pomiar jest brakujący.
+     */
+    void insert(qint64 timestamp, float value, bool isNull = false);
+    /**
+     * @brief Scala inny szereg z bieżącym; przy równych czasach wygrywają punkty z other.
+     * @param other Szereg do scalenia.
+     */
+    void merge(const SensorSeries &other);
+    /**
+     * @brief Sortuje punkty rosnąco po czasie i usuwa duplikaty (zostaje ostatnio dodany).
+     */
+    void sortByTime();
+
+    int size() const { return times.size(); } ///< Liczba punktów.
+    bool isEmpty() const { return times.isEmpty(); } ///< Czy szereg jest pusty.
+    qint64 timestamp(int index) const { return times[index]; } ///< Czas punktu w sekundach od epoki.
+    float value(int index) const { return vals[index]; } ///< Wartość punktu.
+    bool isNull(int index) const { return (nullBits[index >> 6] >> (index & 63)) & 1; } ///< Czy punkt jest brakujący.
+
+    /**
+     * @brief Zwraca indeks pierwszego punktu o czasie >= timestamp.
+     * @param timestamp Czas w sekundach od epoki.
+     * @return Indeks w przedziale [0, size()].
+     */
+    int lowerBound(qint64 timestamp) const;
+    /**
+     * @brief Zwraca indeks najnowszego punktu.
+     * @return Indeks lub -1 dla pustego szeregu.
+     */
+    int latestIndex() const { return times.size() - 1; }
+
+private:
+    /**
+     * @brief Ustawia bit braku dla punktu.
+     * @param index Indeks punktu.
+     * @param isNull Wartość bitu.
+     */
+    void setNull(int index, bool isNull);
+
+    QVector<qint64> times; ///< Znaczniki czasu (sekundy od epoki, rosnąco).
+    QVector<float> vals; ///< Wartości pomiarów.
+    QVector<quint64> nullBits; ///< Mapa bitowa brakujących pomiarów.
+};
+
+#endif // SENSORSERIES_H
@@ -0,0 +1,343 @@
+/**
+ * @file seriescodec.cpp
+ * @brief Implementacja kompresji szeregów pomiarów.
+ */
+
+#include "seriescodec.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+namespace {
+
+/**
+ * @class BitWriter
+ * @brief Zapis strumienia bitów (od najstarszego bitu) do QByteArray.
+ */
+class BitWriter {
+public:
+    /**
+     * @brief Konstruktor klasy BitWriter.
+     * @param out Bufor docelowy.
+     */
+    explicit BitWriter(QByteArray &out) : out(out) {}
+
+    /**
+     * @brief Zapisuje najmłodsze bity liczby.
+     * @param value Wartość.
+     * @param bits Liczba bitów (1-64).
+     */
+    void write(quint64 value, int bits) {
+        while (bits > 0) {
+            const int take = qMin(8 - pendingBits, bits);
+            const quint32 chunk = quint32(value >> (bits - take)) & ((1u << take) - 1);
+            pending = (pending << take) | chunk;
+            pendingBits += take;
+            bits -= take;
+            if (pendingBits == 8) {
+                out.append(char(pending));
+                pending = 0;
+                pendingBits = 0;
+            }
+        }
+    }
+    /**
+     * @brief Dopełnia ostatni bajt zerami.
+     */
+    void flush() {
+        if (pendingBits > 0) {
+            out.append(char(pending << (8 - pendingBits)));
+            pending = 0;
+            pendingBits = 0;
+        }
+    }
+
+private:
+    QByteArray &out; ///< Bufor docelowy.
+    quint32 pending = 0; ///< Niezapisane bity.
+    int pendingBits = 0; ///< Liczba niezapisanych bitów.
+};
+
+/**
+ * @class BitReader
+ * @brief Odczyt strumienia bitów zapisanego przez BitWriter.
+ */
+class BitReader {
+public:
+    /**
+     * @brief Konstruktor klasy BitReader.
+     * @param bytes Dane strumienia.
+     * @param size Rozmiar danych w bajtach.
+     */
+    BitReader(const uchar *bytes, quint32 size) : bytes(bytes), totalBits(quint64(size) * 8) {}
+
+    /**
+     * @brief Odczytuje kolejne bity.
+     * @param bits Liczba bitów (1-64).
+     * @param value Odczytana wartość.
+     * @return false, jeśli strumień się skończył.
+     */
+    bool read(int bits, quint64 &value) {
+        if (quint64(bits) > totalBits - pos) {
+            return false;
+        }
+        value = 0;
+        while (bits > 0) {
+            const int available = 8 - int(pos & 7);
+            const int take = qMin(available, bits);
+            const quint32 chunk = (quint32(bytes[pos >> 3]) >> (available - take)) & ((1u << take) - 1);
+            value = (value << take) | chunk;
+            pos += quint64(take);
+            bits -= take;
+        }
+        return true;
+    }
+    /**
+     * @brief Odczytuje jeden bit.
+     * @param bit Odczytany bit.
+     * @return false, jeśli strumień się skończył.
+     */
+    bool readBit(bool &bit) {
+        quint64 value;
+        if (!read(1, value)) {
+            return false;
+        }
+        bit = value != 0;
+        return true;
+    }
+
+private:
+    const uchar *bytes; ///< Dane strumienia.
+    quint64 totalBits; ///< Długość strumienia w bitach.
+    quint64 pos = 0; ///< Bieżąca pozycja w bitach.
+};
+
+/// Przedziały różnicy odstępów czasu: prefiks, jego długość i liczba bitów wartości.
+struct DeltaBucket {
+    quint32 prefix; ///< Bity prefiksu.
+    int prefixBits; ///< Długość prefiksu.
+    int valueBits; ///< Liczba bitów wartości ze znakiem.
+};
+
+/// Przedziały od najkrótszego; ostatni zapisuje pełne 64 bity.
+constexpr DeltaBucket DeltaBuckets[] = {
+    {0b10, 2, 7},
+    {0b110, 3, 12},
+    {0b1110, 4, 20},
+    {0b1111, 4, 64},
+};
+
+/**
+ * @brief Zapisuje różnicę odstępów czasu w najkrótszym pasującym przedziale.
+ * @param writer Strumień bitów.
+ * @param delta Różnica między bieżącym a poprzednim odstępem.
+ */
+void writeDeltaOfDelta(BitWriter &writer, qint64 delta) {
+    if (delta == 0) {
+        writer.write(0, 1);
+        return;
+    }
+    for (const DeltaBucket &bucket : DeltaBuckets) {
+        const qint64 limit = bucket.valueBits == 64 ? 0 : qint64(1) << (bucket.valueBits - 1);
+        if (bucket.valueBits == 64 || (delta >= -limit && delta < limit)) {
+            writer.write(bucket.prefix, bucket.prefixBits);
+            writer.write(quint64(delta), bucket.valueBits);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Odczytuje różnicę odstępów czasu zapisaną przez writeDeltaOfDelta().
+ * @param reader Strumień bitów.
+ * @param delta Odczytana różnica.
+ * @return false, jeśli strumień się skończył.
+ */
+bool readDeltaOfDelta(BitReader &reader, qint64 &delta) {
+    // Liczba jedynek przed zerem (najwyżej 4) wyznacza przedział
+    int ones = 0;
+    bool bit = true;
+    while (ones < 4) {
+        if (!reader.readBit(bit)) {
+            return false;
+        }
+        if (!bit) {
+            break;
+        }
+        ++ones;
+    }
+    if (ones == 0) {
+        delta = 0;
+        return true;
+    }
+    const int valueBits = DeltaBuckets[ones - 1].valueBits;
+    quint64 raw;
+    if (!reader.read(valueBits, raw)) {
+        return false;
+    }
+    if (valueBits < 64 && (raw >> (valueBits - 1)) & 1) {
+        raw |= ~quint64(0) << valueBits;  // Rozszerzenie znaku
+    }
+    delta = qint64(raw);
+    return true;
+}
+
+/**
+ * @brief Zwraca bity liczby float.
+ * @param value Wartość.
+ * @return Reprezentacja IEEE 754.
+ */
+quint32 floatBits(float value) {
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+namespace SeriesCodec {
+
+/**
+ * @brief Koduje fragment szeregu.
+ * @param series Szereg posortowany rosnąco.
+ * @param begin Indeks pierwszego punktu.
+ * @param end Indeks za ostatnim punktem.
+ * @return Strumień bitów (dopełniony do pełnego bajtu).
+ */
+QByteArray encode(const SensorSeries &series, int begin, int end) {
+    QByteArray out;
+    out.reserve((end - begin) * 3 + 16);
+    BitWriter writer(out);
+
+    qint64 previousTime = 0;
+    qint64 previousDelta = 0;
+    quint32 previousBits = 0;
+    bool haveValue = false;
+    int previousLeading = -1;
+    int previousTrailing = 0;
+
+    for (int i = begin; i < end; ++i) {
+        const qint64 time = series.timestamp(i);
+        if (i == begin) {
+            writer.write(quint64(time), 64);
+        } else {
+            const qint64 delta = time - previousTime;
+            writeDeltaOfDelta(writer, delta - previousDelta);
+            previousDelta = delta;
+        }
+        previousTime = time;
+
+        const bool isNull = series.isNull(i);
+        writer.write(isNull ? 1 : 0, 1);
+        if (isNull) {
+            continue;
+        }
+
+        const quint32 bits = floatBits(series.value(i));
+        if (!haveValue) {
+            writer.write(bits, 32);
+            haveValue = true;
+        } else {
+            const quint32 diff = bits ^ previousBits;
+            if (diff == 0) {
+                writer.write(0, 1);
+            } else {
+                const int leading = qCountLeadingZeroBits(diff);
+                const int trailing = qCountTrailingZeroBits(diff);
+                if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing) {
+                    // Znaczące bity mieszczą się w poprzednim oknie
+                    writer.write(0b10, 2);
+                    writer.write(diff >> previousTrailing, 32 - previousLeading - previousTrailing);
+                } else {
+                    const int length = 32 - leading - trailing;
+                    writer.write(0b11, 2);
+                    writer.write(quint64(leading), 5);
+                    writer.write(quint64(length - 1), 5);
+                    writer.write(diff >> trailing, length);
+                    previousLeading = leading;
+                    previousTrailing = trailing;
+                }
+            }
+        }
+        previousBits = bits;
+    }
+
+    writer.flush();
+    return out;
+}
+
+/**
+ * @brief Dekoduje strumień zapisany przez encode() i dopisuje punkty do szeregu.
+ * @param bytes Dane strumienia.
+ * @param size Rozmiar danych w bajtach.
+ * @param count Liczba zakodowanych punktów.
+ * @param series Szereg docelowy.
+ * @return false, jeśli strumień jest uszkodzony lub za krótki.
+ */
+bool decode(const uchar *bytes, quint32 size, quint32 count, SensorSeries &series) {
+    // Każdy punkt zajmuje co najmniej dwa bity - odrzuć nierealne liczniki przed rezerwacją pamięci
+    if (quint64(count) * 2 > quint64(size) * 8 + 64) {
+        return false;
+    }
+    BitReader reader(bytes, size);
+    series.reserve(series.size() + int(count));
+
+    qint64 time = 0;
+    qint64 delta = 0;
+    quint32 bits = 0;
+    bool haveValue = false;
+    int windowLeading = -1;
+    int windowTrailing = 0;
+
+    for (quint32 i = 0; i < count; ++i) {
+        quint64 raw;
+        if (i == 0) {
+            if (!reader.read(64, raw)) return false;
+            time = qint64(raw);
+        } else {
+            qint64 deltaOfDelta;
+            if (!readDeltaOfDelta(reader, deltaOfDelta)) return false;
+            delta += deltaOfDelta;
+            time += delta;
+        }
+
+        bool isNull;
+        if (!reader.readBit(isNull)) return false;
+        if (isNull) {
+            series.append(time, 0.0f, true);
+            continue;
+        }
+
+        if (!haveValue) {
+            if (!reader.read(32, raw)) return false;
+            bits = quint32(raw);
+            haveValue = true;
+        } else {
+            bool changed;
+            if (!reader.readBit(changed)) return false;
+            if (changed) {
+                bool newWindow;
+                if (!reader.readBit(newWindow)) return false;
+                if (newWindow) {
+                    quint64 leading;
+                    quint64 length;
+                    if (!reader.read(5, leading) || !reader.read(5, length)) return false;
+                    windowLeading = int(leading);
+                    windowTrailing = 32 - windowLeading - int(length + 1);
+                    if (windowTrailing < 0) return false;
+                } else if (windowLeading < 0) {
+                    return false;
+                }
+                const int meaningful = 32 - windowLeading - windowTrailing;
+                if (!reader.read(meaningful, raw)) return false;
+                bits ^= quint32(raw) << windowTrailing;
+            }
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        series.append(time, value, false);
+    }
+    return true;
+}
+
+} // namespace SeriesCodec
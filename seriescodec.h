@@ -0,0 +1,47 @@
+/**
+ * @file seriescodec.h
+ * @brief Kompresja szeregów pomiarów: różnice drugiego rzędu czasów i XOR kolejnych wartości (Gorilla).
+ */
+
+#ifndef SERIESCODEC_H
+#define SERIESCODEC_H
+
+#include <QByteArray>
+#include "sensorseries.h"
+
+/**
+ * @namespace SeriesCodec
+ * @brief Kodowanie fragmentów SensorSeries do zwartego strumienia bitów.
+ *
+ * Dla każdego punktu zapisywane są kolejno:
+ * - czas: pierwszy w 64 bitach, następne jako różnica między kolejnymi odstępami (dla stałego,
+ *   godzinowego kroku to jeden bit @c 0),
+ * - bit braku pomiaru,
+ * - wartość (tylko dla niebrakujących): pierwsza jako 32 bity liczby float, następne jako XOR
+ *   z poprzednią wartością, zapisany bez wiodących i końcowych zer.
+ *
+ * Godzinowy szereg GIOŚ zajmuje zwykle 2-3 bajty na punkt zamiast 12 bajtów kolumn surowych.
+ */
+namespace SeriesCodec {
+
+/**
+ * @brief Koduje fragment szeregu.
+ * @param series Szereg posortowany rosnąco.
+ * @param begin Indeks pierwszego punktu.
+ * @param end Indeks za ostatnim punktem.
+ * @return Strumień bitów (dopełniony do pełnego bajtu).
+ */
+QByteArray encode(const SensorSeries &series, int begin, int end);
+/**
+ * @brief Dekoduje strumień zapisany przez encode() i dopisuje punkty do szeregu.
+ * @param bytes Dane strumienia.
+ * @param size Rozmiar danych w bajtach.
+ * @param count Liczba zakodowanych punktów.
+ * @param series Szereg docelowy.
+ * @return false, jeśli strumień jest uszkodzony lub za krótki.
+ */
+bool decode(const uchar *bytes, quint32 size, quint32 count, SensorSeries &series);
+
+} // namespace SeriesCodec
+
+#endif // SERIESCODEC_H
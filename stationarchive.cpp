@@ -0,0 +1,826 @@
+/**
+ * @file stationarchive.cpp
+ * @brief Implementacja binarnego archiwum pomiarów stacji.
+ */
+
+#include "stationarchive.h"
+#include "seriescodec.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <array>
+#include <cstring>
+
+namespace {
+
+const char FileMagic[8] = {'G', 'I', 'O', 'S', 'A', 'R', 'C', 'H'}; ///< Sygnatura pliku archiwum.
+constexpr quint16 FileVersion = 1; ///< Wersja formatu pliku.
+constexpr int FileHeaderSize = 32; ///< Rozmiar nagłówka pliku.
+constexpr int IndexOffsetPosition = 16; ///< Położenie pola z pozycją bloku indeksu w nagłówku pliku.
+constexpr quint32 BlockMagic = 0x4B4C4247; ///< Sygnatura bloku (@c "GBLK").
+constexpr int BlockHeaderSize = 48; ///< Rozmiar nagłówka bloku.
+constexpr int BlockCrcOffset = 44; ///< Położenie sumy kontrolnej nagłówka bloku.
+constexpr int MaxBlockPoints = 4096; ///< Maksymalna liczba punktów w bloku danych po kompakcji.
+constexpr int CompactionThreshold = 16; ///< Liczba niepełnych bloków na sensor, od której warto kompaktować.
+
+/// Typy bloków archiwum.
+enum BlockType : quint16 { StationBlock = 1, SensorBlock = 2, DataBlockType = 3, IndexBlock = 4 };
+/// Sposoby kodowania zawartości bloku danych.
+enum BlockEncoding : quint16 { RawEncoding = 0, GorillaEncoding = 1 };
+
+/**
+ * @brief Liczy sumę kontrolną CRC32 (IEEE 802.3).
+ * @param bytes Dane.
+ * @param length Liczba bajtów.
+ * @return Suma kontrolna.
+ */
+quint32 crc32(const uchar *bytes, qint64 length) {
+    static const std::array<quint32, 256> table = [] {
+        /**
+         * @brief Lambda budująca tablicę reszt dla wielomianu 0xEDB88320.
+         * @return Tablica 256 reszt.
+         */
+        std::array<quint32, 256> result{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            result[i] = c;
+        }
+        return result;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (qint64 i = 0; i < length; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Dopisuje liczbę w porządku little-endian.
+ * @param out Bufor docelowy.
+ * @param value Wartość.
+ */
+template <typename T>
+void put(QByteArray &out, T value) {
+    const T encoded = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&encoded), sizeof(T));
+}
+
+/**
+ * @brief Odczytuje liczbę zapisaną w porządku little-endian.
+ * @param bytes Wskaźnik na dane (bez wymagań co do wyrównania).
+ * @return Wartość.
+ */
+template <typename T>
+T get(const uchar *bytes) {
+    return qFromLittleEndian<T>(bytes);
+}
+
+/**
+ * @brief Dopisuje napis jako długość i bajty UTF-8.
+ * @param out Bufor docelowy.
+ * @param text Napis.
+ */
+void putString(QByteArray &out, const QString &text) {
+    const QByteArray utf8 = text.toUtf8();
+    put<quint32>(out, quint32(utf8.size()));
+    out.append(utf8);
+}
+
+/**
+ * @brief Odczytuje napis zapisany przez putString().
+ * @param bytes Początek zawartości bloku.
+ * @param size Rozmiar zawartości bloku.
+ * @param pos Bieżące położenie (przesuwane za napis).
+ * @param text Odczytany napis.
+ * @return false, jeśli napis wykracza poza blok.
+ */
+bool getString(const uchar *bytes, quint32 size, quint32 &pos, QString &text) {
+    if (size - pos < 4) {
+        return false;
+    }
+    const quint32 length = get<quint32>(bytes + pos);
+    pos += 4;
+    if (size - pos < length) {
+        return false;
+    }
+    text = QString::fromUtf8(reinterpret_cast<const char *>(bytes + pos), qsizetype(length));
+    pos += length;
+    return true;
+}
+
+/**
+ * @brief Zwraca nagłówek nowego pliku archiwum.
+ * @return Nagłówek pliku.
+ */
+QByteArray fileHeader() {
+    QByteArray out(FileMagic, sizeof(FileMagic));
+    put<quint16>(out, FileVersion);
+    put<quint16>(out, 0);  // Flagi
+    put<quint32>(out, 0);  // Zarezerwowane
+    put<quint64>(out, 0);  // Położenie bloku indeksu (0 - brak)
+    put<quint64>(out, 0);  // Zarezerwowane
+    return out;
+}
+
+/**
+ * @brief Dopisuje blok (nagłówek i zawartość wyrównaną do 8 bajtów).
+ * @param out Bufor docelowy.
+ * @param type Typ bloku.
+ * @param encoding Sposób kodowania zawartości.
+ * @param stationId ID stacji.
+ * @param sensorId ID sensora (0 dla bloku stacji).
+ * @param count Liczba punktów (0 dla bloków opisowych).
+ * @param firstTimestamp Czas pierwszego punktu.
+ * @param lastTimestamp Czas ostatniego punktu.
+ * @param payload Zawartość bloku.
+ */
+void appendBlock(QByteArray &out, quint16 type, quint16 encoding, int stationId, int sensorId, quint32 count,
+                 qint64 firstTimestamp, qint64 lastTimestamp, QByteArray payload) {
+    while (payload.size() % 8 != 0) {
+        payload.append('\0');
+    }
+
+    QByteArray header;
+    header.reserve(BlockHeaderSize);
+    put<quint32>(header, BlockMagic);
+    put<quint16>(header, type);
+    put<quint16>(header, encoding);
+    put<qint32>(header, stationId);
+    put<qint32>(header, sensorId);
+    put<quint32>(header, count);
+    put<quint32>(header, quint32(payload.size()));
+    put<qint64>(header, firstTimestamp);
+    put<qint64>(header, lastTimestamp);
+    put<quint32>(header, crc32(reinterpret_cast<const uchar *>(payload.constData()), payload.size()));
+    put<quint32>(header, crc32(reinterpret_cast<const uchar *>(header.constData()), BlockCrcOffset));
+
+    out.append(header);
+    out.append(payload);
+}
+
+/**
+ * @struct BlockHeader
+ * @brief Odczytany nagłówek bloku.
+ */
+struct BlockHeader {
+    quint16 type; ///< Typ bloku.
+    quint16 encoding; ///< Sposób kodowania zawartości.
+    int stationId; ///< ID stacji.
+    int sensorId; ///< ID sensora.
+    quint32 count; ///< Liczba punktów.
+    quint32 payloadSize; ///< Rozmiar zawartości.
+    qint64 firstTimestamp; ///< Czas pierwszego punktu.
+    qint64 lastTimestamp; ///< Czas ostatniego punktu.
+    quint32 payloadCrc; ///< Suma CRC32 zawartości.
+};
+
+/**
+ * @brief Odczytuje i weryfikuje nagłówek bloku.
+ * @param bytes Początek nagłówka (co najmniej BlockHeaderSize bajtów).
+ * @param header Odczytany nagłówek.
+ * @return false, jeśli sygnatura lub suma kontrolna nagłówka się nie zgadza.
+ */
+bool parseBlockHeader(const uchar *bytes, BlockHeader &header) {
+    if (get<quint32>(bytes) != BlockMagic || get<quint32>(bytes + BlockCrcOffset) != crc32(bytes, BlockCrcOffset)) {
+        return false;
+    }
+    header.type = get<quint16>(bytes + 4);
+    header.encoding = get<quint16>(bytes + 6);
+    header.stationId = get<qint32>(bytes + 8);
+    header.sensorId = get<qint32>(bytes + 12);
+    header.count = get<quint32>(bytes + 16);
+    header.payloadSize = get<quint32>(bytes + 20);
+    header.firstTimestamp = get<qint64>(bytes + 24);
+    header.lastTimestamp = get<qint64>(bytes + 32);
+    header.payloadCrc = get<quint32>(bytes + 40);
+    return true;
+}
+
+/**
+ * @brief Buduje klucz pary (stacja, sensor).
+ * @param stationId ID stacji.
+ * @param sensorId ID sensora.
+ * @return Klucz 64-bitowy.
+ */
+quint64 sensorKey(int stationId, int sensorId) {
+    return (quint64(quint32(stationId)) << 32) | quint32(sensorId);
+}
+
+/**
+ * @brief Dekoduje zawartość bloku zapisaną jako surowe kolumny: czasy, wartości i mapa bitowa braków.
+ * @param bytes Zawartość bloku.
+ * @param size Rozmiar zawartości.
+ * @param count Liczba punktów.
+ * @param series Szereg, do którego dopisywane są punkty.
+ * @return false, jeśli zawartość jest za krótka.
+ */
+bool decodeRaw(const uchar *bytes, quint32 size, quint32 count, SensorSeries &series) {
+    const quint64 needed = quint64(count) * 12 + quint64(count + 63) / 64 * 8;
+    if (needed > size) {
+        return false;
+    }
+    const uchar *timeColumn = bytes;
+    const uchar *valueColumn = bytes + quint64(count) * 8;
+    const uchar *nullColumn = valueColumn + quint64(count) * 4;
+
+    series.reserve(series.size() + int(count));
+    for (quint32 i = 0; i < count; ++i) {
+        const quint32 bits = get<quint32>(valueColumn + i * 4);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        const bool isNull = (get<quint64>(nullColumn + (i >> 6) * 8) >> (i & 63)) & 1;
+        series.append(get<qint64>(timeColumn + quint64(i) * 8), value, isNull);
+    }
+    return true;
+}
+
+/**
+ * @brief Dopisuje szereg jako ciąg bloków danych po co najwyżej MaxBlockPoints punktów.
+ * @param out Bufor docelowy.
+ * @param stationId ID stacji.
+ * @param sensorId ID sensora.
+ * @param series Szereg posortowany rosnąco.
+ * @param index Opcjonalna lista, do której trafiają opisy zapisanych bloków (położenia względem początku out).
+ */
+void appendDataBlocks(QByteArray &out, int stationId, int sensorId, const SensorSeries &series,
+                      QVector<StationArchiveReader::DataBlock> *index = nullptr) {
+    for (int begin = 0; begin < series.size(); begin += MaxBlockPoints) {
+        const int end = qMin(begin + MaxBlockPoints, series.size());
+        const qint64 blockOffset = out.size();
+        appendBlock(out, DataBlockType, GorillaEncoding, stationId, sensorId, quint32(end - begin),
+                    series.timestamp(begin), series.timestamp(end - 1), SeriesCodec::encode(series, begin, end));
+        if (index) {
+            BlockHeader header;
+            parseBlockHeader(reinterpret_cast<const uchar *>(out.constData()) + blockOffset, header);
+            StationArchiveReader::DataBlock block;
+            block.stationId = stationId;
+            block.sensorId = sensorId;
+            block.encoding = header.encoding;
+            block.count = header.count;
+            block.firstTimestamp = header.firstTimestamp;
+            block.lastTimestamp = header.lastTimestamp;
+            block.payloadOffset = blockOffset + BlockHeaderSize;
+            block.payloadSize = header.payloadSize;
+            block.payloadCrc = header.payloadCrc;
+            index->append(block);
+        }
+    }
+}
+
+/**
+ * @brief Koduje zawartość bloku opisu stacji.
+ * @param station Opis stacji.
+ * @return Zawartość bloku.
+ */
+QByteArray encodeStation(const ArchivedStation &station) {
+    QByteArray out;
+    putString(out, station.stationName);
+    putString(out, station.location);
+    return out;
+}
+
+/**
+ * @brief Koduje zawartość bloku opisu sensora.
+ * @param sensor Opis sensora.
+ * @return Zawartość bloku.
+ */
+QByteArray encodeSensor(const ArchivedSensor &sensor) {
+    QByteArray out;
+    putString(out, sensor.paramCode);
+    putString(out, sensor.paramName);
+    putString(out, sensor.latestValue);
+    return out;
+}
+
+/**
+ * @brief Koduje zawartość bloku indeksu: opisy stacji i sensorów oraz położenia bloków danych.
+ * @param stations Opisy stacji.
+ * @param blocks Bloki danych.
+ * @return Zawartość bloku.
+ */
+QByteArray encodeIndex(const QVector<ArchivedStation> &stations, const QVector<StationArchiveReader::DataBlock> &blocks) {
+    QByteArray out;
+    put<quint32>(out, quint32(stations.size()));
+    for (const ArchivedStation &station : stations) {
+        put<qint32>(out, station.stationId);
+        out.append(encodeStation(station));
+        put<quint32>(out, quint32(station.sensors.size()));
+        for (const ArchivedSensor &sensor : station.sensors) {
+            put<qint32>(out, sensor.sensorId);
+            out.append(encodeSensor(sensor));
+        }
+    }
+    put<quint32>(out, quint32(blocks.size()));
+    for (const StationArchiveReader::DataBlock &block : blocks) {
+        put<qint32>(out, block.stationId);
+        put<qint32>(out, block.sensorId);
+        put<quint16>(out, block.encoding);
+        put<quint16>(out, 0);
+        put<quint32>(out, block.count);
+        put<qint64>(out, block.firstTimestamp);
+        put<qint64>(out, block.lastTimestamp);
+        put<qint64>(out, block.payloadOffset);
+        put<quint32>(out, block.payloadSize);
+        put<quint32>(out, block.payloadCrc);
+    }
+    return out;
+}
+
+/**
+ * @brief Szuka sensora o podanym ID w opisie stacji.
+ * @param station Opis stacji.
+ * @param sensorId ID sensora.
+ * @return Indeks sensora lub -1.
+ */
+int indexOfSensor(const ArchivedStation &station, int sensorId) {
+    for (int i = 0; i < station.sensors.size(); ++i) {
+        if (station.sensors[i].sensorId == sensorId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+/**
+ * @brief Destruktor klasy StationArchiveReader.
+ */
+StationArchiveReader::~StationArchiveReader() {
+    close();
+}
+
+/**
+ * @brief Otwiera i mapuje plik archiwum, odczytując nagłówki bloków.
+ * @param fileName Ścieżka do pliku.
+ * @return false, jeśli pliku nie da się otworzyć lub nie jest archiwum.
+ */
+bool StationArchiveReader::open(const QString &fileName) {
+    close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+
+    size = file.size();
+    if (size < FileHeaderSize) {
+        error = QStringLiteral("Plik jest za krótki, aby był archiwum GIOŚ.");
+        close();
+        return false;
+    }
+    data = file.map(0, size);
+    if (!data) {
+        error = file.errorString();
+        close();
+        return false;
+    }
+    if (std::memcmp(data, FileMagic, sizeof(FileMagic)) != 0) {
+        error = QStringLiteral("Plik nie jest archiwum GIOŚ.");
+        close();
+        return false;
+    }
+    if (get<quint16>(data + 8) != FileVersion) {
+        error = QStringLiteral("Nieobsługiwana wersja archiwum: %1.").arg(get<quint16>(data + 8));
+        close();
+        return false;
+    }
+
+    // Skompaktowany plik ma indeks - wystarczy go wczytać i przejrzeć bloki dopisane później
+    qint64 scanFrom = FileHeaderSize;
+    const quint64 indexOffset = get<quint64>(data + IndexOffsetPosition);
+    if (indexOffset != 0 && !loadIndex(qint64(indexOffset), &scanFrom)) {
+        qWarning() << "Indeks archiwum jest nieprawidłowy, odczyt wszystkich bloków:" << fileName;
+        stationList.clear();
+        dataBlocks.clear();
+        sensorBlocks.clear();
+        scanFrom = FileHeaderSize;
+    }
+    scan(scanFrom);
+    return true;
+}
+
+/**
+ * @brief Wczytuje blok indeksu.
+ * @param offset Położenie bloku indeksu.
+ * @param end Położenie za blokiem indeksu.
+ * @return false, jeśli indeks jest nieprawidłowy.
+ */
+bool StationArchiveReader::loadIndex(qint64 offset, qint64 *end) {
+    BlockHeader header;
+    if (offset < FileHeaderSize || size - offset < BlockHeaderSize || !parseBlockHeader(data + offset, header)
+        || header.type != IndexBlock || header.payloadSize > size - offset - BlockHeaderSize) {
+        return false;
+    }
+    const uchar *payload = data + offset + BlockHeaderSize;
+    const quint32 payloadSize = header.payloadSize;
+    if (crc32(payload, payloadSize) != header.payloadCrc) {
+        return false;
+    }
+
+    quint32 cursor = 0;
+    if (payloadSize < 4) {
+        return false;
+    }
+    const quint32 stationCount = get<quint32>(payload);
+    cursor += 4;
+    for (quint32 i = 0; i < stationCount; ++i) {
+        ArchivedStation station;
+        if (payloadSize - cursor < 4) return false;
+        station.stationId = get<qint32>(payload + cursor);
+        cursor += 4;
+        if (!getString(payload, payloadSize, cursor, station.stationName)
+            || !getString(payload, payloadSize, cursor, station.location)
+            || payloadSize - cursor < 4) {
+            return false;
+        }
+        const quint32 sensorCount = get<quint32>(payload + cursor);
+        cursor += 4;
+        for (quint32 k = 0; k < sensorCount; ++k) {
+            ArchivedSensor sensor;
+            if (payloadSize - cursor < 4) return false;
+            sensor.sensorId = get<qint32>(payload + cursor);
+            cursor += 4;
+            if (!getString(payload, payloadSize, cursor, sensor.paramCode)
+                || !getString(payload, payloadSize, cursor, sensor.paramName)
+                || !getString(payload, payloadSize, cursor, sensor.latestValue)) {
+                return false;
+            }
+            station.sensors.append(sensor);
+        }
+        stationList.append(station);
+    }
+
+    if (payloadSize - cursor < 4) {
+        return false;
+    }
+    const quint32 blockCount = get<quint32>(payload + cursor);
+    cursor += 4;
+    if ((payloadSize - cursor) / 48 < blockCount) {
+        return false;
+    }
+    dataBlocks.reserve(int(blockCount));
+    for (quint32 i = 0; i < blockCount; ++i, cursor += 48) {
+        const uchar *entry = payload + cursor;
+        DataBlock block;
+        block.stationId = get<qint32>(entry);
+        block.sensorId = get<qint32>(entry + 4);
+        block.encoding = get<quint16>(entry + 8);
+        block.count = get<quint32>(entry + 12);
+        block.firstTimestamp = get<qint64>(entry + 16);
+        block.lastTimestamp = get<qint64>(entry + 24);
+        block.payloadOffset = get<qint64>(entry + 32);
+        block.payloadSize = get<quint32>(entry + 40);
+        block.payloadCrc = get<quint32>(entry + 44);
+        // Bloki z indeksu muszą leżeć przed nim
+        if (block.payloadOffset < FileHeaderSize + BlockHeaderSize || block.payloadOffset > offset
+            || block.payloadSize > offset - block.payloadOffset) {
+            return false;
+        }
+        addDataBlock(block);
+    }
+
+    *end = offset + BlockHeaderSize + payloadSize;
+    return true;
+}
+
+/**
+ * @brief Zwalnia mapowanie i zamyka plik.
+ */
+void StationArchiveReader::close() {
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+    }
+    file.close();
+    size = 0;
+    validEnd = 0;
+    damaged = false;
+    stationList.clear();
+    dataBlocks.clear();
+    sensorBlocks.clear();
+}
+
+/**
+ * @brief Przegląda nagłówki bloków i buduje listę stacji oraz bloków danych.
+ * @param from Położenie pierwszego bloku do odczytu.
+ *
+ * Zawartość bloków danych nie jest czytana - suma kontrolna sprawdzana jest dopiero przy dekodowaniu.
+ */
+void StationArchiveReader::scan(qint64 from) {
+    qint64 pos = from;
+    while (size - pos >= BlockHeaderSize) {
+        BlockHeader header;
+        if (!parseBlockHeader(data + pos, header)) {
+            damaged = true;
+            break;
+        }
+        const quint32 payloadSize = header.payloadSize;
+        if (payloadSize > size - pos - BlockHeaderSize) {
+            break;  // Niedopisany blok na końcu pliku
+        }
+
+        const int stationId = header.stationId;
+        const int sensorId = header.sensorId;
+        const qint64 payloadOffset = pos + BlockHeaderSize;
+        const uchar *payload = data + payloadOffset;
+        pos = payloadOffset + payloadSize;
+
+        if (header.type == DataBlockType) {
+            DataBlock block;
+            block.stationId = stationId;
+            block.sensorId = sensorId;
+            block.encoding = header.encoding;
+            block.count = header.count;
+            block.firstTimestamp = header.firstTimestamp;
+            block.lastTimestamp = header.lastTimestamp;
+            block.payloadOffset = payloadOffset;
+            block.payloadSize = payloadSize;
+            block.payloadCrc = header.payloadCrc;
+            addDataBlock(block);
+            continue;
+        }
+        if (header.type == IndexBlock) {
+            continue;  // Opisuje bloki, które i tak są tu odczytywane
+        }
+
+        if (crc32(payload, payloadSize) != header.payloadCrc) {
+            qWarning() << "Pominięto uszkodzony blok archiwum w pozycji" << payloadOffset - BlockHeaderSize;
+            continue;
+        }
+        quint32 cursor = 0;
+        if (header.type == StationBlock) {
+            QString stationName;
+            QString location;
+            if (getString(payload, payloadSize, cursor, stationName) && getString(payload, payloadSize, cursor, location)) {
+                ArchivedStation &station = stationFor(stationId);
+                station.stationName = stationName;
+                station.location = location;
+            }
+        } else if (header.type == SensorBlock) {
+            ArchivedSensor sensor;
+            sensor.sensorId = sensorId;
+            if (getString(payload, payloadSize, cursor, sensor.paramCode)
+                && getString(payload, payloadSize, cursor, sensor.paramName)
+                && getString(payload, payloadSize, cursor, sensor.latestValue)) {
+                ArchivedStation &station = stationFor(stationId);
+                int index = indexOfSensor(station, sensorId);
+                if (index >= 0) {
+                    station.sensors[index] = sensor;
+                } else {
+                    station.sensors.append(sensor);
+                }
+            }
+        }
+    }
+    validEnd = pos;
+}
+
+/**
+ * @brief Rejestruje blok danych.
+ * @param block Opis bloku.
+ */
+void StationArchiveReader::addDataBlock(const DataBlock &block) {
+    sensorBlocks[sensorKey(block.stationId, block.sensorId)].append(dataBlocks.size());
+    dataBlocks.append(block);
+}
+
+/**
+ * @brief Zwraca opis stacji, tworząc go w razie potrzeby.
+ * @param stationId Identyfikator stacji.
+ * @return Referencja do opisu stacji.
+ */
+ArchivedStation &StationArchiveReader::stationFor(int stationId) {
+    int index = indexOfStation(stationId);
+    if (index < 0) {
+        index = stationList.size();
+        ArchivedStation station;
+        station.stationId = stationId;
+        stationList.append(station);
+    }
+    return stationList[index];
+}
+
+/**
+ * @brief Zwraca indeks stacji o podanym ID.
+ * @param stationId Identyfikator stacji.
+ * @return Indeks w stations() lub -1.
+ */
+int StationArchiveReader::indexOfStation(int stationId) const {
+    for (int i = 0; i < stationList.size(); ++i) {
+        if (stationList[i].stationId == stationId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Dekoduje szereg pomiarów sensora z jego bloków.
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator sensora.
+ * @param from Pomijane są bloki, których wszystkie punkty są starsze (domyślnie - pełny szereg).
+ * @return Szereg czasowy (pusty, jeśli brak danych).
+ *
+ * Pominięcie bloku wynika z czasu ostatniego punktu zapisanego w jego nagłówku, więc starsza część
+ * historii nie jest ani sprawdzana sumą kontrolną, ani dekodowana. Punkty bloków dopisywane są
+ * w kolejności zapisu i sortowane raz, na końcu - przy równych czasach wygrywa punkt zapisany później.
+ */
+SensorSeries StationArchiveReader::readSeries(int stationId, int sensorId, qint64 from) const {
+    SensorSeries result;
+    const QVector<int> blockIndexes = sensorBlocks.value(sensorKey(stationId, sensorId));
+    for (int blockIndex : blockIndexes) {
+        const DataBlock &block = dataBlocks[blockIndex];
+        if (block.lastTimestamp < from) {
+            continue;
+        }
+        const uchar *payload = data + block.payloadOffset;
+        if (crc32(payload, block.payloadSize) != block.payloadCrc) {
+            qWarning() << "Pominięto blok danych z błędną sumą kontrolną, sensor" << sensorId;
+            continue;
+        }
+        SensorSeries part;
+        bool decoded = false;
+        if (block.encoding == GorillaEncoding) {
+            decoded = SeriesCodec::decode(payload, block.payloadSize, block.count, part);
+        } else if (block.encoding == RawEncoding) {
+            decoded = decodeRaw(payload, block.payloadSize, block.count, part);
+        }
+        if (!decoded) {
+            qWarning() << "Pominięto nieprawidłowy blok danych, sensor" << sensorId;
+            continue;
+        }
+        result.reserve(result.size() + part.size());
+        for (int i = 0; i < part.size(); ++i) {
+            result.append(part.timestamp(i), part.value(i), part.isNull(i));
+        }
+    }
+    result.sortByTime();
+    return result;
+}
+
+/**
+ * @brief Sprawdza, czy plik jest na tyle pofragmentowany, że warto go skompaktować.
+ * @return true, jeśli niepełnych bloków danych jest dużo więcej niż sensorów.
+ *
+ * Po kompakcji każdy sensor ma najwyżej jeden niepełny blok; każdy zapis dokłada kolejny.
+ */
+bool StationArchiveReader::needsCompaction() const {
+    int sensorCount = 0;
+    for (const ArchivedStation &station : stationList) {
+        sensorCount += station.sensors.size();
+    }
+    int partialBlocks = 0;
+    for (const DataBlock &block : dataBlocks) {
+        if (block.count < quint32(MaxBlockPoints)) {
+            ++partialBlocks;
+        }
+    }
+    return partialBlocks > CompactionThreshold * qMax(1, sensorCount);
+}
+
+/**
+ * @brief Konstruktor klasy StationArchiveWriter.
+ * @param fileName Ścieżka do pliku archiwum.
+ */
+StationArchiveWriter::StationArchiveWriter(const QString &fileName)
+    : path(fileName) {}
+
+/**
+ * @brief Dopisuje do archiwum zmienione opisy oraz punkty, których jeszcze w nim nie ma.
+ * @param station Opis stacji i jej sensorów.
+ * @param series Szeregi pomiarów kluczowane ID sensora.
+ * @return false w przypadku błędu zapisu.
+ *
+ * Niedopisany koniec pliku (np. po przerwanym zapisie) jest obcinany przed dopisaniem nowych bloków;
+ * jeśli przyczyną jest uszkodzenie, oryginał zachowywany jest z rozszerzeniem @c .damaged.
+ */
+bool StationArchiveWriter::append(const ArchivedStation &station, const QMap<int, SensorSeries> &series) {
+    StationArchiveReader existing;
+    const bool exists = QFileInfo(path).size() > 0;
+    if (exists && !existing.open(path)) {
+        error = existing.errorString();
+        return false;
+    }
+
+    const int stationIndex = existing.indexOfStation(station.stationId);
+    const ArchivedStation stored = stationIndex >= 0 ? existing.stations()[stationIndex] : ArchivedStation();
+
+    QByteArray blocks;
+    if (stationIndex < 0 || stored.stationName != station.stationName || stored.location != station.location) {
+        appendBlock(blocks, StationBlock, RawEncoding, station.stationId, 0, 0, 0, 0, encodeStation(station));
+    }
+
+    for (const ArchivedSensor &sensor : station.sensors) {
+        const int sensorIndex = indexOfSensor(stored, sensor.sensorId);
+        if (sensorIndex < 0
+            || stored.sensors[sensorIndex].paramCode != sensor.paramCode
+            || stored.sensors[sensorIndex].paramName != sensor.paramName
+            || stored.sensors[sensorIndex].latestValue != sensor.latestValue) {
+            appendBlock(blocks, SensorBlock, RawEncoding, station.stationId, sensor.sensorId, 0, 0, 0, encodeSensor(sensor));
+        }
+
+        // Dopisz tylko punkty nowe lub zmienione względem archiwum; bloki starsze od najstarszego
+        // zapisywanego punktu nie są odczytywane
+        const SensorSeries fresh = series.value(sensor.sensorId);
+        if (fresh.isEmpty()) {
+            continue;
+        }
+        qint64 oldest = fresh.timestamp(0);
+        for (int i = 1; i < fresh.size(); ++i) {
+            oldest = qMin(oldest, fresh.timestamp(i));
+        }
+        const SensorSeries old = existing.readSeries(station.stationId, sensor.sensorId, oldest);
+        SensorSeries added;
+        for (int i = 0; i < fresh.size(); ++i) {
+            const int j = old.lowerBound(fresh.timestamp(i));
+            const bool unchanged = j < old.size() && old.timestamp(j) == fresh.timestamp(i)
+                                   && old.isNull(j) == fresh.isNull(i)
+                                   && (fresh.isNull(i) || old.value(j) == fresh.value(i));
+            if (!unchanged) {
+                added.append(fresh.timestamp(i), fresh.value(i), fresh.isNull(i));
+            }
+        }
+        appendDataBlocks(blocks, station.stationId, sensor.sensorId, added);
+    }
+
+    const qint64 validEnd = existing.validSize();
+    const bool damaged = existing.isDamaged();
+    existing.close();
+
+    if (damaged) {
+        // Uszkodzenie w środku pliku to nie przerwany zapis - zachowaj kopię przed obcięciem
+        const QString backupPath = path + ".damaged";
+        QFile::remove(backupPath);
+        if (!QFile::copy(path, backupPath)) {
+            error = QStringLiteral("Archiwum jest uszkodzone i nie udało się utworzyć jego kopii.");
+            return false;
+        }
+        qWarning() << "Archiwum uszkodzone, kopia zapisana jako" << backupPath;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        error = file.errorString();
+        return false;
+    }
+    if (!exists) {
+        blocks.prepend(fileHeader());
+    } else if (file.size() != validEnd && !file.resize(validEnd)) {
+        error = file.errorString();
+        return false;
+    }
+    if (!file.seek(file.size()) || file.write(blocks) != blocks.size() || !file.flush()) {
+        error = file.errorString();
+        return false;
+    }
+    file.close();
+    return true;
+}
+
+/**
+ * @brief Przepisuje archiwum tak, by każdy sensor miał jeden opis i ciągłe bloki danych.
+ * @return false w przypadku błędu zapisu.
+ *
+ * Na końcu zapisywany jest blok indeksu wskazywany z nagłówka pliku. Nowa zawartość trafia do pliku
+ * tymczasowego i jest podmieniana atomowo.
+ */
+bool StationArchiveWriter::compact() {
+    StationArchiveReader existing;
+    if (!existing.open(path)) {
+        error = existing.errorString();
+        return false;
+    }
+
+    QByteArray out = fileHeader();
+    QVector<StationArchiveReader::DataBlock> index;
+    for (const ArchivedStation &station : existing.stations()) {
+        appendBlock(out, StationBlock, RawEncoding, station.stationId, 0, 0, 0, 0, encodeStation(station));
+        for (const ArchivedSensor &sensor : station.sensors) {
+            appendBlock(out, SensorBlock, RawEncoding, station.stationId, sensor.sensorId, 0, 0, 0, encodeSensor(sensor));
+            appendDataBlocks(out, station.stationId, sensor.sensorId,
+                             existing.readSeries(station.stationId, sensor.sensorId), &index);
+        }
+    }
+    const quint64 indexOffset = quint64(out.size());
+    appendBlock(out, IndexBlock, RawEncoding, 0, 0, 0, 0, 0, encodeIndex(existing.stations(), index));
+    const quint64 encodedOffset = qToLittleEndian(indexOffset);
+    std::memcpy(out.data() + IndexOffsetPosition, &encodedOffset, sizeof(encodedOffset));
+    existing.close();
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    if (file.write(out) != out.size() || !file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file stationarchive.h
+ * @brief Binarne archiwum pomiarów stacji: plik dopisywany blokami z zakresami czasu i sumami kontrolnymi.
+ */
+
+#ifndef STATIONARCHIVE_H
+#define STATIONARCHIVE_H
+
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <limits>
+#include "sensorseries.h"
+
+/**
+ * @struct ArchivedSensor
+ * @brief Opis sensora zapisany w archiwum.
+ */
+struct ArchivedSensor {
+    int sensorId = 0; ///< Identyfikator sensora.
+    QString paramCode; ///< Kod parametru (np. PM10).
+    QString paramName; ///< Pełna nazwa parametru.
+    QString latestValue; ///< Ostatnia wartość wyświetlona w tabeli.
+};
+
+/**
+ * @struct ArchivedStation
+ * @brief Opis stacji zapisany w archiwum (bez danych pomiarowych).
+ */
+struct ArchivedStation {
+    int stationId = 0; ///< Identyfikator stacji.
+    QString stationName; ///< Nazwa stacji.
+    QString location; ///< Opis lokalizacji (gmina, województwo).
+    QVector<ArchivedSensor> sensors; ///< Sensory stacji w kolejności dodania.
+};
+
+/**
+ * @class StationArchiveReader
+ * @brief Czytnik archiwum mapujący plik do pamięci.
+ *
+ * Plik składa się z nagłówka i ciągu bloków. Każdy blok ma nagłówek z typem, ID stacji i sensora,
+ * zakresem czasu, rozmiarem oraz sumami CRC32 nagłówka i zawartości. Bloki opisowe (stacja, sensor)
+ * późniejsze w pliku zastępują wcześniejsze, a punkty z późniejszych bloków danych nadpisują punkty
+ * o tym samym czasie z wcześniejszych. Uszkodzony lub niedopisany koniec pliku jest pomijany.
+ *
+ * Skompaktowany plik zawiera blok indeksu (wskazywany z nagłówka pliku) z opisami stacji i sensorów
+ * oraz położeniami bloków danych, więc otwarcie wymaga odczytu tylko indeksu i bloków dopisanych po nim.
+ */
+class StationArchiveReader {
+public:
+    /// Położenie i metadane bloku danych.
+    struct DataBlock {
+        int stationId; ///< ID stacji.
+        int sensorId; ///< ID sensora.
+        quint16 encoding; ///< Sposób kodowania zawartości.
+        quint32 count; ///< Liczba punktów.
+        qint64 firstTimestamp; ///< Czas pierwszego punktu.
+        qint64 lastTimestamp; ///< Czas ostatniego punktu.
+        qint64 payloadOffset; ///< Położenie zawartości w pliku.
+        quint32 payloadSize; ///< Rozmiar zawartości w bajtach.
+        quint32 payloadCrc; ///< Suma CRC32 zawartości.
+    };
+
+    StationArchiveReader() = default;
+    ~StationArchiveReader();
+    StationArchiveReader(const StationArchiveReader &) = delete;
+    StationArchiveReader &operator=(const StationArchiveReader &) = delete;
+
+    /**
+     * @brief Otwiera i mapuje plik archiwum, odczytując nagłówki bloków.
+     * @param fileName Ścieżka do pliku.
+     * @return false, jeśli pliku nie da się otworzyć lub nie jest archiwum.
+     */
+    bool open(const QString &fileName);
+    /**
+     * @brief Zwalnia mapowanie i zamyka plik.
+     */
+    void close();
+
+    bool isOpen() const { return data != nullptr; } ///< Czy archiwum jest otwarte.
+    QString fileName() const { return file.fileName(); } ///< Ścieżka do otwartego pliku.
+    QString errorString() const { return error; } ///< Opis ostatniego błędu.
+    const QVector<ArchivedStation> &stations() const { return stationList; } ///< Stacje zapisane w archiwum.
+    qint64 validSize() const { return validEnd; } ///< Rozmiar nieuszkodzonej części pliku w bajtach.
+    int dataBlockCount() const { return dataBlocks.size(); } ///< Liczba bloków danych.
+    bool isDamaged() const { return damaged; } ///< Czy za poprawną częścią jest coś innego niż niedopisany blok.
+
+    /**
+     * @brief Zwraca indeks stacji o podanym ID.
+     * @param stationId Identyfikator stacji.
+     * @return Indeks w stations() lub -1.
+     */
+    int indexOfStation(int stationId) const;
+    /**
+     * @brief Dekoduje szereg pomiarów sensora z jego bloków.
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator sensora.
+     * @param from Pomijane są bloki, których wszystkie punkty są starsze (domyślnie - pełny szereg).
+     * @return Szereg czasowy (pusty, jeśli brak danych).
+     */
+    SensorSeries readSeries(int stationId, int sensorId, qint64 from = std::numeric_limits<qint64>::min()) const;
+    /**
+     * @brief Sprawdza, czy plik jest na tyle pofragmentowany, że warto go skompaktować.
+     * @return true, jeśli bloków danych jest dużo więcej niż sensorów.
+     */
+    bool needsCompaction() const;
+
+private:
+    /**
+     * @brief Przegląda nagłówki bloków i buduje listę stacji oraz bloków danych.
+     * @param from Położenie pierwszego bloku do odczytu.
+     */
+    void scan(qint64 from);
+    /**
+     * @brief Wczytuje blok indeksu.
+     * @param offset Położenie bloku indeksu.
+     * @param end Położenie za blokiem indeksu.
+     * @return false, jeśli indeks jest nieprawidłowy.
+     */
+    bool loadIndex(qint64 offset, qint64 *end);
+    /**
+     * @brief Rejestruje blok danych.
+     * @param block Opis bloku.
+     */
+    void addDataBlock(const DataBlock &block);
+    /**
+     * @brief Zwraca opis stacji, tworząc go w razie potrzeby.
+     * @param stationId Identyfikator stacji.
+     * @return Referencja do opisu stacji.
+     */
+    ArchivedStation &stationFor(int stationId);
+
+    QFile file; ///< Plik archiwum.
+    const uchar *data = nullptr; ///< Zmapowana zawartość pliku.
+    qint64 size = 0; ///< Rozmiar pliku.
+    qint64 validEnd = 0; ///< Koniec ostatniego poprawnego bloku.
+    bool damaged = false; ///< Czy odczyt przerwał uszkodzony nagłówek bloku.
+    QVector<ArchivedStation> stationList; ///< Stacje zapisane w archiwum.
+    QVector<DataBlock> dataBlocks; ///< Bloki danych w kolejności w pliku.
+    QHash<quint64, QVector<int>> sensorBlocks; ///< Indeksy bloków danych kluczowane parą (stacja, sensor).
+    QString error; ///< Opis ostatniego błędu.
+};
+
+/**
+ * @class StationArchiveWriter
+ * @brief Zapis archiwum: dopisywanie nowych godzin i jawna kompakcja.
+ */
+class StationArchiveWriter {
+public:
+    /**
+     * @brief Konstruktor klasy StationArchiveWriter.
+     * @param fileName Ścieżka do pliku archiwum.
+     */
+    explicit StationArchiveWriter(const QString &fileName);
+
+    /**
+     * @brief Dopisuje do archiwum zmienione opisy oraz punkty, których jeszcze w nim nie ma.
+     * @param station Opis stacji i jej sensorów.
+     * @param series Szeregi pomiarów kluczowane ID sensora.
+     * @return false w przypadku błędu zapisu.
+     *
+     * Istniejąca zawartość pliku nie jest przepisywana; koszt zależy od liczby nowych punktów.
+     */
+    bool append(const ArchivedStation &station, const QMap<int, SensorSeries> &series);
+    /**
+     * @brief Przepisuje archiwum tak, by każdy sensor miał jeden opis i ciągłe bloki danych.
+     * @return false w przypadku błędu zapisu.
+     */
+    bool compact();
+
+    QString errorString() const { return error; } ///< Opis ostatniego błędu.
+
+private:
+    QString path; ///< Ścieżka do pliku archiwum.
+    QString error; ///< Opis ostatniego błędu.
+};
+
+#endif // STATIONARCHIVE_H
@@ -0,0 +1,146 @@
+/**
+ * @file stationcatalog.cpp
+ * @brief Implementacja klasy StationCatalog aplikacji GIOSrevamp.
+ */
+
+#include "stationcatalog.h"
+
+/**
+ * @brief Usuwa wszystkie stacje z katalogu.
+ */
+void StationCatalog::clear() {
+    ids.clear();
+    names.clear();
+    cityRefs.clear();
+    cityLowerRefs.clear();
+    communeRefs.clear();
+    provinceRefs.clear();
+    lats.clear();
+    lons.clear();
+    removed.clear();
+    strings.clear();
+    stringIds.clear();
+    idIndex.clear();
+}
+
+/**
+ * @brief Rezerwuje miejsce na podaną liczbę stacji.
+ * @param count Oczekiwana liczba stacji.
+ */
+void StationCatalog::reserve(int count) {
+    ids.reserve(count);
+    names.reserve(count);
+    cityRefs.reserve(count);
+    cityLowerRefs.reserve(count);
+    communeRefs.reserve(count);
+    provinceRefs.reserve(count);
+    lats.reserve(count);
+    lons.reserve(count);
+    removed.reserve(count);
+    idIndex.reserve(count);
+}
+
+/**
+ * @brief Dodaje stację do katalogu.
+ * @param stationId Identyfikator stacji.
+ * @param stationName Nazwa stacji.
+ * @param cityName Nazwa miejscowości.
+ * @param communeName Nazwa gminy.
+ * @param provinceName Nazwa województwa.
+ * @param lat Szerokość geograficzna (NaN, jeśli brak).
+ * @param lon Długość geograficzna (NaN, jeśli brak).
+ * @return Indeks dodanej stacji.
+ */
+int StationCatalog::append(int stationId, const QString &stationName, const QString &cityName,
+                           const QString &communeName, const QString &provinceName, double lat, double lon) {
+    int index = ids.size();
+    ids.append(stationId);
+    names.append(stationName);
+    cityRefs.append(intern(cityName));
+    cityLowerRefs.append(intern(cityName.toLower()));
+    communeRefs.append(intern(communeName));
+    provinceRefs.append(intern(provinceName));
+    lats.append(lat);
+    lons.append(lon);
+    removed.append(false);
+    idIndex.insert(stationId, index);
+    return index;
+}
+
+/**
+ * @brief Uzgadnia katalog z nowszą wersją, porównując stacje według ID.
+ * @param other Nowa wersja katalogu.
+ * @return Indeksy dodanych, zmienionych i usuniętych stacji.
+ *
+ * Nowe stacje są dopisywane na końcu, a zmienione - nadpisywane w miejscu. Usunięte stacje tracą
+ * współrzędne i znikają z wyszukiwania po ID, zachowując indeks. Stacja, która wróci do katalogu, otrzymuje nowy indeks.
+ */
+StationCatalog::Changes StationCatalog::merge(const StationCatalog &other) {
+    Changes changes;
+    const int previousSize = size();
+    for (int j = 0; j < other.size(); ++j) {
+        const int index = indexOf(other.id(j));
+        if (index < 0) {
+            changes.added.append(append(other.id(j), other.name(j), other.city(j), other.commune(j), other.province(j),
+                                        other.latitude(j), other.longitude(j)));
+        } else if (!sameStation(index, other, j)) {
+            names[index] = other.name(j);
+            cityRefs[index] = intern(other.city(j));
+            cityLowerRefs[index] = intern(other.cityLower(j));
+            communeRefs[index] = intern(other.commune(j));
+            provinceRefs[index] = intern(other.province(j));
+            lats[index] = other.latitude(j);
+            lons[index] = other.longitude(j);
+            changes.changed.append(index);
+        }
+    }
+    for (int i = 0; i < previousSize; ++i) {
+        if (!removed[i] && other.indexOf(ids[i]) < 0) {
+            idIndex.remove(ids[i]);
+            lats[i] = qQNaN();
+            lons[i] = qQNaN();
+            removed[i] = true;
+            changes.removed.append(i);
+        }
+    }
+    return changes;
+}
+
+/**
+ * @brief Zwraca identyfikator internowanego napisu, dodając go w razie potrzeby.
+ * @param text Napis do internowania.
+ * @return Indeks napisu w tablicy strings.
+ */
+int StationCatalog::intern(const QString &text) {
+    auto it = stringIds.constFind(text);
+    if (it != stringIds.constEnd()) {
+        return it.value();
+    }
+    int ref = strings.size();
+    strings.append(text);
+    stringIds.insert(text, ref);
+    return ref;
+}
+
+/**
+ * @brief Sprawdza, czy stacja ma te same dane co stacja innego katalogu.
+ * @param index Indeks stacji w tym katalogu.
+ * @param other Inny katalog.
+ * @param otherIndex Indeks stacji w innym katalogu.
+ * @return true, jeśli nazwa, adres i współrzędne są takie same.
+ */
+bool StationCatalog::sameStation(int index, const StationCatalog &other, int otherIndex) const {
+    auto sameCoordinate = [](double a, double b) {
+        /**
+         * @brief Lambda porównująca współrzędne (brak współrzędnej jest równy brakowi).
+         * @param a Pierwsza współrzędna.
+         * @param b Druga współrzędna.
+         * @return Wartość logiczna określająca równość.
+         */
+        return a == b || (qIsNaN(a) && qIsNaN(b));
+    };
+    return name(index) == other.name(otherIndex) && city(index) == other.city(otherIndex)
+           && commune(index) == other.commune(otherIndex) && province(index) == other.province(otherIndex)
+           && sameCoordinate(latitude(index), other.latitude(otherIndex))
+           && sameCoordinate(longitude(index), other.longitude(otherIndex));
+}
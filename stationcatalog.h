@@ -0,0 +1,119 @@
+/**
+ * @file stationcatalog.h
+ * @brief Typowany, indeksowany katalog stacji pomiarowych GIOŚ.
+ */
+
+#ifndef STATIONCATALOG_H
+#define STATIONCATALOG_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QtNumeric>
+
+/**
+ * @class StationCatalog
+ * @brief Katalog stacji przechowywany w postaci kolumnowej (osobne tablice dla każdego pola).
+ *
+ * Budowany jednorazowo z odpowiedzi @c station/findAll (patrz CatalogStreamParser). Nazwy miast, gmin i województw są internowane,
+ * współrzędne sparsowane do liczb, a wyszukiwanie stacji po ID odbywa się w czasie O(1).
+ * Stacje adresowane są indeksem (0..size()-1), który jest stabilny do czasu wywołania clear().
+ * Stacje usunięte przez merge() zachowują swój indeks (bez współrzędnych, oznaczone isRemoved()),
+ * więc struktury indeksowane indeksem stacji nie wymagają przenumerowania.
+ */
+class StationCatalog {
+public:
+    /// Stacje zmienione przez merge().
+    struct Changes {
+        QVector<int> added; ///< Indeksy nowych stacji (dopisanych na końcu katalogu).
+        QVector<int> changed; ///< Indeksy stacji ze zmienioną nazwą, adresem lub współrzędnymi.
+        QVector<int> removed; ///< Indeksy stacji, których nie ma w nowym katalogu.
+
+        bool isEmpty() const { return added.isEmpty() && changed.isEmpty() && removed.isEmpty(); } ///< Czy katalog się nie zmienił.
+    };
+
+    /**
+     * @brief Usuwa wszystkie stacje z katalogu.
+     */
+    void clear();
+    /**
+     * @brief Rezerwuje miejsce na podaną liczbę stacji.
+     * @param count Oczekiwana liczba stacji.
+     */
+    void reserve(int count);
+    /**
+     * @brief Dodaje stację do katalogu.
+     * @param stationId Identyfikator stacji.
+     * @param stationName Nazwa stacji.
+     * @param cityName Nazwa miejscowości.
+     * @param communeName Nazwa gminy.
+     * @param provinceName Nazwa województwa.
+     * @param lat Szerokość geograficzna (NaN, jeśli brak).
+     * @param lon Długość geograficzna (NaN, jeśli brak).
+     * @return Indeks dodanej stacji.
+     */
+    int append(int stationId, const QString &stationName, const QString &cityName,
+               const QString &communeName, const QString &provinceName, double lat, double lon);
+    /**
+     * @brief Uzgadnia katalog z nowszą wersją, porównując stacje według ID.
+     * @param other Nowa wersja katalogu.
+     * @return Indeksy dodanych, zmienionych i usuniętych stacji.
+     */
+    Changes merge(const StationCatalog &other);
+
+    /**
+     * @brief Zwraca indeks stacji o podanym ID.
+     * @param stationId Identyfikator stacji.
+     * @return Indeks stacji lub -1, jeśli jej nie ma.
+     */
+    int indexOf(int stationId) const { return idIndex.value(stationId, -1); }
+
+    int size() const { return ids.size(); } ///< Liczba stacji w katalogu.
+    bool isEmpty() const { return ids.isEmpty(); } ///< Czy katalog jest pusty.
+
+    int id(int index) const { return ids[index]; } ///< Identyfikator stacji.
+    const QString &name(int index) const { return names[index]; } ///< Nazwa stacji.
+    const QString &city(int index) const { return strings[cityRefs[index]]; } ///< Nazwa miejscowości.
+    const QString &cityLower(int index) const { return strings[cityLowerRefs[index]]; } ///< Nazwa miejscowości małymi literami.
+    const QString &commune(int index) const { return strings[communeRefs[index]]; } ///< Nazwa gminy.
+    const QString &province(int index) const { return strings[provinceRefs[index]]; } ///< Nazwa województwa.
+    double latitude(int index) const { return lats[index]; } ///< Szerokość geograficzna.
+    double longitude(int index) const { return lons[index]; } ///< Długość geograficzna.
+    bool hasCoordinates(int index) const { return !qIsNaN(lats[index]) && !qIsNaN(lons[index]); } ///< Czy stacja ma współrzędne.
+    bool isRemoved(int index) const { return removed[index]; } ///< Czy stacja została usunięta przez merge().
+
+    const QVector<double> &latitudes() const { return lats; } ///< Kolumna szerokości geograficznych.
+    const QVector<double> &longitudes() const { return lons; } ///< Kolumna długości geograficznych.
+
+private:
+    /**
+     * @brief Zwraca identyfikator internowanego napisu, dodając go w razie potrzeby.
+     * @param text Napis do internowania.
+     * @return Indeks napisu w tablicy strings.
+     */
+    int intern(const QString &text);
+    /**
+     * @brief Sprawdza, czy stacja ma te same dane co stacja innego katalogu.
+     * @param index Indeks stacji w tym katalogu.
+     * @param other Inny katalog.
+     * @param otherIndex Indeks stacji w innym katalogu.
+     * @return true, jeśli nazwa, adres i współrzędne są takie same.
+     */
+    bool sameStation(int index, const StationCatalog &other, int otherIndex) const;
+
+    QVector<int> ids; ///< Identyfikatory stacji.
+    QVector<QString> names; ///< Nazwy stacji.
+    QVector<int> cityRefs; ///< Indeksy nazw miejscowości w strings.
+    QVector<int> cityLowerRefs; ///< Indeksy nazw miejscowości (małe litery) w strings.
+    QVector<int> communeRefs; ///< Indeksy nazw gmin w strings.
+    QVector<int> provinceRefs; ///< Indeksy nazw województw w strings.
+    QVector<double> lats; ///< Szerokości geograficzne.
+    QVector<double> lons; ///< Długości geograficzne.
+    QVector<bool> removed; ///< Czy stacja została usunięta przez merge().
+    QStringList strings; ///< Internowane napisy.
+    QHash<QString, int> stringIds; ///< Odwzorowanie napis → indeks w strings.
+    QHash<int, int> idIndex; ///< Odwzorowanie ID stacji → indeks.
+};
+
+#endif // STATIONCATALOG_H
@@ -0,0 +1,153 @@
+/**
+ * @file stationfacetindex.cpp
+ * @brief Implementacja indeksów bitowych cech stacji.
+ */
+
+#include "stationfacetindex.h"
+#include <algorithm>
+
+/**
+ * @brief Buduje indeksy województw i gmin dla stacji katalogu.
+ * @param catalog Katalog stacji.
+ */
+void StationFacetIndex::build(const StationCatalog &catalog) {
+    clear();
+    count = catalog.size();
+    parametersKnown = QBitArray(count);
+    present = QBitArray(count, true);
+    for (int i = 0; i < count; ++i) {
+        add(Province, catalog.province(i), i);
+        add(Commune, catalog.commune(i), i);
+    }
+}
+
+/**
+ * @brief Aktualizuje indeksy po zmianie katalogu (StationCatalog::merge()).
+ * @param catalog Katalog stacji.
+ * @param stations Indeksy stacji dodanych, zmienionych lub usuniętych.
+ *
+ * Mapy bitowe są wydłużane o nowe stacje. Zmienione stacje są przenoszone do zbiorów nowego
+ * województwa i gminy, a usunięte - wypisywane ze wszystkich zbiorów. Wartości bez żadnej stacji
+ * są usuwane. Znane parametry pozostałych stacji są zachowywane.
+ */
+void StationFacetIndex::update(const StationCatalog &catalog, const QVector<int> &stations) {
+    count = catalog.size();
+    for (QHash<QString, QBitArray> &facetSets : sets) {
+        for (QBitArray &set : facetSets) {
+            set.resize(count);
+        }
+    }
+    parametersKnown.resize(count);
+    present.resize(count);
+
+    for (int index : stations) {
+        for (Facet facet : {Province, Commune}) {
+            for (QBitArray &set : sets[facet]) {
+                set.clearBit(index);
+            }
+        }
+        if (catalog.isRemoved(index)) {
+            for (QBitArray &set : sets[Parameter]) {
+                set.clearBit(index);
+            }
+            parametersKnown.clearBit(index);
+            present.clearBit(index);
+            continue;
+        }
+        present.setBit(index);
+        add(Province, catalog.province(index), index);
+        add(Commune, catalog.commune(index), index);
+    }
+    for (QHash<QString, QBitArray> &facetSets : sets) {
+        for (auto it = facetSets.begin(); it != facetSets.end();) {
+            it = it->count(true) == 0 ? facetSets.erase(it) : std::next(it);
+        }
+    }
+}
+
+/**
+ * @brief Usuwa zawartość indeksów.
+ */
+void StationFacetIndex::clear() {
+    count = 0;
+    for (QHash<QString, QBitArray> &facetSets : sets) {
+        facetSets.clear();
+    }
+    parametersKnown.clear();
+    present.clear();
+}
+
+/**
+ * @brief Zapisuje parametry mierzone przez stację.
+ * @param index Indeks stacji w katalogu.
+ * @param sensors Sensory stacji.
+ * @return true, jeśli pojawił się nowy kod parametru.
+ *
+ * Ponowne wywołanie dla tej samej stacji zastępuje jej poprzednie parametry.
+ */
+bool StationFacetIndex::setParameters(int index, const QVector<SensorDescriptor> &sensors) {
+    if (index < 0 || index >= count) {
+        return false;
+    }
+    if (parametersKnown.testBit(index)) {
+        for (QBitArray &set : sets[Parameter]) {
+            set.clearBit(index);
+        }
+    }
+    parametersKnown.setBit(index);
+
+    bool created = false;
+    for (const SensorDescriptor &sensor : sensors) {
+        created |= add(Parameter, sensor.paramCode, index);
+    }
+    return created;
+}
+
+/**
+ * @brief Zwraca wartości cechy występujące w katalogu.
+ * @param facet Cecha.
+ * @return Wartości posortowane alfabetycznie.
+ */
+QStringList StationFacetIndex::values(Facet facet) const {
+    QStringList result = sets[facet].keys();
+    std::sort(result.begin(), result.end(), [](const QString &a, const QString &b) {
+        /**
+         * @brief Lambda porównująca wartości zgodnie z ustawieniami regionalnymi (polskie litery).
+         * @param a Pierwsza wartość.
+         * @param b Druga wartość.
+         * @return Wartość logiczna określająca kolejność.
+         */
+        return QString::localeAwareCompare(a, b) < 0;
+    });
+    return result;
+}
+
+/**
+ * @brief Zwraca stacje o podanej wartości cechy.
+ * @param facet Cecha.
+ * @param value Wartość cechy.
+ * @return Mapa bitowa stacji (same zera dla nieznanej wartości).
+ */
+QBitArray StationFacetIndex::stations(Facet facet, const QString &value) const {
+    return sets[facet].value(value, QBitArray(count));
+}
+
+/**
+ * @brief Ustawia bit stacji w zbiorze wartości cechy, tworząc zbiór w razie potrzeby.
+ * @param facet Cecha.
+ * @param value Wartość cechy (pusta jest pomijana).
+ * @param index Indeks stacji w katalogu.
+ * @return true, jeśli zbiór wartości został utworzony.
+ */
+bool StationFacetIndex::add(Facet facet, const QString &value, int index) {
+    if (value.isEmpty()) {
+        return false;
+    }
+    auto it = sets[facet].find(value);
+    const bool created = it == sets[facet].end();
+    if (created) {
+        it = sets[facet].insert(value, QBitArray(count));
+    }
+    it->setBit(index);
+    return created;
+}
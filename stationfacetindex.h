@@ -0,0 +1,102 @@
+/**
+ * @file stationfacetindex.h
+ * @brief Indeksy bitowe stacji według województwa, gminy i mierzonego parametru.
+ */
+
+#ifndef STATIONFACETINDEX_H
+#define STATIONFACETINDEX_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "giosstreamparsers.h"
+#include "stationcatalog.h"
+
+/**
+ * @class StationFacetIndex
+ * @brief Zbiory stacji (mapy bitowe indeksowane indeksem stacji w katalogu) dla każdej wartości cechy.
+ *
+ * Województwa i gminy pochodzą z katalogu, a kody parametrów z list sensorów stacji (@c station/sensors),
+ * dopisywanych w miarę ich pobierania. Warunki filtrów łączone są operacjami na mapach bitowych
+ * (AND - część wspólna, OR - suma), bez przeglądania stacji.
+ */
+class StationFacetIndex {
+public:
+    /// Cecha stacji.
+    enum Facet {
+        Province, ///< Województwo.
+        Commune, ///< Gmina.
+        Parameter, ///< Kod mierzonego parametru (np. PM2.5).
+        FacetCount ///< Liczba cech.
+    };
+
+    /**
+     * @brief Buduje indeksy województw i gmin dla stacji katalogu.
+     * @param catalog Katalog stacji.
+     *
+     * Indeks parametrów jest pusty do czasu wywołań setParameters().
+     */
+    void build(const StationCatalog &catalog);
+    /**
+     * @brief Aktualizuje indeksy po zmianie katalogu (StationCatalog::merge()).
+     * @param catalog Katalog stacji.
+     * @param stations Indeksy stacji dodanych, zmienionych lub usuniętych.
+     */
+    void update(const StationCatalog &catalog, const QVector<int> &stations);
+    /**
+     * @brief Usuwa zawartość indeksów.
+     */
+    void clear();
+
+    /**
+     * @brief Zapisuje parametry mierzone przez stację.
+     * @param index Indeks stacji w katalogu.
+     * @param sensors Sensory stacji.
+     * @return true, jeśli pojawił się nowy kod parametru.
+     */
+    bool setParameters(int index, const QVector<SensorDescriptor> &sensors);
+    /**
+     * @brief Sprawdza, czy parametry stacji są już znane.
+     * @param index Indeks stacji w katalogu.
+     * @return true po wywołaniu setParameters() dla stacji.
+     */
+    bool hasParameters(int index) const { return parametersKnown.testBit(index); }
+
+    /**
+     * @brief Zwraca wartości cechy występujące w katalogu.
+     * @param facet Cecha.
+     * @return Wartości posortowane alfabetycznie.
+     */
+    QStringList values(Facet facet) const;
+    /**
+     * @brief Zwraca stacje o podanej wartości cechy.
+     * @param facet Cecha.
+     * @param value Wartość cechy.
+     * @return Mapa bitowa stacji (same zera dla nieznanej wartości).
+     */
+    QBitArray stations(Facet facet, const QString &value) const;
+    /**
+     * @brief Zwraca mapę bitową wszystkich stacji.
+     * @return Mapa bitowa z ustawionymi bitami wszystkich stacji, które nie zostały usunięte z katalogu.
+     */
+    QBitArray allStations() const { return present; }
+
+private:
+    /**
+     * @brief Ustawia bit stacji w zbiorze wartości cechy, tworząc zbiór w razie potrzeby.
+     * @param facet Cecha.
+     * @param value Wartość cechy (pusta jest pomijana).
+     * @param index Indeks stacji w katalogu.
+     * @return true, jeśli zbiór wartości został utworzony.
+     */
+    bool add(Facet facet, const QString &value, int index);
+
+    int count = 0; ///< Liczba stacji w katalogu.
+    QHash<QString, QBitArray> sets[FacetCount]; ///< Wartość cechy → mapa bitowa stacji, osobno dla każdej cechy.
+    QBitArray parametersKnown; ///< Stacje, dla których znane są parametry.
+    QBitArray present; ///< Stacje, które nie zostały usunięte z katalogu.
+};
+
+#endif // STATIONFACETINDEX_H
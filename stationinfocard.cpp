@@ -4,6 +4,7 @@
  */
 
 #include "stationinfocard.h"
+#include "giostime.h"
 #include <QPropertyAnimation>
 #include <QDebug>
 #include <QPalette>
@@ -18,15 +19,19 @@
 #include <QDateTime>
 #include <QCoreApplication>
 #include <QDir>
+#include <QFileInfo>
+#include <QSignalBlocker>
+#include <memory>
 
 /**
  * @brief Konstruktor klasy StationInfoCard.
+ * @param client Wspólny klient API GIOŚ.
  * @param parent Wskaźnik do nadrzędnego widgetu (domyślnie nullptr).
  *
  * Inicjalizuje interfejs karty informacyjnej, ustawia style i połączenia sygnałów.
  */
-StationInfoCard::StationInfoCard(QWidget *parent)
-    : QFrame(parent), networkManager(new QNetworkAccessManager(this)), pendingRequests(0), currentTimeRange("Dzień") {
+StationInfoCard::StationInfoCard(GiosClient *client, QWidget *parent)
+    : QFrame(parent), client(client), stationRequests(nullptr), pendingRequests(0), currentStationId(0), currentTimeRange("Dzień") {
     // Ustawienie karty jako pełnoekranowej względem rodzica
     setAutoFillBackground(true);
     setStyleSheet("StationInfoCard { background-color: #f0f0f0; border: 1px solid #ccc; border-radius: 5px; }");
@@ -115,7 +120,7 @@ StationInfoCard::StationInfoCard(QWidget *parent)
     // Dynamiczne ustawienie szerokości na podstawie najdłuższego kodu parametru (PM2.5)
     QFontMetrics fm(sensorComboBox->font());
     sensorComboBox->setFixedWidth(fm.boundingRect("PM2.5").width() + 30);
-    connect(sensorComboBox, &QComboBox::currentTextChanged, this, &StationInfoCard::onSensorSelectionChanged);
+    connect(sensorComboBox, &QComboBox::currentIndexChanged, this, &StationInfoCard::onSensorSelectionChanged);
 
     // Utworzenie listy rozwijanej dla zakresu czasu
     timeRangeComboBox = new QComboBox(this);
@@ -238,15 +243,22 @@ void StationInfoCard::setupChart() {
 void StationInfoCard::showStationData(int stationId, const QString &stationName, const QString &communeName, const QString &provinceName) {
     qDebug() << "Pokazywanie danych dla stacji ID:" << stationId << "Nazwa:" << stationName << "Gmina:" << communeName << "Województwo:" << provinceName;
 
+    // Porzuć zapytania poprzedniej stacji - ich odpowiedzi nie mogą trafić do tabeli nowej
+    cancelRequests();
+    stationRequests = new QObject(this);
+
     // Ustaw nazwę stacji i lokalizację
+    currentStationId = stationId;
+    sourceArchive.reset();
+    archivedSensors.clear();
     stationNameLabel->setText(stationName);
     locationLabel->setText(QString("%1, %2").arg(communeName, provinceName));
 
     // Wyczyść poprzednie dane
     sensorData.clear();
-    sensorValues.clear();
+    sensorSeries.clear();
+    sensorParams.clear();
     sensorComboBox->clear();
-    pendingRequests = 0;
     dataTable->setColumnCount(0);
     chart->removeAllSeries();
     // Wyczyść nowe etykiety
@@ -262,19 +274,7 @@ void StationInfoCard::showStationData(int stationId, const QString &stationName,
     }
 
     // Pobierz listę sensorów dla stacji
-    QUrl url(QString("https://api.gios.gov.pl/pjp-api/rest/station/sensors/%1").arg(stationId));
-    qDebug() << "Wysyłanie zapytania do:" << url.toString();
-    QNetworkRequest request;
-    request.setUrl(url);
-    request.setHeader(QNetworkRequest::UserAgentHeader, "MyStationFinderApp/1.0");
-    QNetworkReply *reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        /**
-         * @brief Lambda obsługująca zakończenie zapytania o sensory.
-         * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
-         */
-        onSensorsReplyFinished(reply);
-    });
+    requestSensors(stationId);
 
     // Dopasuj rozmiar do rodzica i pokaż kartę
     if (parentWidget()) {
@@ -286,24 +286,143 @@ void StationInfoCard::showStationData(int stationId, const QString &stationName,
     animateIn();
 }
 
+/**
+ * @brief Przerywa wszystkie zapytania wyświetlanej stacji.
+ *
+ * Zapytania są wysyłane w kontekście obiektu stationRequests; jego usunięcie przerywa trwające
+ * odpowiedzi, usuwa oczekujące z kolejki klienta i gwarantuje, że spóźnione wyniki nie zostaną
+ * przekazane do karty.
+ */
+void StationInfoCard::cancelRequests() {
+    if (stationRequests) {
+        qDebug() << "Przerywanie zapytań stacji:" << currentStationId;
+        delete stationRequests;
+        stationRequests = nullptr;
+    }
+    pendingRequests = 0;
+}
+
+/**
+ * @brief Wysyła zapytanie o listę sensorów stacji.
+ * @param stationId Identyfikator stacji.
+ */
+void StationInfoCard::requestSensors(int stationId) {
+    client->fetchSensors(stationId, stationRequests, [this](const GiosResult &result, const QVector<SensorDescriptor> &sensors) {
+        /**
+         * @brief Lambda obsługująca zakończenie zapytania o sensory.
+         */
+        onSensorsReplyFinished(result, sensors);
+    });
+}
+
+/**
+ * @brief Wysyła zapytanie o dane historyczne sensora.
+ * @param sensorId Identyfikator sensora.
+ * @param column Numer kolumny w tabeli danych.
+ * @param priority Priorytet zapytania w kolejce klienta.
+ */
+void StationInfoCard::requestSensorData(int sensorId, int column, GiosClient::Priority priority) {
+    client->fetchData(sensorId, stationRequests, [this, column, sensorId](const GiosResult &result, SensorSeries &series) {
+        /**
+         * @brief Lambda obsługująca zakończenie zapytania o dane sensora.
+         * @param column Numer kolumny w tabeli.
+         * @param sensorId Identyfikator sensora.
+         */
+        onDataReplyFinished(result, series, column, sensorId);
+    }, priority);
+}
+
 /**
  * @brief Wyświetla dane wczytane z pliku JSON.
  * @param stationName Nazwa stacji.
  * @param location Lokalizacja stacji.
  * @param sensors Tablica danych sensorów.
  *
- * Wypełnia kartę danymi z pliku i aktualizuje wykres.
+ * Obsługuje pliki zapisane przez starsze wersje aplikacji.
  */
 void StationInfoCard::showDataFromFile(const QString &stationName, const QString &location, const QJsonArray &sensors) {
     qDebug() << "Pokazywanie danych z pliku dla stacji:" << stationName << "Lokalizacja:" << location;
 
+    sourceArchive.reset();
+    archivedSensors.clear();
+
+    ArchivedStation station;
+    station.stationName = stationName;
+    station.location = location;
+    QMap<int, SensorSeries> histories;
+
+    int column = 0;
+    for (const QJsonValue &sensorValue : sensors) {
+        QJsonObject sensorObj = sensorValue.toObject();
+        ArchivedSensor sensor;
+        sensor.paramCode = sensorObj["paramCode"].toString();
+        sensor.paramName = sensorObj["paramName"].toString();
+        sensor.latestValue = sensorObj["latestValue"].toString();
+        // Starsze pliki nie zawierają ID sensora - nadaj unikalne ID zastępcze
+        sensor.sensorId = sensorObj.contains("sensorId") ? sensorObj["sensorId"].toInt() : -(column + 1);
+        histories[sensor.sensorId] = SensorSeries::fromJson(sensorObj["historicalData"].toArray());
+        station.sensors.append(sensor);
+        column++;
+    }
+
+    showStoredStation(station, histories);
+}
+
+/**
+ * @brief Wyświetla stację zapisaną w archiwum binarnym.
+ * @param archive Otwarte archiwum (karta przechowuje je do czasu zdekodowania wszystkich sensorów).
+ * @param stationIndex Indeks stacji w archiwum.
+ *
+ * Historia sensora dekodowana jest dopiero przy pierwszym wyświetleniu jego wykresu.
+ */
+void StationInfoCard::showDataFromArchive(const std::shared_ptr<StationArchiveReader> &archive, int stationIndex) {
+    const ArchivedStation station = archive->stations()[stationIndex];
+    qDebug() << "Pokazywanie danych z archiwum dla stacji:" << station.stationName << "Lokalizacja:" << station.location;
+
+    sourceArchive = archive;
+    archivedSensors.clear();
+    for (const ArchivedSensor &sensor : station.sensors) {
+        archivedSensors.insert(sensor.sensorId);
+    }
+
+    showStoredStation(station, QMap<int, SensorSeries>());
+}
+
+/**
+ * @brief Dekoduje z archiwum historię sensora, jeśli nie została jeszcze wczytana.
+ * @param sensorId Identyfikator sensora.
+ *
+ * Punkty dodane w międzyczasie w pamięci mają pierwszeństwo przed zapisanymi.
+ */
+void StationInfoCard::ensureSeriesLoaded(int sensorId) {
+    if (!archivedSensors.remove(sensorId) || !sourceArchive || !sourceArchive->isOpen()) {
+        return;
+    }
+    SensorSeries stored = sourceArchive->readSeries(currentStationId, sensorId);
+    stored.merge(sensorSeries.value(sensorId));
+    sensorSeries[sensorId] = stored;
+    if (archivedSensors.isEmpty()) {
+        sourceArchive.reset();
+    }
+}
+
+/**
+ * @brief Wypełnia kartę zapisanymi danymi stacji i pokazuje ją.
+ * @param station Opis stacji i jej sensorów.
+ * @param histories Szeregi pomiarów kluczowane ID sensora.
+ */
+void StationInfoCard::showStoredStation(const ArchivedStation &station, const QMap<int, SensorSeries> &histories) {
+    cancelRequests();
+
     // Ustaw nazwę stacji i lokalizację
-    stationNameLabel->setText(stationName);
-    locationLabel->setText(location);
+    currentStationId = station.stationId;
+    stationNameLabel->setText(station.stationName);
+    locationLabel->setText(station.location);
 
     // Wyczyść poprzednie dane
     sensorData.clear();
-    sensorValues.clear();
+    sensorSeries.clear();
+    sensorParams.clear();
     sensorComboBox->clear();
     dataTable->setColumnCount(0);
     chart->removeAllSeries();
@@ -320,8 +439,8 @@ void StationInfoCard::showDataFromFile(const QString &stationName, const QString
         axisX->setRange(now.addDays(-1), now);
     }
 
-    // Przetwarzaj sensory z pliku
-    if (sensors.isEmpty()) {
+    // Przetwarzaj zapisane sensory
+    if (station.sensors.isEmpty()) {
         sensorData.append("Brak danych sensorów w pliku.");
         dataTable->setRowCount(1);
         dataTable->setColumnCount(1);
@@ -331,14 +450,17 @@ void StationInfoCard::showDataFromFile(const QString &stationName, const QString
         dataTable->resizeColumnsToContents();
         adjustTableWidth();
     } else {
-        dataTable->setColumnCount(sensors.size());
+        dataTable->setColumnCount(station.sensors.size());
         int column = 0;
 
-        for (const QJsonValue &sensorValue : sensors) {
-            QJsonObject sensor = sensorValue.toObject();
-            QString paramCode = sensor["paramCode"].toString();
-            QString latestValue = sensor["latestValue"].toString();
-            QJsonArray historicalData = sensor["historicalData"].toArray();
+        // Pierwsze addItem() zmienia bieżący indeks listy; wykres (i dekodowanie historii z archiwum)
+        // odświeża jedno wywołanie updateChart() po wypełnieniu karty
+        QSignalBlocker blocker(sensorComboBox);
+        for (const ArchivedSensor &sensor : station.sensors) {
+            const QString &paramCode = sensor.paramCode;
+            if (!sensor.paramName.isEmpty()) {
+                paramNames[paramCode] = sensor.paramName;
+            }
 
             // Dodaj kod parametru do pierwszego wiersza
             QTableWidgetItem *paramItem = new QTableWidgetItem(paramCode);
@@ -349,20 +471,22 @@ void StationInfoCard::showDataFromFile(const QString &stationName, const QString
             } else {
                 paramItem->setToolTip(paramCode);
             }
+            paramItem->setData(Qt::UserRole, sensor.sensorId);
             dataTable->setItem(0, column, paramItem);
 
             // Dodaj wartość do drugiego wiersza
-            QTableWidgetItem *valueItem = new QTableWidgetItem(latestValue);
+            QTableWidgetItem *valueItem = new QTableWidgetItem(sensor.latestValue);
             valueItem->setTextAlignment(Qt::AlignCenter);
             valueItem->setForeground(Qt::white);
             dataTable->setItem(1, column, valueItem);
 
-            // Dodaj paramCode do listy rozwijanej
-            sensorComboBox->addItem(paramCode);
-
             // Zapisz dane historyczne
-            sensorValues[paramCode] = historicalData;
-            sensorData.append(latestValue);
+            sensorParams[sensor.sensorId] = paramCode;
+            sensorSeries[sensor.sensorId] = histories.value(sensor.sensorId);
+            sensorData.append(sensor.latestValue);
+
+            // Dodaj paramCode do listy rozwijanej
+            sensorComboBox->addItem(paramCode, sensor.sensorId);
 
             column++;
         }
@@ -371,13 +495,14 @@ void StationInfoCard::showDataFromFile(const QString &stationName, const QString
         if (sensorComboBox->count() > 0) {
             sensorComboBox->setCurrentIndex(0);
         }
+        blocker.unblock();
 
         dataTable->resizeColumnsToContents();
         adjustTableWidth();
 
         // Zaktualizuj wykres dla pierwszego sensora
         if (sensorComboBox->count() > 0) {
-            updateChart(sensorComboBox->currentText());
+            updateChart(sensorComboBox->currentData().toInt());
         }
     }
 
@@ -392,20 +517,30 @@ void StationInfoCard::showDataFromFile(const QString &stationName, const QString
 }
 
 /**
- * @brief Obsługuje odpowiedź API z danymi sensorów.
- * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
+ * @brief Obsługuje odpowiedź API z listą sensorów.
+ * @param result Wynik zapytania.
+ * @param sensors Sensory stacji.
  *
- * Parsuje listę sensorów i inicjuje pobieranie danych historycznych.
+ * Wypełnia tabelę kodami parametrów i inicjuje pobieranie danych historycznych.
  */
-void StationInfoCard::onSensorsReplyFinished(QNetworkReply *reply) {
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray rawData = reply->readAll();
-        qDebug() << "Odpowiedź API GIOŚ (sensory):" << rawData;
-
-        QJsonDocument doc = QJsonDocument::fromJson(rawData);
-        if (doc.isNull()) {
-            qDebug() << "Błąd: Nie udało się sparsować JSON z sensorów.";
-            sensorData.append("Błąd: Nieprawidłowy format danych sensorów.");
+void StationInfoCard::onSensorsReplyFinished(const GiosResult &result, const QVector<SensorDescriptor> &sensors) {
+    if (result.status == GiosResult::ParseError) {
+        qDebug() << "Błąd: Nie udało się sparsować JSON z sensorów:" << result.errorString;
+        sensorData.append("Błąd: Nieprawidłowy format danych sensorów.");
+        dataTable->setRowCount(1);
+        dataTable->setColumnCount(1);
+        QTableWidgetItem *item = new QTableWidgetItem("Obecnie Brak Danych");
+        item->setForeground(Qt::white);
+        dataTable->setItem(0, 0, item);
+        dataTable->resizeColumnsToContents();
+        adjustTableWidth();
+    } else if (result.ok()) {
+        pendingRequests = sensors.size();
+        qDebug() << "Znaleziono" << sensors.size() << "sensorów";
+        emit sensorsLoaded(currentStationId, sensors);
+
+        if (sensors.isEmpty()) {
+            sensorData.append("Brak danych sensorów dla tej stacji.");
             dataTable->setRowCount(1);
             dataTable->setColumnCount(1);
             QTableWidgetItem *item = new QTableWidgetItem("Obecnie Brak Danych");
@@ -414,69 +549,39 @@ void StationInfoCard::onSensorsReplyFinished(QNetworkReply *reply) {
             dataTable->resizeColumnsToContents();
             adjustTableWidth();
         } else {
-            QJsonArray sensors = doc.array();
-            pendingRequests = sensors.size();
-            qDebug() << "Znaleziono" << sensors.size() << "sensorów";
-
-            if (sensors.isEmpty()) {
-                sensorData.append("Brak danych sensorów dla tej stacji.");
-                dataTable->setRowCount(1);
-                dataTable->setColumnCount(1);
-                QTableWidgetItem *item = new QTableWidgetItem("Obecnie Brak Danych");
-                item->setForeground(Qt::white);
-                dataTable->setItem(0, 0, item);
-                dataTable->resizeColumnsToContents();
-                adjustTableWidth();
-            } else {
-                dataTable->setColumnCount(sensors.size());
-                int column = 0;
-
-                for (const QJsonValue &sensorValue : sensors) {
-                    QJsonObject sensor = sensorValue.toObject();
-                    int sensorId = sensor["id"].toInt();
-                    QString paramCode = sensor["param"].toObject()["paramCode"].toString();
-
-                    // Dodaj kod parametru do pierwszego wiersza
-                    QTableWidgetItem *paramItem = new QTableWidgetItem(paramCode);
-                    paramItem->setTextAlignment(Qt::AlignCenter);
-                    paramItem->setForeground(Qt::white);
-                    if (paramNames.contains(paramCode)) {
-                        paramItem->setToolTip(paramNames[paramCode]);
-                    } else {
-                        paramItem->setToolTip(paramCode);
-                    }
-                    dataTable->setItem(0, column, paramItem);
-
-                    // Dodaj paramCode do listy rozwijanej
-                    sensorComboBox->addItem(paramCode, paramCode);
-
-                    // Pobierz dane dla sensora
-                    QUrl dataUrl(QString("https://api.gios.gov.pl/pjp-api/rest/data/getData/%1").arg(sensorId));
-                    qDebug() << "Wysyłanie zapytania o dane do:" << dataUrl.toString();
-                    QNetworkRequest dataRequest;
-                    dataRequest.setUrl(dataUrl);
-                    dataRequest.setHeader(QNetworkRequest::UserAgentHeader, "MyStationFinderApp/1.0");
-                    QNetworkReply *dataReply = networkManager->get(dataRequest);
-                    connect(dataReply, &QNetworkReply::finished, this, [this, column, paramCode]() {
-                        /**
-                         * @brief Lambda obsługująca zakończenie zapytania o dane sensora.
-                         * @param column Numer kolumny w tabeli.
-                         * @param paramCode Kod parametru sensora.
-                         */
-                        QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-                        if (reply) {
-                            onDataReplyFinished(reply, column, paramCode);
-                        }
-                    });
-
-                    column++;
+            dataTable->setColumnCount(sensors.size());
+            int column = 0;
+
+            for (const SensorDescriptor &sensor : sensors) {
+                int sensorId = sensor.id;
+                QString paramCode = sensor.paramCode;
+
+                // Dodaj kod parametru do pierwszego wiersza
+                QTableWidgetItem *paramItem = new QTableWidgetItem(paramCode);
+                paramItem->setTextAlignment(Qt::AlignCenter);
+                paramItem->setForeground(Qt::white);
+                if (paramNames.contains(paramCode)) {
+                    paramItem->setToolTip(paramNames[paramCode]);
+                } else {
+                    paramItem->setToolTip(paramCode);
                 }
-                dataTable->resizeColumnsToContents();
-                adjustTableWidth();
+                paramItem->setData(Qt::UserRole, sensorId);
+                dataTable->setItem(0, column, paramItem);
+
+                // Dodaj paramCode do listy rozwijanej
+                sensorParams[sensorId] = paramCode;
+                sensorComboBox->addItem(paramCode, sensorId);
+
+                // Pobierz dane dla sensora - wyświetlany sensor (pierwszy) ma pierwszeństwo
+                requestSensorData(sensorId, column, column == 0 ? GiosClient::Visible : GiosClient::Table);
+
+                column++;
             }
+            dataTable->resizeColumnsToContents();
+            adjustTableWidth();
         }
     } else {
-        qDebug() << "Błąd pobierania sensorów:" << reply->errorString();
+        qDebug() << "Błąd pobierania sensorów:" << result.errorString;
         sensorData.append("Błąd: Nie udało się pobrać danych sensorów.");
         dataTable->setRowCount(1);
         dataTable->setColumnCount(1);
@@ -486,59 +591,49 @@ void StationInfoCard::onSensorsReplyFinished(QNetworkReply *reply) {
         dataTable->resizeColumnsToContents();
         adjustTableWidth();
     }
-    reply->deleteLater();
 }
 
 /**
  * @brief Obsługuje odpowiedź API z danymi historycznymi sensora.
- * @param reply Wskaźnik do obiektu odpowiedzi sieciowej.
+ * @param result Wynik zapytania.
+ * @param series Szereg pomiarów sensora.
  * @param column Numer kolumny w tabeli danych.
- * @param paramCode Kod parametru sensora.
+ * @param sensorId Identyfikator sensora.
  *
  * Aktualizuje tabelę i wykres danymi sensora.
  */
-void StationInfoCard::onDataReplyFinished(QNetworkReply *reply, int column, const QString paramCode) {
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray rawData = reply->readAll();
-        qDebug() << "Odpowiedź API GIOŚ (dane sensora, paramCode:" << paramCode << "):" << rawData;
-
-        QJsonDocument doc = QJsonDocument::fromJson(rawData);
-        if (!doc.isNull()) {
-            QJsonObject data = doc.object();
-            QJsonArray values = data["values"].toArray();
-            QString valueText = "Brak danych";
-
-            if (!values.isEmpty()) {
-                QJsonObject latestValue = values[0].toObject();
-                if (latestValue.contains("value") && !latestValue["value"].isNull()) {
-                    double value = latestValue["value"].toDouble();
-                    valueText = QString::number(value, 'f', 1);
-                }
-            }
+void StationInfoCard::onDataReplyFinished(const GiosResult &result, SensorSeries &series, int column, int sensorId) {
+    if (result.ok()) {
+        // Daty są parsowane tylko raz - wykres i statystyki czytają gotowy szereg
+        QString valueText = "Brak danych";
+
+        int latest = series.latestIndex();
+        if (latest >= 0 && !series.isNull(latest)) {
+            valueText = QString::number(series.value(latest), 'f', 1);
+        }
 
-            QTableWidgetItem *valueItem = new QTableWidgetItem(valueText);
-            valueItem->setTextAlignment(Qt::AlignCenter);
-            valueItem->setForeground(Qt::white);
-            dataTable->setItem(1, column, valueItem);
-            sensorData.append(valueText);
+        QTableWidgetItem *valueItem = new QTableWidgetItem(valueText);
+        valueItem->setTextAlignment(Qt::AlignCenter);
+        valueItem->setForeground(Qt::white);
+        dataTable->setItem(1, column, valueItem);
+        sensorData.append(valueText);
 
-            // Zapisz dane sensora
-            sensorValues[paramCode] = values;
+        // Zapisz dane sensora
+        sensorSeries[sensorId] = std::move(series);
 
-            // Jeśli to pierwszy sensor, zaktualizuj wykres
-            if (sensorComboBox->count() > 0 && sensorComboBox->currentIndex() == column) {
-                updateChart(paramCode);
-            }
-        } else {
-            qDebug() << "Błąd: Nie udało się sparsować JSON z danych sensora.";
-            QTableWidgetItem *valueItem = new QTableWidgetItem("Błąd");
-            valueItem->setTextAlignment(Qt::AlignCenter);
-            valueItem->setForeground(Qt::white);
-            dataTable->setItem(1, column, valueItem);
-            sensorData.append("Błąd");
+        // Jeśli to wybrany sensor, zaktualizuj wykres
+        if (sensorComboBox->count() > 0 && sensorComboBox->currentIndex() == column) {
+            updateChart(sensorId);
         }
+    } else if (result.status == GiosResult::ParseError) {
+        qDebug() << "Błąd: Nie udało się sparsować JSON z danych sensora:" << result.errorString;
+        QTableWidgetItem *valueItem = new QTableWidgetItem("Błąd");
+        valueItem->setTextAlignment(Qt::AlignCenter);
+        valueItem->setForeground(Qt::white);
+        dataTable->setItem(1, column, valueItem);
+        sensorData.append("Błąd");
     } else {
-        qDebug() << "Błąd pobierania danych sensora:" << reply->errorString();
+        qDebug() << "Błąd pobierania danych sensora:" << result.errorString;
         QTableWidgetItem *valueItem = new QTableWidgetItem("Błąd");
         valueItem->setTextAlignment(Qt::AlignCenter);
         valueItem->setForeground(Qt::white);
@@ -546,7 +641,6 @@ void StationInfoCard::onDataReplyFinished(QNetworkReply *reply, int column, cons
         sensorData.append("Błąd");
     }
 
-    reply->deleteLater();
     pendingRequests--;
 
     if (pendingRequests == 0) {
@@ -557,20 +651,29 @@ void StationInfoCard::onDataReplyFinished(QNetworkReply *reply, int column, cons
         adjustTableWidth();
 
         if (sensorComboBox->count() > 0) {
-            updateChart(sensorComboBox->currentData().toString());
+            updateChart(sensorComboBox->currentData().toInt());
         }
     }
 }
 
 /**
  * @brief Obsługuje zmianę wybranego sensora.
- * @param paramCode Kod wybranego parametru.
+ * @param index Indeks wybranej pozycji w liście sensorów.
  *
- * Aktualizuje wykres dla nowo wybranego sensora.
+ * Aktualizuje wykres dla nowo wybranego sensora. Jeśli jego dane nie zostały jeszcze pobrane,
+ * zapytanie przesuwane jest na początek kolejki, a poprzednio wybrany sensor wraca do zwykłego priorytetu.
  */
-void StationInfoCard::onSensorSelectionChanged(const QString paramCode) {
-    qDebug() << "Wybrano sensor:" << paramCode;
-    updateChart(paramCode);
+void StationInfoCard::onSensorSelectionChanged(int index) {
+    if (index < 0) {
+        return;
+    }
+    int sensorId = sensorComboBox->itemData(index).toInt();
+    qDebug() << "Wybrano sensor:" << sensorComboBox->itemText(index) << "ID:" << sensorId;
+    for (int i = 0; i < sensorComboBox->count(); ++i) {
+        client->setDataPriority(sensorComboBox->itemData(i).toInt(), stationRequests,
+                                i == index ? GiosClient::Visible : GiosClient::Table);
+    }
+    updateChart(sensorId);
 }
 
 /**
@@ -582,19 +685,21 @@ void StationInfoCard::onSensorSelectionChanged(const QString paramCode) {
 void StationInfoCard::onTimeRangeChanged(const QString timeRange) {
     qDebug() << "Wybrano zakres czasu:" << timeRange;
     currentTimeRange = timeRange;
-    if (sensorComboBox->count() > 0 && !sensorComboBox->currentText().isEmpty()) {
-        updateChart(sensorComboBox->currentText());
+    if (sensorComboBox->count() > 0 && sensorComboBox->currentIndex() >= 0) {
+        updateChart(sensorComboBox->currentData().toInt());
     }
 }
 
 /**
  * @brief Aktualizuje wykres dla wybranego sensora.
- * @param paramCode Kod parametru sensora.
+ * @param sensorId Identyfikator sensora.
  *
  * Rysuje wykres danych historycznych sensora z uwzględnieniem zakresu czasu.
  */
-void StationInfoCard::updateChart(const QString paramCode) {
-    qDebug() << "Aktualizowanie wykresu dla paramCode:" << paramCode;
+void StationInfoCard::updateChart(int sensorId) {
+    ensureSeriesLoaded(sensorId);
+    QString paramCode = sensorParams.value(sensorId);
+    qDebug() << "Aktualizowanie wykresu dla sensora:" << sensorId << "paramCode:" << paramCode;
 
     // Wyczyść poprzednie serie i osie
     chart->removeAllSeries();
@@ -615,8 +720,8 @@ void StationInfoCard::updateChart(const QString paramCode) {
     averageValueLabel->setText("Średnia wartość: Brak danych");
     trendLabel->setText("Trend: Brak danych");
 
-    if (!sensorValues.contains(paramCode)) {
-        qDebug() << "Brak danych dla paramCode:" << paramCode;
+    if (!sensorSeries.contains(sensorId)) {
+        qDebug() << "Brak danych dla sensora:" << sensorId;
         chart->setTitle(paramNames.value(paramCode, paramCode));
         setupChart();
         return;
@@ -625,7 +730,7 @@ void StationInfoCard::updateChart(const QString paramCode) {
     QLineSeries *series = new QLineSeries();
     series->setPen(QPen(QColor(135, 206, 250), 2));
 
-    QJsonArray values = sensorValues[paramCode];
+    const SensorSeries &values = sensorSeries[sensorId];
     double lastValue = 0.0;
     bool hasData = false;
     QDateTime minDateTime = QDateTime::currentDateTime();
@@ -634,7 +739,7 @@ void StationInfoCard::updateChart(const QString paramCode) {
     // Zmienne do obliczania min, max, średniej i trendu
     double minValue = std::numeric_limits<double>::max();
     double maxValue = std::numeric_limits<double>::lowest();
-    QDateTime minValueDateTime, maxValueDateTime;
+    qint64 minValueTime = 0, maxValueTime = 0;
     double sumValues = 0.0;
     int validValueCount = 0;
     QVector<QPointF> regressionPoints;
@@ -666,61 +771,50 @@ void StationInfoCard::updateChart(const QString paramCode) {
     }
     maxDateTime = now;
 
+    // Szereg jest posortowany rosnąco - wyszukaj binarnie granice zakresu
+    const qint64 rangeStart = minDateTime.toSecsSinceEpoch();
+    const qint64 rangeEnd = maxDateTime.toSecsSinceEpoch();
+    const int first = values.lowerBound(rangeStart);
+    int last = values.lowerBound(rangeEnd + 1) - 1;
+
     // Iteruj od najnowszych do starszych
     int pointsAdded = 0;
-    for (int i = 0; i < values.size() && pointsAdded < maxPoints; ++i) {
-        QJsonObject valueObj = values[i].toObject();
-        if (!valueObj.contains("date") || !valueObj.contains("value")) {
-            qDebug() << "Brak pola 'date' lub 'value' w obiekcie:" << valueObj;
-            continue;
-        }
-
-        QString dateStr = valueObj["date"].toString();
-        qDebug() << "Przetwarzanie daty:" << dateStr;
-        QDateTime dateTime = QDateTime::fromString(dateStr, "yyyy-MM-dd HH:mm:ss");
-        if (!dateTime.isValid()) {
-            qDebug() << "Nieprawidłowy format daty:" << dateStr;
-            continue;
-        }
-
-        if (dateTime < minDateTime || dateTime > maxDateTime) {
-            continue;
-        }
+    for (int i = last; i >= first && pointsAdded < maxPoints; --i) {
+        const qint64 time = values.timestamp(i);
+        const bool isNull = values.isNull(i);
 
-        double value = valueObj["value"].isNull() ? lastValue : valueObj["value"].toDouble();
+        double value = isNull ? lastValue : values.value(i);
         if (value < 0) {
-            qDebug() << "Ujemna wartość (" << value << ") zastąpiona przez 0 dla daty:" << dateStr;
+            qDebug() << "Ujemna wartość (" << value << ") zastąpiona przez 0 dla czasu:" << time;
             value = 0;
         }
-        if (!valueObj["value"].isNull()) {
+        if (!isNull) {
             lastValue = value;
             hasData = true;
 
             // Oblicz min, max, sumę do średniej
             if (value < minValue) {
                 minValue = value;
-                minValueDateTime = dateTime;
+                minValueTime = time;
             }
             if (value > maxValue) {
                 maxValue = value;
-                maxValueDateTime = dateTime;
+                maxValueTime = time;
             }
             sumValues += value;
             validValueCount++;
 
             // Dodaj punkt do regresji (czas w milisekundach jako x, wartość jako y)
-            regressionPoints.append(QPointF(dateTime.toMSecsSinceEpoch(), value));
+            regressionPoints.append(QPointF(time * 1000.0, value));
         } else if (lastValue < 0) {
             lastValue = 0;
         }
 
-        series->append(dateTime.toMSecsSinceEpoch(), value);
-        qDebug() << "Dodano punkt: czas=" << dateTime.toString("dd.MM.yyyy HH:mm") << ", wartość=" << value;
+        series->append(time * 1000.0, value);
         pointsAdded++;
-
-        if (dateTime < minDateTime) minDateTime = dateTime;
-        if (dateTime > maxDateTime) maxDateTime = dateTime;
     }
+    QDateTime minValueDateTime = QDateTime::fromSecsSinceEpoch(minValueTime);
+    QDateTime maxValueDateTime = QDateTime::fromSecsSinceEpoch(maxValueTime);
 
     // Ustaw tytuł wykresu
     chart->setTitle(paramNames.value(paramCode, paramCode));
@@ -833,7 +927,7 @@ void StationInfoCard::updateChart(const QString paramCode) {
         chart->update();
         chartView->repaint();
     } else {
-        qDebug() << "Brak danych do wyświetlenia na wykresie dla:" << paramCode;
+        qDebug() << "Brak danych do wyświetlenia na wykresie dla:" << paramCode << "ID:" << sensorId;
         delete series;
         setupChart();
     }
@@ -886,10 +980,11 @@ void StationInfoCard::animateOut() {
 /**
  * @brief Obsługuje kliknięcie przycisku zamknięcia karty.
  *
- * Uruchamia animację zniknięcia karty.
+ * Przerywa pobieranie danych stacji i uruchamia animację zniknięcia karty.
  */
 void StationInfoCard::onCloseButtonClicked() {
     qDebug() << "Przycisk Zamknij kliknięty";
+    cancelRequests();
     animateOut();
 }
 
@@ -929,60 +1024,34 @@ void StationInfoCard::updateComboBoxPositions() {
 /**
  * @brief Obsługuje kliknięcie przycisku zapisu danych.
  *
- * Zapisuje dane stacji do pliku JSON i aktualizuje wykres.
+ * Dopisuje nowe pomiary stacji do jej archiwum i aktualizuje wykres.
  */
 void StationInfoCard::onSaveButtonClicked() {
     qDebug() << "Przycisk Zapisz kliknięty";
 
-    // Przygotuj dane do zapisu
-    QJsonObject stationObject;
-    stationObject["stationName"] = stationNameLabel->text();
-    stationObject["location"] = locationLabel->text();
+    // Dodaj bieżący pomiar z pełną godziną do szeregów sensorów
+    // Zaokrąglij do pełnej godziny (minuty i sekundy na 0)
+    const qint64 currentHour = GiosTime::floorToHour(QDateTime::currentSecsSinceEpoch());
 
-    QJsonArray sensorsArray;
     for (int col = 0; col < dataTable->columnCount(); ++col) {
         QTableWidgetItem *paramItem = dataTable->item(0, col);
         QTableWidgetItem *valueItem = dataTable->item(1, col);
         if (!paramItem || !valueItem) continue;
 
-        QString paramCode = paramItem->text();
-        QString latestValue = valueItem->text();
-
-        QJsonObject sensorObject;
-        sensorObject["paramCode"] = paramCode;
-        sensorObject["latestValue"] = latestValue;
-
-        // Pobierz istniejące dane historyczne
-        QJsonArray historicalData;
-        if (sensorValues.contains(paramCode)) {
-            historicalData = sensorValues[paramCode];
-        }
-
-        // Dodaj nowy punkt danych na początek z pełną godziną
-        QDateTime currentTime = QDateTime::currentDateTime();
-        // Zaokrąglij do pełnej godziny (minuty i sekundy na 0)
-        currentTime.setTime(QTime(currentTime.time().hour(), 0, 0));
-        QJsonObject newDataPoint;
-        newDataPoint["date"] = currentTime.toString("yyyy-MM-dd HH:mm:ss");
-        newDataPoint["value"] = latestValue.toDouble();
-        historicalData.prepend(newDataPoint);
-
-        sensorObject["historicalData"] = historicalData;
-        sensorsArray.append(sensorObject);
-
-        // Zaktualizuj sensorValues
-        sensorValues[paramCode] = historicalData;
+        int sensorId = paramItem->data(Qt::UserRole).toInt();
+        bool ok = false;
+        double latestValue = valueItem->text().toDouble(&ok);
+        // Istniejący punkt z tej samej godziny jest nadpisywany, więc nie powstają duplikaty
+        sensorSeries[sensorId].insert(currentHour, float(latestValue), !ok);
     }
 
-    stationObject["sensors"] = sensorsArray;
-
     // Przygotuj nazwę pliku na podstawie nazwy stacji
     QString stationName = stationNameLabel->text();
     // Usuń nadmiarowe spacje
     stationName = stationName.simplified();
     // Usuń znaki specjalne, w tym przecinki i kropki
     stationName.remove(QRegularExpression("[<>:\"/\\\\|?*,.]"));
-    QString filePath = QCoreApplication::applicationDirPath() + "/data/" + stationName + ".json";
+    QString filePath = QCoreApplication::applicationDirPath() + "/data/" + stationName + ".gios";
 
     // Utwórz katalog data, jeśli nie istnieje
     QDir dir(QCoreApplication::applicationDirPath() + "/data");
@@ -991,190 +1060,83 @@ void StationInfoCard::onSaveButtonClicked() {
     }
 
     // Zapisz dane do pliku
-    saveDataToJson(filePath);
+    if (!saveDataToArchive(filePath)) {
+        return;
+    }
 
     // Zaktualizuj wykres po zapisaniu nowych danych
-    if (sensorComboBox->count() > 0 && !sensorComboBox->currentText().isEmpty()) {
-        updateChart(sensorComboBox->currentText());
+    if (sensorComboBox->count() > 0 && sensorComboBox->currentIndex() >= 0) {
+        updateChart(sensorComboBox->currentData().toInt());
     }
 
     QMessageBox::information(this, tr("Sukces"), tr("Dane zostały zapisane do %1").arg(filePath));
 }
 
 /**
- * @brief Zapisuje dane stacji do pliku JSON.
- * @param fileName Ścieżka do pliku JSON.
+ * @brief Dopisuje dane stacji do pliku archiwum.
+ * @param fileName Ścieżka do pliku archiwum.
+ * @return false, jeśli zapis się nie powiódł.
  *
- * Scalanie istniejących danych z nowymi, unikając duplikacji.
+ * Do pliku trafiają wyłącznie nowe lub zmienione punkty; gdy archiwum jest mocno pofragmentowane,
+ * jest kompaktowane.
  */
-void StationInfoCard::saveDataToJson(const QString &fileName) {
-    // Przygotowanie danych stacji
-    QString stationName = stationNameLabel->text();
-    QString location = locationLabel->text();
-
-    // Tworzenie obiektu stacji
-    QJsonObject stationObj;
-    stationObj["stationName"] = stationName;
-    stationObj["location"] = location;
+bool StationInfoCard::saveDataToArchive(const QString &fileName) {
+    // Przygotowanie opisu stacji
+    ArchivedStation station;
+    station.stationId = currentStationId;
+    station.stationName = stationNameLabel->text();
+    station.location = locationLabel->text();
 
     // Dane sensorów
-    QJsonArray sensorsArray;
     for (int col = 0; col < dataTable->columnCount(); ++col) {
-        QJsonObject sensorObj;
-        QString paramCode = dataTable->item(0, col)->text();
-        sensorObj["paramCode"] = paramCode;
-        sensorObj["paramName"] = paramNames.value(paramCode, paramCode);
-        sensorObj["latestValue"] = dataTable->item(1, col)->text();
-
-        // Dane historyczne
-        QJsonArray historicalData;
-        if (sensorValues.contains(paramCode)) {
-            QJsonArray existingData = sensorValues[paramCode];
-            QSet<QString> existingDates;
-            for (const QJsonValue &val : existingData) {
-                existingDates.insert(val.toObject()["date"].toString());
-            }
-
-            // Dodaj nowy punkt danych tylko, jeśli data jest unikalna
-            QDateTime currentTime = QDateTime::currentDateTime();
-            // Zaokrąglij do pełnej godziny (minuty i sekundy na 0)
-            currentTime.setTime(QTime(currentTime.time().hour(), 0, 0));
-            QString newDate = currentTime.toString("yyyy-MM-dd HH:mm:ss");
-            if (!existingDates.contains(newDate)) {
-                QJsonObject newDataPoint;
-                newDataPoint["date"] = newDate;
-                newDataPoint["value"] = dataTable->item(1, col)->text().toDouble();
-                existingData.prepend(newDataPoint); // Dodaj na początek
-            }
-            historicalData = existingData;
-        } else {
-            QDateTime currentTime = QDateTime::currentDateTime();
-            // Zaokrąglij do pełnej godziny (minuty i sekundy na 0)
-            currentTime.setTime(QTime(currentTime.time().hour(), 0, 0));
-            QJsonObject newDataPoint;
-            newDataPoint["date"] = currentTime.toString("yyyy-MM-dd HH:mm:ss");
-            newDataPoint["value"] = dataTable->item(1, col)->text().toDouble();
-            historicalData.prepend(newDataPoint); // Dodaj na początek
-        }
-        sensorObj["historicalData"] = historicalData;
-
-        sensorsArray.append(sensorObj);
+        if (!dataTable->item(0, col) || !dataTable->item(1, col)) continue;
+        ArchivedSensor sensor;
+        sensor.sensorId = dataTable->item(0, col)->data(Qt::UserRole).toInt();
+        sensor.paramCode = dataTable->item(0, col)->text();
+        sensor.paramName = paramNames.value(sensor.paramCode, sensor.paramCode);
+        sensor.latestValue = dataTable->item(1, col)->text();
+        station.sensors.append(sensor);
     }
-    stationObj["sensors"] = sensorsArray;
-
-    // Odczyt istniejącego pliku, jeśli istnieje
-    QJsonObject rootObj;
-    QJsonArray stationsArray;
-    QFile file(fileName);
-    if (file.exists()) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qDebug() << "Nie można otworzyć pliku do odczytu:" << fileName;
-            QMessageBox::warning(this, tr("Błąd"), tr("Nie można otworzyć pliku do odczytu: %1").arg(file.errorString()));
-            return;
-        }
 
-        QByteArray existingData = file.readAll();
-        file.close();
-
-        QJsonDocument existingDoc = QJsonDocument::fromJson(existingData);
-        if (!existingDoc.isNull() && existingDoc.isObject()) {
-            rootObj = existingDoc.object();
-            if (rootObj.contains("stations") && rootObj["stations"].isArray()) {
-                stationsArray = rootObj["stations"].toArray();
+    // Niezdekodowane sensory są już w archiwum źródłowym; jeśli zapis idzie do innego pliku, trzeba je przenieść
+    QString archivePath;
+    if (sourceArchive) {
+        archivePath = sourceArchive->fileName();
+        if (QFileInfo(archivePath).canonicalFilePath() != QFileInfo(fileName).canonicalFilePath()) {
+            const QList<int> pending = archivedSensors.values();
+            for (int sensorId : pending) {
+                ensureSeriesLoaded(sensorId);
             }
-        } else {
-            qDebug() << "Nieprawidłowy format istniejącego pliku JSON. Tworzenie nowego.";
         }
     }
-
-    // Szukaj istniejącej stacji
-    int stationIndex = -1;
-    for (int i = 0; i < stationsArray.size(); ++i) {
-        QJsonObject existingStation = stationsArray[i].toObject();
-        if (existingStation["stationName"].toString() == stationName) {
-            stationIndex = i;
-            break;
-        }
+    if (sourceArchive) {
+        // Zapis do zmapowanego pliku - zwolnij mapowanie na czas zapisu
+        sourceArchive->close();
     }
 
-    // Aktualizacja lub dodanie stacji
-    if (stationIndex >= 0) {
-        // Stacja istnieje - aktualizuj sensory
-        QJsonObject existingStation = stationsArray[stationIndex].toObject();
-        QJsonArray existingSensors = existingStation["sensors"].toArray();
-
-        // Przetwarzaj każdy nowy sensor
-        QJsonArray updatedSensors;
-        for (const QJsonValue &newSensorValue : sensorsArray) {
-            QJsonObject newSensor = newSensorValue.toObject();
-            QString paramCode = newSensor["paramCode"].toString();
-            QJsonObject updatedSensor = newSensor;
-            bool sensorExists = false;
-
-            // Szukaj istniejącego sensora
-            for (const QJsonValue &existingSensorValue : existingSensors) {
-                QJsonObject existingSensor = existingSensorValue.toObject();
-                if (existingSensor["paramCode"].toString() == paramCode) {
-                    sensorExists = true;
-                    // Aktualizuj latestValue
-                    updatedSensor["latestValue"] = newSensor["latestValue"];
-
-                    // Scal dane historyczne, unikając duplikacji
-                    QJsonArray existingHistorical = existingSensor["historicalData"].toArray();
-                    QJsonArray newHistorical = newSensor["historicalData"].toArray();
-                    QSet<QString> existingDates;
-                    for (const QJsonValue &val : existingHistorical) {
-                        existingDates.insert(val.toObject()["date"].toString());
-                    }
-
-                    // Dodaj tylko nowe unikalne wpisy historyczne na początek
-                    QJsonArray mergedHistorical;
-                    // Najpierw dodaj nowe dane
-                    for (const QJsonValue &newVal : newHistorical) {
-                        QString date = newVal.toObject()["date"].toString();
-                        if (!existingDates.contains(date)) {
-                            mergedHistorical.append(newVal);
-                            existingDates.insert(date);
-                        }
-                    }
-                    // Następnie dodaj istniejące dane
-                    for (const QJsonValue &existingVal : existingHistorical) {
-                        mergedHistorical.append(existingVal);
-                    }
-                    updatedSensor["historicalData"] = mergedHistorical;
-                    break;
-                }
-            }
-
-            if (!sensorExists) {
-                // Nowy sensor - dodaj w całości
-                updatedSensor = newSensor;
-            }
+    StationArchiveWriter writer(fileName);
+    const bool saved = writer.append(station, sensorSeries);
+    if (!saved) {
+        qDebug() << "Nie można zapisać archiwum:" << fileName << writer.errorString();
+        QMessageBox::warning(this, tr("Błąd"), tr("Nie można zapisać pliku: %1").arg(writer.errorString()));
+    }
 
-            updatedSensors.append(updatedSensor);
+    // Kompakcja jest osobnym krokiem - wykonywana tylko wtedy, gdy plik urósł o wiele małych bloków
+    StationArchiveReader archive;
+    if (saved && archive.open(fileName) && archive.needsCompaction()) {
+        archive.close();
+        if (!writer.compact()) {
+            qDebug() << "Kompakcja archiwum nie powiodła się:" << writer.errorString();
         }
-
-        // Zaktualizuj listę sensorów dla stacji
-        existingStation["sensors"] = updatedSensors;
-        existingStation["location"] = location; // Zaktualizuj lokalizację
-        stationsArray[stationIndex] = existingStation;
-    } else {
-        // Nowa stacja - dodaj do tablicy
-        stationsArray.append(stationObj);
     }
 
-    // Zaktualizuj główny obiekt JSON
-    rootObj["stations"] = stationsArray;
-
-    // Zapis do pliku
-    if (!file.open(QIODevice::WriteOnly)) {
-        qDebug() << "Nie można otworzyć pliku do zapisu:" << fileName;
-        QMessageBox::warning(this, tr("Błąd"), tr("Nie można zapisać pliku: %1").arg(file.errorString()));
-        return;
+    if (sourceArchive && !sourceArchive->open(archivePath)) {
+        qDebug() << "Nie można ponownie otworzyć archiwum:" << archivePath << sourceArchive->errorString();
+        sourceArchive.reset();
     }
 
-    QJsonDocument doc(rootObj);
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-    qDebug() << "Dane zapisane do pliku:" << fileName;
+    if (saved) {
+        qDebug() << "Dane zapisane do pliku:" << fileName;
+    }
+    return saved;
 }
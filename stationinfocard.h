@@ -4,8 +4,6 @@
 #include <QFrame>
 #include <QLabel>
 #include <QVBoxLayout>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -18,30 +16,37 @@
 #include <QLineSeries>
 #include <QDateTimeAxis>
 #include <QValueAxis>
+#include <QSet>
+#include <memory>
+#include "sensorseries.h"
+#include "giosstreamparsers.h"
+#include "stationarchive.h"
+#include "giosclient.h"
 
 class StationInfoCard : public QFrame {
     Q_OBJECT
 
 public:
-    explicit StationInfoCard(QWidget *parent = nullptr);
+    explicit StationInfoCard(GiosClient *client, QWidget *parent = nullptr);
     void showStationData(int stationId, const QString &stationName, const QString &communeName, const QString &provinceName);
     void showDataFromFile(const QString &stationName, const QString &location, const QJsonArray &sensors);
+    void showDataFromArchive(const std::shared_ptr<StationArchiveReader> &archive, int stationIndex);
 
 signals:
     void cardClosed();
+    void sensorsLoaded(int stationId, const QVector<SensorDescriptor> &sensors); // Lista sensorów pobrana dla karty
 
 private slots:
     void onCloseButtonClicked();
-    void onSensorsReplyFinished(QNetworkReply *reply);
-    void onDataReplyFinished(QNetworkReply *reply, int column, const QString paramCode);
-    void onSensorSelectionChanged(const QString paramCode);
+    void onSensorSelectionChanged(int index);
     void onTimeRangeChanged(const QString timeRange);
     void onSaveButtonClicked();
 
 private:
     friend class TestStationInfoCard;
 
-    QNetworkAccessManager *networkManager;
+    GiosClient *client;                     // Wspólny klient API GIOŚ
+    QObject *stationRequests;               // Kontekst zapytań wyświetlanej stacji (usunięcie przerywa je)
     QTableWidget *dataTable;
     QLabel *titleLabel;
     QLabel *stationNameLabel;
@@ -58,18 +63,29 @@ private:
     QChartView *chartView;
     QVBoxLayout *layout;
     QStringList sensorData;
-    QMap<QString, QJsonArray> sensorValues;
+    QMap<int, SensorSeries> sensorSeries;   // Szeregi czasowe kluczowane ID sensora
+    QHash<int, QString> sensorParams;       // ID sensora → kod parametru
     QMap<QString, QString> paramNames;
     int pendingRequests;
+    int currentStationId;                   // ID wyświetlanej stacji (0 dla starych plików JSON)
+    std::shared_ptr<StationArchiveReader> sourceArchive; // Archiwum, z którego dekodowane są historie sensorów
+    QSet<int> archivedSensors;              // Sensory, których historia nie została jeszcze zdekodowana
     QString currentTimeRange;
 
+    void cancelRequests();
+    void requestSensors(int stationId);
+    void requestSensorData(int sensorId, int column, GiosClient::Priority priority);
+    void onSensorsReplyFinished(const GiosResult &result, const QVector<SensorDescriptor> &sensors);
+    void onDataReplyFinished(const GiosResult &result, SensorSeries &series, int column, int sensorId);
     void setupChart();
     void animateIn();
     void animateOut();
     void adjustTableWidth();
-    void updateChart(const QString paramCode);
+    void updateChart(int sensorId);
     void updateComboBoxPositions();
-    void saveDataToJson(const QString &fileName);
+    void ensureSeriesLoaded(int sensorId);
+    void showStoredStation(const ArchivedStation &station, const QMap<int, SensorSeries> &histories);
+    bool saveDataToArchive(const QString &fileName);
 };
 
 #endif // STATIONINFOCARD_H
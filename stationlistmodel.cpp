@@ -0,0 +1,203 @@
+/**
+ * @file stationlistmodel.cpp
+ * @brief Implementacja modelu listy stacji i modelu pośredniego.
+ */
+
+#include "stationlistmodel.h"
+#include <QtNumeric>
+#include <limits>
+
+/**
+ * @brief Tworzy pusty model.
+ * @param parent Obiekt nadrzędny.
+ */
+StationListModel::StationListModel(QObject *parent) : QAbstractListModel(parent) {}
+
+/**
+ * @brief Ustawia katalog, z którego model odczytuje stacje.
+ * @param catalog Katalog (musi istnieć dłużej niż model; nullptr - model pusty).
+ */
+void StationListModel::setCatalog(const StationCatalog *catalog) {
+    beginResetModel();
+    this->catalog = catalog;
+    rows = catalog ? catalog->size() : 0;
+    distances.fill(std::numeric_limits<double>::quiet_NaN(), rows);
+    hasDistances = false;
+    endResetModel();
+}
+
+/**
+ * @brief Odświeża wiersze po zmianie katalogu (StationCatalog::merge()), bez resetu modelu.
+ * @param changed Indeksy stacji zmienionych lub usuniętych.
+ */
+void StationListModel::updateStations(const QVector<int> &changed) {
+    if (!catalog) {
+        return;
+    }
+    if (catalog->size() > rows) {
+        beginInsertRows(QModelIndex(), rows, catalog->size() - 1);
+        rows = catalog->size();
+        distances.resize(rows, std::numeric_limits<double>::quiet_NaN());
+        endInsertRows();
+    }
+    for (int row : changed) {
+        emit dataChanged(index(row), index(row), {Qt::DisplayRole});
+    }
+}
+
+/**
+ * @brief Ustawia odległości stacji od punktu zapytania.
+ * @param hits Stacje z odległościami; pozostałe stacje nie mają odległości.
+ */
+void StationListModel::setDistances(const QVector<StationSpatialIndex::Hit> &hits) {
+    distances.fill(std::numeric_limits<double>::quiet_NaN(), rows);
+    for (const StationSpatialIndex::Hit &hit : hits) {
+        distances[hit.index] = hit.distanceKm;
+    }
+    hasDistances = true;
+    if (rows > 0) {
+        emit dataChanged(index(0), index(rows - 1), {Qt::DisplayRole, DistanceRole});
+    }
+}
+
+/**
+ * @brief Usuwa odległości wszystkich stacji.
+ */
+void StationListModel::clearDistances() {
+    if (!hasDistances) {
+        return;
+    }
+    distances.fill(std::numeric_limits<double>::quiet_NaN(), rows);
+    hasDistances = false;
+    if (rows > 0) {
+        emit dataChanged(index(0), index(rows - 1), {Qt::DisplayRole, DistanceRole});
+    }
+}
+
+/**
+ * @brief Zwraca liczbę wierszy (stacji).
+ * @param parent Indeks rodzica (model jest płaską listą).
+ * @return Liczba stacji.
+ */
+int StationListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows;
+}
+
+/**
+ * @brief Zwraca dane stacji w wierszu.
+ * @param index Indeks wiersza.
+ * @param role Rola danych.
+ * @return Tekst elementu, indeks lub ID stacji albo odległość.
+ */
+QVariant StationListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows) {
+        return QVariant();
+    }
+    const int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole: {
+        const QString text = QString("ID: %1 - %2").arg(catalog->id(row)).arg(catalog->name(row));
+        return qIsNaN(distances[row]) ? text : QString("%1 (%2 km)").arg(text).arg(distances[row], 0, 'f', 1);
+    }
+    case StationIndexRole:
+        return row;
+    case StationIdRole:
+        return catalog->id(row);
+    case DistanceRole:
+        return distances[row];
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Tworzy model pośredni.
+ * @param parent Obiekt nadrzędny.
+ */
+StationFilterProxyModel::StationFilterProxyModel(QObject *parent) : QSortFilterProxyModel(parent) {
+    // Sortowanie jest zawsze włączone - GivenOrder odtwarza kolejność listy stacji. Zmiany danych źródła
+    // (odległości) nie przesortowują listy same - kolejność odświeża setStations()
+    setDynamicSortFilter(false);
+    sort(0, Qt::AscendingOrder);
+}
+
+/**
+ * @brief Ustawia model źródłowy listy stacji.
+ * @param model Model źródłowy.
+ *
+ * Reset modelu źródłowego (StationListModel::setCatalog()) zmienia znaczenie wierszy, więc pozycje stacji
+ * są wtedy czyszczone - do następnego setStations() lista jest pusta.
+ */
+void StationFilterProxyModel::setStationModel(StationListModel *model) {
+    disconnect(resetConnection);
+    stationModel = model;
+    setSourceModel(model);
+    positions.clear();
+    if (model) {
+        resetConnection = connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+            /**
+             * @brief Lambda usuwająca pozycje stacji przed resetem modelu źródłowego.
+             */
+            positions.clear();
+        });
+    }
+}
+
+/**
+ * @brief Ustawia pokazywane stacje.
+ * @param stations Indeksy stacji w katalogu, w kolejności "bez sortowania".
+ */
+void StationFilterProxyModel::setStations(const QVector<int> &stations) {
+    positions.fill(-1, stationModel ? stationModel->rowCount() : 0);
+    for (int i = 0; i < stations.size(); ++i) {
+        positions[stations[i]] = i;
+    }
+    invalidate();
+}
+
+/**
+ * @brief Ustawia klucz sortowania.
+ * @param key Klucz sortowania.
+ */
+void StationFilterProxyModel::setSortKey(SortKey key) {
+    if (sortKey == key) {
+        return;
+    }
+    sortKey = key;
+    invalidate();
+}
+
+/**
+ * @brief Sprawdza, czy stacja jest na liście pokazywanych.
+ * @param sourceRow Wiersz modelu źródłowego (indeks stacji).
+ * @param sourceParent Rodzic w modelu źródłowym.
+ * @return true, jeśli stacja jest pokazywana.
+ */
+bool StationFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    Q_UNUSED(sourceParent);
+    return sourceRow < positions.size() && positions[sourceRow] >= 0;
+}
+
+/**
+ * @brief Porównuje stacje według klucza sortowania.
+ * @param left Indeks pierwszej stacji w modelu źródłowym.
+ * @param right Indeks drugiej stacji w modelu źródłowym.
+ * @return Wartość logiczna określająca kolejność.
+ *
+ * Przy równych kluczach decyduje kolejność listy stacji.
+ */
+bool StationFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const {
+    const int a = left.row();
+    const int b = right.row();
+    if (sortKey == ById) {
+        return stationModel->stationId(a) < stationModel->stationId(b);
+    }
+    if (sortKey == ByDistance) {
+        const double distanceA = stationModel->distance(a);
+        const double distanceB = stationModel->distance(b);
+        if (!qIsNaN(distanceA) && !qIsNaN(distanceB) && distanceA != distanceB) {
+            return distanceA < distanceB;
+        }
+    }
+    return positions[a] < positions[b];
+}
@@ -0,0 +1,130 @@
+/**
+ * @file stationlistmodel.h
+ * @brief Model listy stacji nad katalogiem oraz model pośredni filtrujący i sortujący.
+ */
+
+#ifndef STATIONLISTMODEL_H
+#define STATIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include "stationcatalog.h"
+#include "stationspatialindex.h"
+
+/**
+ * @class StationListModel
+ * @brief Model z jednym wierszem dla każdej stacji katalogu (wiersz = indeks stacji w katalogu).
+ *
+ * Tekst elementu ("ID: ... - nazwa", z odległością, jeśli jest znana) tworzony jest dopiero przy
+ * wyświetlaniu, więc tylko dla widocznych wierszy. Widok odczytuje indeks stacji rolą StationIndexRole.
+ */
+class StationListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /// Dodatkowe role danych modelu.
+    enum Roles {
+        StationIndexRole = Qt::UserRole, ///< Indeks stacji w katalogu (int).
+        StationIdRole, ///< Identyfikator stacji (int).
+        DistanceRole ///< Odległość od punktu zapytania w km (double, NaN, jeśli nieznana).
+    };
+
+    /**
+     * @brief Tworzy pusty model.
+     * @param parent Obiekt nadrzędny.
+     */
+    explicit StationListModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Ustawia katalog, z którego model odczytuje stacje.
+     * @param catalog Katalog (musi istnieć dłużej niż model; nullptr - model pusty).
+     *
+     * Wywoływana po każdej zmianie zawartości katalogu; usuwa też odległości.
+     */
+    void setCatalog(const StationCatalog *catalog);
+    /**
+     * @brief Odświeża wiersze po zmianie katalogu (StationCatalog::merge()), bez resetu modelu.
+     * @param changed Indeksy stacji zmienionych lub usuniętych.
+     *
+     * Nowe stacje katalogu dopisywane są jako nowe wiersze na końcu modelu; wiersze usuniętych
+     * stacji pozostają (ukrywa je model pośredni), więc zaznaczenie w widoku jest zachowywane.
+     */
+    void updateStations(const QVector<int> &changed);
+    /**
+     * @brief Ustawia odległości stacji od punktu zapytania.
+     * @param hits Stacje z odległościami; pozostałe stacje nie mają odległości.
+     */
+    void setDistances(const QVector<StationSpatialIndex::Hit> &hits);
+    /**
+     * @brief Usuwa odległości wszystkich stacji.
+     */
+    void clearDistances();
+
+    int stationId(int row) const { return catalog->id(row); } ///< Identyfikator stacji w wierszu.
+    double distance(int row) const { return distances[row]; } ///< Odległość stacji w wierszu (NaN, jeśli nieznana).
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    const StationCatalog *catalog = nullptr; ///< Katalog stacji.
+    int rows = 0; ///< Liczba wierszy (rozmiar katalogu przy ostatnim setCatalog()).
+    QVector<double> distances; ///< Odległości stacji (według indeksu w katalogu).
+    bool hasDistances = false; ///< Czy jakakolwiek stacja ma odległość.
+};
+
+/**
+ * @class StationFilterProxyModel
+ * @brief Model pośredni pokazujący wybrany podzbiór stacji w zadanej kolejności.
+ *
+ * Podzbiór przekazywany jest jako lista indeksów stacji; jej kolejność jest kolejnością "bez sortowania".
+ * Filtrowanie sprawdza tylko tablicę pozycji, a zmiana sortowania nie wymaga ponownego wyszukiwania.
+ */
+class StationFilterProxyModel : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    /// Klucz sortowania.
+    enum SortKey {
+        GivenOrder, ///< Kolejność listy przekazanej do setStations().
+        ById, ///< Rosnąco według ID stacji.
+        ByDistance ///< Rosnąco według odległości.
+    };
+
+    /**
+     * @brief Tworzy model pośredni.
+     * @param parent Obiekt nadrzędny.
+     */
+    explicit StationFilterProxyModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Ustawia model źródłowy listy stacji.
+     * @param model Model źródłowy.
+     *
+     * Po resecie modelu źródłowego lista pokazywanych stacji jest pusta do następnego setStations().
+     */
+    void setStationModel(StationListModel *model);
+    /**
+     * @brief Ustawia pokazywane stacje.
+     * @param stations Indeksy stacji w katalogu, w kolejności "bez sortowania".
+     */
+    void setStations(const QVector<int> &stations);
+    /**
+     * @brief Ustawia klucz sortowania.
+     * @param key Klucz sortowania.
+     */
+    void setSortKey(SortKey key);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    StationListModel *stationModel = nullptr; ///< Model źródłowy.
+    QVector<int> positions; ///< Pozycja stacji na liście setStations() (-1 - stacja ukryta).
+    QMetaObject::Connection resetConnection; ///< Połączenie z sygnałem resetu modelu źródłowego.
+    SortKey sortKey = GivenOrder; ///< Klucz sortowania.
+};
+
+#endif // STATIONLISTMODEL_H
@@ -0,0 +1,101 @@
+/**
+ * @file stationmapview.cpp
+ * @brief Implementacja widoku mapy stacji.
+ */
+
+#include "stationmapview.h"
+#include <QtMath>
+
+/**
+ * @brief Tworzy widok mapy.
+ * @param scene Scena mapy.
+ * @param parent Wskaźnik do nadrzędnego widgetu (domyślnie nullptr).
+ *
+ * Przeciąganie przesuwa mapę tylko wtedy, gdy kliknięcie nie trafiło w znacznik (warstwa znaczników
+ * ignoruje kliknięcia poza nimi).
+ */
+StationMapView::StationMapView(QGraphicsScene *scene, QWidget *parent) : QGraphicsView(scene, parent) {
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setResizeAnchor(QGraphicsView::AnchorViewCenter);
+}
+
+/**
+ * @brief Przybliża mapę dwukrotnie i wyśrodkowuje ją na podanym punkcie.
+ * @param scenePos Punkt we współrzędnych sceny.
+ */
+void StationMapView::zoomInAt(const QPointF &scenePos) {
+    const ViewportAnchor anchor = transformationAnchor();
+    setTransformationAnchor(QGraphicsView::NoAnchor);
+    zoomBy(2.0);
+    setTransformationAnchor(anchor);
+    centerOn(scenePos);
+}
+
+/**
+ * @brief Przywraca przybliżenie 1 (cała mapa).
+ */
+void StationMapView::resetZoom() {
+    zoomFactor = 1.0;
+    applyScale();
+}
+
+/**
+ * @brief Przybliża lub oddala mapę wokół kursora.
+ * @param event Zdarzenie kółka myszy.
+ *
+ * Jeden krok kółka (120 jednostek) zmienia skalę o około 20%.
+ */
+void StationMapView::wheelEvent(QWheelEvent *event) {
+    const int delta = event->angleDelta().y();
+    if (delta == 0) {
+        QGraphicsView::wheelEvent(event);
+        return;
+    }
+    zoomBy(qPow(1.2, delta / 120.0));
+    event->accept();
+}
+
+/**
+ * @brief Dopasowuje skalę widoku do nowego rozmiaru okna.
+ * @param event Zdarzenie zmiany rozmiaru.
+ *
+ * Scena nie jest pomniejszana poniżej rozmiaru naturalnego - rozmiary znaczników w scenie zakładają
+ * skalę co najmniej 1.
+ */
+void StationMapView::resizeEvent(QResizeEvent *event) {
+    QGraphicsView::resizeEvent(event);
+    const QRectF rect = sceneRect();
+    if (rect.isEmpty()) {
+        return;
+    }
+    fitScale = qMax(1.0, qMin(viewport()->width() / rect.width(), viewport()->height() / rect.height()));
+    const ViewportAnchor anchor = transformationAnchor();
+    setTransformationAnchor(QGraphicsView::AnchorViewCenter);
+    applyScale();
+    setTransformationAnchor(anchor);
+}
+
+/**
+ * @brief Zmienia przybliżenie, ograniczając je do przedziału [MinScale, MaxScale].
+ * @param factor Mnożnik przybliżenia.
+ */
+void StationMapView::zoomBy(qreal factor) {
+    const qreal target = qBound(MinScale, zoomFactor * factor, MaxScale);
+    if (!qFuzzyCompare(target, zoomFactor)) {
+        zoomFactor = target;
+        applyScale();
+    }
+}
+
+/**
+ * @brief Ustawia skalę widoku na fitScale * zoomFactor.
+ *
+ * Punkt zaczepienia (kursor lub środek widoku) pozostaje w miejscu.
+ */
+void StationMapView::applyScale() {
+    const qreal step = fitScale * zoomFactor / transform().m11();
+    if (!qFuzzyCompare(step, 1.0)) {
+        scale(step, step);
+    }
+}
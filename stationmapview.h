@@ -0,0 +1,79 @@
+/**
+ * @file stationmapview.h
+ * @brief Widok mapy stacji z przybliżaniem kółkiem myszy i przesuwaniem przeciąganiem.
+ */
+
+#ifndef STATIONMAPVIEW_H
+#define STATIONMAPVIEW_H
+
+#include <QGraphicsView>
+#include <QResizeEvent>
+#include <QWheelEvent>
+
+/**
+ * @class StationMapView
+ * @brief Widok sceny mapy: kółko myszy przybliża wokół kursora, przeciąganie przesuwa mapę.
+ *
+ * Przybliżenie ograniczone jest do przedziału [MinScale, MaxScale]; przybliżenie 1 odpowiada całej
+ * scenie dopasowanej do okna (nie mniejszej niż rozmiar sceny). Zmiana rozmiaru okna zachowuje
+ * przybliżenie.
+ */
+class StationMapView : public QGraphicsView {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Tworzy widok mapy.
+     * @param scene Scena mapy.
+     * @param parent Wskaźnik do nadrzędnego widgetu (domyślnie nullptr).
+     */
+    explicit StationMapView(QGraphicsScene *scene, QWidget *parent = nullptr);
+
+    /**
+     * @brief Zwraca bieżące przybliżenie.
+     * @return Przybliżenie (1 - cała scena dopasowana do okna).
+     */
+    qreal zoom() const { return zoomFactor; }
+
+    static constexpr qreal MinScale = 1.0; ///< Najmniejsze przybliżenie.
+    static constexpr qreal MaxScale = 64.0; ///< Największe przybliżenie.
+
+public slots:
+    /**
+     * @brief Przybliża mapę dwukrotnie i wyśrodkowuje ją na podanym punkcie.
+     * @param scenePos Punkt we współrzędnych sceny.
+     */
+    void zoomInAt(const QPointF &scenePos);
+    /**
+     * @brief Przywraca przybliżenie 1 (cała mapa).
+     */
+    void resetZoom();
+
+protected:
+    /**
+     * @brief Przybliża lub oddala mapę wokół kursora.
+     * @param event Zdarzenie kółka myszy.
+     */
+    void wheelEvent(QWheelEvent *event) override;
+    /**
+     * @brief Dopasowuje skalę widoku do nowego rozmiaru okna.
+     * @param event Zdarzenie zmiany rozmiaru.
+     */
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    /**
+     * @brief Zmienia przybliżenie, ograniczając je do przedziału [MinScale, MaxScale].
+     * @param factor Mnożnik przybliżenia.
+     */
+    void zoomBy(qreal factor);
+    /**
+     * @brief Ustawia skalę widoku na fitScale * zoomFactor.
+     */
+    void applyScale();
+
+    qreal fitScale = 1.0; ///< Skala, przy której scena wypełnia okno (co najmniej 1).
+    qreal zoomFactor = 1.0; ///< Przybliżenie względem fitScale.
+};
+
+#endif // STATIONMAPVIEW_H
@@ -0,0 +1,451 @@
+/**
+ * @file stationmarkerlayer.cpp
+ * @brief Implementacja warstwy znaczników stacji.
+ */
+
+#include "stationmarkerlayer.h"
+#include "airqualityindex.h"
+#include <QGraphicsSceneHoverEvent>
+#include <QGraphicsSceneMouseEvent>
+#include <QHash>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Tworzy pustą warstwę.
+ * @param parent Element nadrzędny.
+ */
+StationMarkerLayer::StationMarkerLayer(QGraphicsItem *parent) : QGraphicsObject(parent) {
+    setAcceptHoverEvents(true);
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+}
+
+/**
+ * @brief Ustawia znaczniki i wyznacza ich komórki na wszystkich poziomach.
+ * @param markers Znaczniki stacji.
+ *
+ * Zmiana widoczności nie zmienia komórek, tylko ponownie grupuje znaczniki.
+ */
+void StationMarkerLayer::setMarkers(const QVector<Marker> &markers) {
+    this->markers = markers;
+    visible.fill(true, markers.size());
+    bands.fill(-1, markers.size());
+    indexMarkers();
+}
+
+/**
+ * @brief Dodaje, przesuwa i usuwa znaczniki stacji zmienionych w katalogu.
+ * @param changed Znaczniki stacji nowych lub zmienionych (położenie, nazwa).
+ * @param removed Indeksy stacji, których znaczniki należy usunąć.
+ *
+ * Pozostałe znaczniki zachowują widoczność i klasę indeksu, a warstwa pozostaje w scenie,
+ * więc przybliżenie widoku się nie zmienia. Nowe znaczniki są widoczne i nie mają klasy indeksu.
+ */
+void StationMarkerLayer::updateMarkers(const QVector<Marker> &changed, const QVector<int> &removed) {
+    QVector<bool> dropped(markers.size(), false);
+    for (const Marker &marker : changed) {
+        const int existing = markerOf(marker.index);
+        if (existing >= 0) {
+            markers[existing] = marker;
+        } else {
+            markers.append(marker);
+            visible.append(true);
+            bands.append(-1);
+            dropped.append(false);
+        }
+    }
+    for (int index : removed) {
+        const int marker = markerOf(index);
+        if (marker >= 0) {
+            dropped[marker] = true;
+        }
+    }
+    int kept = 0;
+    for (int i = 0; i < markers.size(); ++i) {
+        if (dropped[i]) {
+            continue;
+        }
+        markers[kept] = markers[i];
+        visible[kept] = visible[i];
+        bands[kept] = bands[i];
+        ++kept;
+    }
+    markers.resize(kept);
+    visible.resize(kept);
+    bands.resize(kept);
+    indexMarkers();
+}
+
+/**
+ * @brief Wyznacza komórki znaczników na wszystkich poziomach i grupuje znaczniki.
+ *
+ * Komórki nie zależą od filtrów, więc wyznaczane są tylko po zmianie znaczników.
+ */
+void StationMarkerLayer::indexMarkers() {
+    prepareGeometryChange();
+    int stationCount = 0;
+    for (const Marker &marker : markers) {
+        stationCount = qMax(stationCount, marker.index + 1);
+    }
+    markerOfStation.fill(-1, stationCount);
+    for (int i = 0; i < markers.size(); ++i) {
+        markerOfStation[markers[i].index] = i;
+    }
+
+    bounds = QRectF();
+    if (!markers.isEmpty()) {
+        bounds = QRectF(markers.first().position, QSizeF(0.0, 0.0));
+        for (const Marker &marker : markers) {
+            bounds.setLeft(qMin(bounds.left(), marker.position.x()));
+            bounds.setRight(qMax(bounds.right(), marker.position.x()));
+            bounds.setTop(qMin(bounds.top(), marker.position.y()));
+            bounds.setBottom(qMax(bounds.bottom(), marker.position.y()));
+        }
+    }
+
+    const int count = markers.size();
+    columns.resize(LevelCount);
+    markerCells.resize(LevelCount * count);
+    for (int level = 0; level < LevelCount; ++level) {
+        const qreal size = cellSize(level);
+        columns[level] = int(bounds.width() / size) + 1;
+        for (int i = 0; i < count; ++i) {
+            const qint64 row = qint64((markers[i].position.y() - bounds.top()) / size);
+            const qint64 column = qint64((markers[i].position.x() - bounds.left()) / size);
+            markerCells[level * count + i] = row * columns[level] + column;
+        }
+    }
+    buildClusters();
+}
+
+/**
+ * @brief Ustawia, które stacje są widoczne, i grupuje widoczne znaczniki.
+ * @param mask Mapa bitowa indeksów stacji w katalogu (pusta - wszystkie widoczne).
+ */
+void StationMarkerLayer::setVisibleStations(const QBitArray &mask) {
+    bool changed = false;
+    for (int i = 0; i < markers.size(); ++i) {
+        const int index = markers[i].index;
+        const bool show = mask.isEmpty() || (index < mask.size() && mask.testBit(index));
+        changed |= visible[i] != show;
+        visible[i] = show;
+    }
+    if (changed) {
+        buildClusters();
+    }
+}
+
+/**
+ * @brief Ustawia klasę indeksu jakości powietrza stacji.
+ * @param index Indeks stacji w katalogu.
+ * @param band Klasa indeksu (-1 - brak indeksu).
+ *
+ * Na każdym poziomie aktualizowana jest tylko grupa zawierająca stację: przy pogorszeniu klasy
+ * wystarczy porównanie, przy poprawie klasa grupy liczona jest ponownie z jej znaczników.
+ * Odświeżany jest tylko obszar grupy na poziomie widocznym na ekranie.
+ */
+void StationMarkerLayer::setStationBand(int index, int band) {
+    const int marker = markerOf(index);
+    if (marker < 0 || bands[marker] == band) {
+        return;
+    }
+    const int previous = bands[marker];
+    bands[marker] = band;
+    const int count = markers.size();
+    for (int level = 0; level < levels.size(); ++level) {
+        const int clusterIndex = markerClusters[level * count + marker];
+        if (clusterIndex < 0) {
+            continue; // Znacznik ukryty przez filtry
+        }
+        Cluster &cluster = levels[level][clusterIndex];
+        const int oldBand = cluster.band;
+        if (band >= cluster.band) {
+            cluster.band = band;
+        } else if (previous == cluster.band) {
+            cluster.band = -1;
+            for (int i = 0; i < count; ++i) {
+                if (markerClusters[level * count + i] == clusterIndex) {
+                    cluster.band = qMax(cluster.band, bands[i]);
+                }
+            }
+        }
+        if (level == paintLevel && cluster.band != oldBand) {
+            updateCluster(cluster);
+        }
+    }
+}
+
+/**
+ * @brief Zwraca prostokąt obejmujący wszystkie znaczniki (z obramowaniem).
+ * @return Prostokąt we współrzędnych warstwy.
+ *
+ * Przy skali widoku co najmniej 1 znacznik zajmuje w scenie nie więcej niż w pikselach ekranu.
+ */
+QRectF StationMarkerLayer::boundingRect() const {
+    const qreal margin = MaxClusterRadius + 1.0;
+    return markers.isEmpty() ? QRectF() : bounds.adjusted(-margin, -margin, margin, margin);
+}
+
+/**
+ * @brief Rysuje widoczne znaczniki poziomu odpowiadającego skali widoku.
+ * @param painter Obiekt rysujący.
+ * @param option Opcje stylu (z obszarem do odświeżenia).
+ * @param widget Widżet, na którym odbywa się rysowanie.
+ *
+ * Rysowane są tylko grupy z odświeżanego obszaru, we współrzędnych urządzenia, aby rozmiary
+ * znaczników i napisów nie zależały od skali. Pióro i pędzel ustawiane są raz na rodzaj znacznika.
+ */
+void StationMarkerLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(widget);
+    if (levels.isEmpty()) {
+        return;
+    }
+    const QTransform transform = painter->worldTransform();
+    paintScale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(transform);
+    paintLevel = qBound(0, int(std::floor(std::log2(paintScale))), LevelCount - 1);
+
+    const qreal margin = (MaxClusterRadius + 1.0) / paintScale;
+    const QVector<int> exposed = clustersIn(paintLevel, option->exposedRect.adjusted(-margin, -margin, margin, margin));
+    const QVector<Cluster> &clusters = levels[paintLevel];
+
+    painter->save();
+    painter->resetTransform();
+    painter->setPen(QPen(Qt::black, 1));
+    int brushBand = -2;
+    for (int i : exposed) {
+        if (clusters[i].count == 1) {
+            if (clusters[i].band != brushBand) {
+                brushBand = clusters[i].band;
+                painter->setBrush(QBrush(AirQualityIndex::bandColor(brushBand)));
+            }
+            painter->drawEllipse(transform.map(clusters[i].position), Radius, Radius);
+        }
+    }
+
+    // Grupy rysowane są na wierzchu pojedynczych stacji
+    QFont font = painter->font();
+    font.setBold(true);
+    painter->setFont(font);
+    for (int i : exposed) {
+        const Cluster &cluster = clusters[i];
+        if (cluster.count == 1) {
+            continue;
+        }
+        const QPointF center = transform.map(cluster.position);
+        const qreal radius = clusterRadius(cluster.count);
+        const QColor color = AirQualityIndex::bandColor(cluster.band);
+        painter->setPen(QPen(Qt::black, 1));
+        painter->setBrush(QBrush(color));
+        painter->drawEllipse(center, radius, radius);
+        painter->setPen(qGray(color.rgb()) > 150 ? Qt::black : Qt::white);
+        painter->drawText(QRectF(center.x() - radius, center.y() - radius, 2 * radius, 2 * radius), Qt::AlignCenter,
+                          QString::number(cluster.count));
+    }
+    painter->restore();
+}
+
+/**
+ * @brief Obsługuje kliknięcie znacznika.
+ * @param event Zdarzenie myszy.
+ *
+ * Kliknięcie stacji emituje stationClicked(), kliknięcie grupy - clusterClicked(). Kliknięcie poza
+ * znacznikami jest ignorowane i trafia do widoku (przesuwanie mapy) lub elementów pod warstwą.
+ */
+void StationMarkerLayer::mousePressEvent(QGraphicsSceneMouseEvent *event) {
+    const int index = event->button() == Qt::LeftButton ? clusterAt(event->pos()) : -1;
+    if (index < 0) {
+        event->ignore();
+        return;
+    }
+    event->accept();
+    const Cluster &cluster = levels[paintLevel][index];
+    if (cluster.count == 1) {
+        emit stationClicked(markers[cluster.marker].stationId);
+    } else {
+        emit clusterClicked(mapToScene(cluster.position));
+    }
+}
+
+/**
+ * @brief Ustawia podpowiedź z nazwą stacji lub liczbą stacji grupy pod kursorem.
+ * @param event Zdarzenie najechania.
+ */
+void StationMarkerLayer::hoverMoveEvent(QGraphicsSceneHoverEvent *event) {
+    const int index = clusterAt(event->pos());
+    if (index < 0) {
+        setToolTip(QString());
+    } else if (levels[paintLevel][index].count == 1) {
+        const int marker = levels[paintLevel][index].marker;
+        setToolTip(markers[marker].name + (bands[marker] >= 0 ? " - " + AirQualityIndex::bandName(bands[marker]) : QString()));
+    } else {
+        setToolTip(QString("Stacje: %1 (kliknij, aby przybliżyć)").arg(levels[paintLevel][index].count));
+    }
+    QGraphicsObject::hoverMoveEvent(event);
+}
+
+/**
+ * @brief Grupuje widoczne znaczniki na wszystkich poziomach.
+ *
+ * Na ostatnim poziomie każdy znacznik tworzy własną grupę, więc przy największym przybliżeniu
+ * widoczne są wszystkie stacje.
+ */
+void StationMarkerLayer::buildClusters() {
+    const int count = markers.size();
+    levels.fill(QVector<Cluster>(), count > 0 ? LevelCount : 0);
+    markerClusters.fill(-1, levels.size() * count);
+    for (int level = 0; level < levels.size(); ++level) {
+        QVector<Cluster> &clusters = levels[level];
+        const bool separate = level == LevelCount - 1;
+        QHash<qint64, int> clusterOfCell;
+        for (int i = 0; i < count; ++i) {
+            if (!visible[i]) {
+                continue;
+            }
+            const qint64 cell = markerCells[level * count + i];
+            auto it = separate ? clusterOfCell.constEnd() : clusterOfCell.constFind(cell);
+            if (it == clusterOfCell.constEnd()) {
+                if (!separate) {
+                    clusterOfCell.insert(cell, clusters.size());
+                }
+                clusters.append({cell, markers[i].position, 1, i, bands[i]});
+                continue;
+            }
+            Cluster &cluster = clusters[it.value()];
+            cluster.position += markers[i].position; // suma, dzielona po zebraniu grupy
+            cluster.count++;
+            cluster.marker = i;
+            cluster.band = qMax(cluster.band, bands[i]);
+        }
+        for (Cluster &cluster : clusters) {
+            cluster.position /= cluster.count;
+        }
+        std::sort(clusters.begin(), clusters.end(), [](const Cluster &a, const Cluster &b) {
+            /**
+             * @brief Lambda porządkująca grupy według komórki (w komórce - według kolejności rysowania).
+             * @param a Pierwsza grupa.
+             * @param b Druga grupa.
+             * @return Wartość logiczna określająca kolejność.
+             */
+            return a.cell != b.cell ? a.cell < b.cell : a.marker < b.marker;
+        });
+
+        // Przypisanie znaczników do grup (po sortowaniu) dla aktualizacji klas indeksu
+        clusterOfCell.clear();
+        for (int c = 0; c < clusters.size(); ++c) {
+            if (separate) {
+                markerClusters[level * count + clusters[c].marker] = c;
+            } else {
+                clusterOfCell.insert(clusters[c].cell, c);
+            }
+        }
+        for (int i = 0; i < count && !separate; ++i) {
+            markerClusters[level * count + i] = visible[i] ? clusterOfCell.value(markerCells[level * count + i]) : -1;
+        }
+    }
+    update();
+}
+
+/**
+ * @brief Zwraca grupy poziomu leżące w prostokącie komórek obejmującym podany obszar.
+ * @param level Poziom szczegółowości.
+ * @param rect Obszar we współrzędnych warstwy.
+ * @return Indeksy grup w levels[level].
+ *
+ * Grupa leży w komórce swoich znaczników, więc wystarczy przejrzeć komórki przecinające obszar:
+ * dla każdego wiersza siatki wyszukiwany jest binarnie początek zakresu kolumn.
+ */
+QVector<int> StationMarkerLayer::clustersIn(int level, const QRectF &rect) const {
+    QVector<int> result;
+    if (levels.isEmpty() || !rect.intersects(bounds.adjusted(-1.0, -1.0, 1.0, 1.0))) {
+        return result;
+    }
+    const qreal size = cellSize(level);
+    const qint64 columnCount = columns[level];
+    const qint64 rowCount = qint64(bounds.height() / size) + 1;
+    const qint64 firstColumn = qBound<qint64>(0, qint64(std::floor((rect.left() - bounds.left()) / size)), columnCount - 1);
+    const qint64 lastColumn = qBound<qint64>(0, qint64(std::floor((rect.right() - bounds.left()) / size)), columnCount - 1);
+    const qint64 firstRow = qBound<qint64>(0, qint64(std::floor((rect.top() - bounds.top()) / size)), rowCount - 1);
+    const qint64 lastRow = qBound<qint64>(0, qint64(std::floor((rect.bottom() - bounds.top()) / size)), rowCount - 1);
+
+    const QVector<Cluster> &clusters = levels[level];
+    for (qint64 row = firstRow; row <= lastRow; ++row) {
+        const qint64 first = row * columnCount + firstColumn;
+        const qint64 last = row * columnCount + lastColumn;
+        auto it = std::lower_bound(clusters.begin(), clusters.end(), first, [](const Cluster &cluster, qint64 cell) {
+            /**
+             * @brief Lambda porównująca komórkę grupy z szukaną komórką.
+             * @param cluster Grupa.
+             * @param cell Szukana komórka.
+             * @return true, jeśli komórka grupy jest wcześniejsza.
+             */
+            return cluster.cell < cell;
+        });
+        for (; it != clusters.end() && it->cell <= last; ++it) {
+            result.append(int(it - clusters.begin()));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca grupę, której znacznik zawiera punkt (przy ostatnio narysowanej skali).
+ * @param point Punkt we współrzędnych warstwy.
+ * @return Indeks grupy w levels[paintLevel] lub -1.
+ *
+ * Przy nakładających się znacznikach wybierany jest ten o środku najbliżej punktu.
+ */
+int StationMarkerLayer::clusterAt(const QPointF &point) const {
+    const qreal margin = MaxClusterRadius / paintScale;
+    const QVector<int> candidates = clustersIn(paintLevel, QRectF(point.x() - margin, point.y() - margin, 2 * margin, 2 * margin));
+    int best = -1;
+    qreal bestDistance = 0.0;
+    for (int i : candidates) {
+        const Cluster &cluster = levels[paintLevel][i];
+        const QPointF delta = (cluster.position - point) * paintScale;
+        const qreal distance = std::sqrt(QPointF::dotProduct(delta, delta));
+        const qreal radius = cluster.count == 1 ? Radius : clusterRadius(cluster.count);
+        if (distance <= radius && (best < 0 || distance < bestDistance)) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Zwraca znacznik stacji.
+ * @param index Indeks stacji w katalogu.
+ * @return Indeks znacznika lub -1, jeśli stacja nie ma znacznika.
+ */
+int StationMarkerLayer::markerOf(int index) const {
+    return index >= 0 && index < markerOfStation.size() ? markerOfStation[index] : -1;
+}
+
+/**
+ * @brief Odświeża na ekranie obszar znacznika grupy (przy ostatnio narysowanej skali).
+ * @param cluster Grupa.
+ */
+void StationMarkerLayer::updateCluster(const Cluster &cluster) {
+    const qreal radius = ((cluster.count == 1 ? Radius : clusterRadius(cluster.count)) + 1.0) / paintScale;
+    update(QRectF(cluster.position.x() - radius, cluster.position.y() - radius, 2 * radius, 2 * radius));
+}
+
+/**
+ * @brief Zwraca bok komórki poziomu.
+ * @param level Poziom szczegółowości.
+ * @return Bok komórki (jednostki sceny).
+ */
+qreal StationMarkerLayer::cellSize(int level) {
+    return ClusterCellSize / qreal(1 << level);
+}
+
+/**
+ * @brief Zwraca promień znacznika grupy.
+ * @param count Liczba stacji w grupie.
+ * @return Promień w pikselach ekranu (rośnie logarytmicznie z liczbą stacji).
+ */
+qreal StationMarkerLayer::clusterRadius(int count) {
+    return qMin(MaxClusterRadius, 8.0 + 2.5 * std::log2(qreal(count)));
+}
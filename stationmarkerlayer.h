@@ -0,0 +1,167 @@
+/**
+ * @file stationmarkerlayer.h
+ * @brief Jeden element sceny rysujący znaczniki wszystkich stacji na mapie.
+ */
+
+#ifndef STATIONMARKERLAYER_H
+#define STATIONMARKERLAYER_H
+
+#include <QBitArray>
+#include <QGraphicsObject>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class StationMarkerLayer
+ * @brief Warstwa mapy rysująca wszystkie znaczniki stacji w jednym wywołaniu paint().
+ *
+ * Zamiast osobnego elementu sceny (i obiektu QObject z połączeniem sygnału) dla każdej stacji warstwa
+ * przechowuje tablicę pozycji i rysuje z niej widoczne znaczniki. Scena zawiera jeden element
+ * niezależnie od liczby stacji.
+ *
+ * Znaczniki są grupowane na LevelCount poziomach szczegółowości. Poziom z odpowiada skali widoku
+ * [2^z, 2^(z+1)) i grupuje stacje w komórkach siatki o boku ClusterCellSize / 2^z jednostek sceny
+ * (komórki kolejnego poziomu dzielą komórki poprzedniego na cztery); ostatni poziom pokazuje każdą
+ * stację osobno. Grupy danego poziomu są posortowane według komórki, więc rysowanie i wyszukiwanie
+ * przeglądają tylko wiersze siatki w odświeżanym obszarze. Rozmiary znaczników są stałe w pikselach
+ * ekranu.
+ *
+ * Kolor znacznika odpowiada klasie indeksu jakości powietrza stacji, a kolor grupy - najgorszej klasie
+ * wśród jej stacji. Zmiana klasy jednej stacji aktualizuje tylko grupy zawierające tę stację
+ * i odświeża na ekranie jedynie obszar jej znacznika.
+ */
+class StationMarkerLayer : public QGraphicsObject {
+    Q_OBJECT
+
+public:
+    /// Znacznik stacji.
+    struct Marker {
+        int index; ///< Indeks stacji w katalogu.
+        int stationId; ///< Identyfikator stacji.
+        QPointF position; ///< Środek znacznika we współrzędnych warstwy.
+        QString name; ///< Nazwa stacji (podpowiedź).
+    };
+
+    /**
+     * @brief Tworzy pustą warstwę.
+     * @param parent Element nadrzędny.
+     */
+    explicit StationMarkerLayer(QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief Ustawia znaczniki i wyznacza ich komórki na wszystkich poziomach.
+     * @param markers Znaczniki stacji.
+     */
+    void setMarkers(const QVector<Marker> &markers);
+    /**
+     * @brief Dodaje, przesuwa i usuwa znaczniki stacji zmienionych w katalogu.
+     * @param changed Znaczniki stacji nowych lub zmienionych (położenie, nazwa).
+     * @param removed Indeksy stacji, których znaczniki należy usunąć.
+     */
+    void updateMarkers(const QVector<Marker> &changed, const QVector<int> &removed);
+    /**
+     * @brief Ustawia, które stacje są widoczne, i grupuje widoczne znaczniki.
+     * @param mask Mapa bitowa indeksów stacji w katalogu (pusta - wszystkie widoczne).
+     */
+    void setVisibleStations(const QBitArray &mask);
+    /**
+     * @brief Ustawia klasę indeksu jakości powietrza stacji.
+     * @param index Indeks stacji w katalogu.
+     * @param band Klasa indeksu (-1 - brak indeksu).
+     */
+    void setStationBand(int index, int band);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    static constexpr qreal Radius = 5.0; ///< Promień znacznika pojedynczej stacji (piksele ekranu).
+    static constexpr qreal MaxClusterRadius = 18.0; ///< Największy promień znacznika grupy (piksele ekranu).
+    static constexpr qreal ClusterCellSize = 40.0; ///< Bok komórki grupowania na poziomie 0 (jednostki sceny).
+    static constexpr int LevelCount = 6; ///< Liczba poziomów szczegółowości.
+
+signals:
+    /**
+     * @brief Sygnał emitowany po kliknięciu znacznika pojedynczej stacji.
+     * @param stationId Identyfikator klikniętej stacji.
+     */
+    void stationClicked(int stationId);
+    /**
+     * @brief Sygnał emitowany po kliknięciu znacznika grupy stacji.
+     * @param scenePos Środek grupy we współrzędnych sceny.
+     */
+    void clusterClicked(const QPointF &scenePos);
+
+protected:
+    void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+
+private:
+    /// Grupa widocznych znaczników w jednej komórce poziomu.
+    struct Cluster {
+        qint64 cell; ///< Numer komórki (wiersz * liczba kolumn + kolumna).
+        QPointF position; ///< Średnia pozycja znaczników grupy.
+        int count; ///< Liczba znaczników.
+        int marker; ///< Ostatni znacznik grupy (jedyny, gdy count == 1).
+        int band; ///< Najgorsza klasa indeksu wśród znaczników grupy (-1 - brak indeksu).
+    };
+
+    /**
+     * @brief Wyznacza komórki znaczników na wszystkich poziomach i grupuje znaczniki.
+     */
+    void indexMarkers();
+    /**
+     * @brief Grupuje widoczne znaczniki na wszystkich poziomach.
+     */
+    void buildClusters();
+    /**
+     * @brief Zwraca grupy poziomu leżące w prostokącie komórek obejmującym podany obszar.
+     * @param level Poziom szczegółowości.
+     * @param rect Obszar we współrzędnych warstwy.
+     * @return Indeksy grup w levels[level].
+     */
+    QVector<int> clustersIn(int level, const QRectF &rect) const;
+    /**
+     * @brief Zwraca grupę, której znacznik zawiera punkt (przy ostatnio narysowanej skali).
+     * @param point Punkt we współrzędnych warstwy.
+     * @return Indeks grupy w levels[paintLevel] lub -1.
+     */
+    int clusterAt(const QPointF &point) const;
+    /**
+     * @brief Zwraca bok komórki poziomu.
+     * @param level Poziom szczegółowości.
+     * @return Bok komórki (jednostki sceny).
+     */
+    static qreal cellSize(int level);
+    /**
+     * @brief Zwraca promień znacznika grupy.
+     * @param count Liczba stacji w grupie.
+     * @return Promień w pikselach ekranu.
+     */
+    static qreal clusterRadius(int count);
+    /**
+     * @brief Odświeża na ekranie obszar znacznika grupy (przy ostatnio narysowanej skali).
+     * @param cluster Grupa.
+     */
+    void updateCluster(const Cluster &cluster);
+    /**
+     * @brief Zwraca znacznik stacji.
+     * @param index Indeks stacji w katalogu.
+     * @return Indeks znacznika lub -1, jeśli stacja nie ma znacznika.
+     */
+    int markerOf(int index) const;
+
+    QVector<Marker> markers; ///< Znaczniki stacji.
+    QVector<bool> visible; ///< Widoczność znaczników (w kolejności markers).
+    QVector<int> bands; ///< Klasy indeksu znaczników (w kolejności markers).
+    QVector<int> markerOfStation; ///< Indeks stacji w katalogu → indeks znacznika (-1 bez znacznika).
+    QRectF bounds; ///< Prostokąt obejmujący środki wszystkich znaczników.
+    QVector<int> columns; ///< Liczba kolumn siatki na każdym poziomie.
+    QVector<qint64> markerCells; ///< Komórka znacznika na każdym poziomie (poziom * liczba znaczników + znacznik).
+    QVector<QVector<Cluster>> levels; ///< Grupy widocznych znaczników na każdym poziomie, posortowane według komórki.
+    QVector<int> markerClusters; ///< Grupa znacznika na każdym poziomie (poziom * liczba znaczników + znacznik, -1 dla ukrytych).
+    int paintLevel = 0; ///< Poziom użyty przy ostatnim rysowaniu.
+    qreal paintScale = 1.0; ///< Skala widoku przy ostatnim rysowaniu.
+};
+
+#endif // STATIONMARKERLAYER_H
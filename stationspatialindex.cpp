@@ -0,0 +1,292 @@
+/**
+ * @file stationspatialindex.cpp
+ * @brief Implementacja siatkowego indeksu przestrzennego stacji.
+ */
+
+#include "stationspatialindex.h"
+#include "haversinebatch.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace {
+
+constexpr double KmPerDegree = 2.0 * M_PI * StationSpatialIndex::EarthRadiusKm / 360.0; ///< Długość stopnia południka.
+
+} // namespace
+
+/**
+ * @brief Buduje indeks dla stacji katalogu.
+ * @param catalog Katalog stacji (stacje bez współrzędnych są pomijane).
+ * @param cellSizeDeg Rozmiar komórki siatki w stopniach.
+ *
+ * Stacje są sortowane kubełkowo według komórek w dwóch przebiegach (zliczanie, rozmieszczenie).
+ */
+void StationSpatialIndex::build(const StationCatalog &catalog, double cellSizeDeg) {
+    clear();
+    cellSize = cellSizeDeg > 0 ? cellSizeDeg : 0.25;
+
+    // Zakres współrzędnych stacji
+    double maxLat = -90.0;
+    double maxLon = -180.0;
+    minLat = 90.0;
+    minLon = 180.0;
+    int count = 0;
+    for (int i = 0; i < catalog.size(); ++i) {
+        if (catalog.hasCoordinates(i)) {
+            minLat = qMin(minLat, catalog.latitude(i));
+            maxLat = qMax(maxLat, catalog.latitude(i));
+            minLon = qMin(minLon, catalog.longitude(i));
+            maxLon = qMax(maxLon, catalog.longitude(i));
+            count++;
+        }
+    }
+    if (count == 0) {
+        clear();
+        return;
+    }
+    rows = int((maxLat - minLat) / cellSize) + 1;
+    columns = int((maxLon - minLon) / cellSize) + 1;
+    minCosLat = std::cos(qDegreesToRadians(qMin(90.0, qMax(qAbs(minLat), qAbs(minLat + rows * cellSize)))));
+
+    // Zliczanie stacji w komórkach
+    QVector<int> cellOf(catalog.size(), -1);
+    cellStart.fill(0, rows * columns + 1);
+    for (int i = 0; i < catalog.size(); ++i) {
+        if (catalog.hasCoordinates(i)) {
+            cellOf[i] = rowOf(catalog.latitude(i)) * columns + columnOf(catalog.longitude(i));
+            cellStart[cellOf[i] + 1]++;
+        }
+    }
+    for (int cell = 0; cell < rows * columns; ++cell) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    // Rozmieszczenie stacji komórka po komórce
+    stations.resize(count);
+    latRad.resize(count);
+    lonRad.resize(count);
+    cosLat.resize(count);
+    QVector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < catalog.size(); ++i) {
+        if (cellOf[i] < 0) {
+            continue;
+        }
+        const int slot = fill[cellOf[i]]++;
+        stations[slot] = i;
+        latRad[slot] = qDegreesToRadians(catalog.latitude(i));
+        lonRad[slot] = qDegreesToRadians(catalog.longitude(i));
+        cosLat[slot] = std::cos(latRad[slot]);
+    }
+}
+
+/**
+ * @brief Usuwa zawartość indeksu.
+ */
+void StationSpatialIndex::clear() {
+    rows = 0;
+    columns = 0;
+    cellStart.clear();
+    stations.clear();
+    latRad.clear();
+    lonRad.clear();
+    cosLat.clear();
+}
+
+/**
+ * @brief Zwraca stacje w zadanym promieniu od punktu.
+ * @param lat Szerokość geograficzna punktu (stopnie).
+ * @param lon Długość geograficzna punktu (stopnie).
+ * @param radiusKm Promień w kilometrach.
+ * @return Znalezione stacje (w kolejności komórek, nieposortowane).
+ *
+ * Prostokąt komórek wyznaczany jest z rozpiętości okręgu w stopniach; dla długości geograficznej
+ * używany jest cosinus szerokości najbliższej biegunowi krawędzi prostokąta.
+ */
+QVector<StationSpatialIndex::Hit> StationSpatialIndex::withinRadius(double lat, double lon, double radiusKm) const {
+    QVector<Hit> result;
+    if (isEmpty() || radiusKm < 0) {
+        return result;
+    }
+
+    const double latSpan = radiusKm / KmPerDegree;
+    const double south = lat - latSpan;
+    const double north = lat + latSpan;
+    if (north < minLat || south > minLat + rows * cellSize) {
+        return result;
+    }
+    const double edgeCos = std::cos(qDegreesToRadians(qMin(89.0, qMax(qAbs(south), qAbs(north)))));
+    const double lonSpan = (north >= 89.0 || south <= -89.0) ? 360.0 : latSpan / edgeCos;
+    const int firstRow = rowOf(south);
+    const int lastRow = rowOf(north);
+    const int firstColumn = columnOf(lon - lonSpan);
+    const int lastColumn = columnOf(lon + lonSpan);
+
+    // Próg dla a = sin²(Δφ/2) + cos φ1 cos φ2 sin²(Δλ/2), odpowiadający promieniowi
+    const double maxA = HaversineBatch::termForDistance(radiusKm);
+    const double queryLat = qDegreesToRadians(lat);
+    const double queryLon = qDegreesToRadians(lon);
+
+    std::vector<double> terms;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        // Komórki jednego wiersza leżą obok siebie w tablicach stacji - liczone jednym wywołaniem jądra
+        const int begin = cellStart[row * columns + firstColumn];
+        const int end = cellStart[row * columns + lastColumn + 1];
+        terms.resize(end - begin);
+        HaversineBatch::computeTerms(latRad.constData() + begin, lonRad.constData() + begin, cosLat.constData() + begin,
+                                     end - begin, queryLat, queryLon, terms.data());
+        for (int slot = begin; slot < end; ++slot) {
+            const double a = terms[slot - begin];
+            if (a <= maxA) {
+                result.append({stations[slot], HaversineBatch::distanceKm(a)});
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca k stacji najbliższych punktowi.
+ * @param lat Szerokość geograficzna punktu (stopnie).
+ * @param lon Długość geograficzna punktu (stopnie).
+ * @param k Liczba stacji.
+ * @return Co najwyżej k stacji, posortowanych rosnąco według odległości.
+ *
+ * Kopiec przechowuje wartości @c a wzoru haversine (monotoniczne względem odległości), więc asin()
+ * liczony jest tylko dla k zwróconych stacji.
+ */
+QVector<StationSpatialIndex::Hit> StationSpatialIndex::nearest(double lat, double lon, int k) const {
+    QVector<Hit> result;
+    if (isEmpty() || k <= 0) {
+        return result;
+    }
+    k = qMin(k, size());
+
+    const double queryLat = qDegreesToRadians(lat);
+    const double queryLon = qDegreesToRadians(lon);
+    const int row = rowOf(lat);
+    const int column = columnOf(lon);
+
+    // Kopiec maksymalny (a, slot) - na szczycie najdalszy z k dotychczasowych kandydatów
+    std::priority_queue<std::pair<double, int>> best;
+    std::vector<double> terms;
+    auto visitCell = [&](int cellRow, int cellColumn) {
+        /**
+         * @brief Lambda sprawdzająca stacje jednej komórki siatki.
+         * @param cellRow Wiersz komórki.
+         * @param cellColumn Kolumna komórki.
+         */
+        if (cellRow < 0 || cellRow >= rows || cellColumn < 0 || cellColumn >= columns) {
+            return;
+        }
+        const int cell = cellRow * columns + cellColumn;
+        const int begin = cellStart[cell];
+        const int end = cellStart[cell + 1];
+        terms.resize(end - begin);
+        HaversineBatch::computeTerms(latRad.constData() + begin, lonRad.constData() + begin, cosLat.constData() + begin,
+                                     end - begin, queryLat, queryLon, terms.data());
+        for (int slot = begin; slot < end; ++slot) {
+            const double a = terms[slot - begin];
+            if (int(best.size()) < k) {
+                best.emplace(a, slot);
+            } else if (a < best.top().first) {
+                best.pop();
+                best.emplace(a, slot);
+            }
+        }
+    };
+
+    const int maxRing = qMax(rows, columns);
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        if (ring == 0) {
+            visitCell(row, column);
+        } else {
+            // Obwód kwadratu komórek w odległości ring od komórki punktu
+            for (int c = column - ring; c <= column + ring; ++c) {
+                visitCell(row - ring, c);
+                visitCell(row + ring, c);
+            }
+            for (int r = row - ring + 1; r <= row + ring - 1; ++r) {
+                visitCell(r, column - ring);
+                visitCell(r, column + ring);
+            }
+        }
+        if (int(best.size()) == k) {
+            const double farthest = HaversineBatch::distanceKm(best.top().first);
+            if (distanceOutsideRing(lat, lon, row, column, ring) > farthest) {
+                break;
+            }
+        }
+    }
+
+    result.resize(int(best.size()));
+    for (int i = result.size() - 1; i >= 0; --i) {
+        result[i] = {stations[best.top().second], HaversineBatch::distanceKm(best.top().first)};
+        best.pop();
+    }
+    return result;
+}
+
+/**
+ * @brief Dolne ograniczenie odległości do stacji spoza bloku komórek wokół punktu.
+ * @param lat Szerokość geograficzna punktu (stopnie).
+ * @param lon Długość geograficzna punktu (stopnie).
+ * @param row Wiersz komórki punktu.
+ * @param column Kolumna komórki punktu.
+ * @param ring Promień bloku w komórkach.
+ * @return Odległość w kilometrach, poniżej której nie ma stacji spoza bloku.
+ *
+ * Stacja poza blokiem różni się od punktu o co najmniej Δφ w szerokości (d ≥ R·Δφ) albo o Δλ w długości
+ * (d ≥ 2R·asin(cos φmax · sin(Δλ/2)), gdzie φmax to największa szerokość w siatce lub szerokość punktu).
+ */
+double StationSpatialIndex::distanceOutsideRing(double lat, double lon, int row, int column, int ring) const {
+    const double inf = std::numeric_limits<double>::infinity();
+    double bound = inf;
+
+    // Punkt spoza siatki leży w skrajnej komórce - odległość do krawędzi może być ujemna, liczy się 0
+    if (row - ring > 0) {
+        bound = qMin(bound, qDegreesToRadians(qMax(0.0, lat - (minLat + (row - ring) * cellSize))) * EarthRadiusKm);
+    }
+    if (row + ring < rows - 1) {
+        bound = qMin(bound, qDegreesToRadians(qMax(0.0, minLat + (row + ring + 1) * cellSize - lat)) * EarthRadiusKm);
+    }
+    // Punkt może leżeć poza siatką - liczy się mniejszy z cosinusów jego i stacji
+    const double cosBound = qMin(minCosLat, std::cos(qDegreesToRadians(qMin(90.0, qAbs(lat)))));
+    auto lonBound = [cosBound](double deltaDeg) {
+        /**
+         * @brief Lambda zamieniająca różnicę długości na dolne ograniczenie odległości.
+         * @param deltaDeg Różnica długości geograficznej (stopnie).
+         * @return Odległość w kilometrach.
+         */
+        const double s = cosBound * std::sin(qDegreesToRadians(qMin(180.0, qMax(0.0, deltaDeg))) * 0.5);
+        return 2.0 * EarthRadiusKm * std::asin(qMin(1.0, s));
+    };
+    if (column - ring > 0) {
+        bound = qMin(bound, lonBound(lon - (minLon + (column - ring) * cellSize)));
+    }
+    if (column + ring < columns - 1) {
+        bound = qMin(bound, lonBound(minLon + (column + ring + 1) * cellSize - lon));
+    }
+    return bound;
+}
+
+/**
+ * @brief Zwraca numer wiersza siatki dla szerokości geograficznej.
+ * @param lat Szerokość geograficzna (stopnie).
+ * @return Wiersz przycięty do zakresu siatki.
+ */
+int StationSpatialIndex::rowOf(double lat) const {
+    return qBound(0, int(std::floor((lat - minLat) / cellSize)), rows - 1);
+}
+
+/**
+ * @brief Zwraca numer kolumny siatki dla długości geograficznej.
+ * @param lon Długość geograficzna (stopnie).
+ * @return Kolumna przycięta do zakresu siatki.
+ */
+int StationSpatialIndex::columnOf(double lon) const {
+    return qBound(0, int(std::floor((lon - minLon) / cellSize)), columns - 1);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file stationspatialindex.h
+ * @brief Siatkowy indeks przestrzenny współrzędnych stacji do zapytań o promień.
+ */
+
+#ifndef STATIONSPATIALINDEX_H
+#define STATIONSPATIALINDEX_H
+
+#include <QVector>
+#include "haversinebatch.h"
+#include "stationcatalog.h"
+
+/**
+ * @class StationSpatialIndex
+ * @brief Indeks stacji w siatce szerokości/długości geograficznej ze sprawdzaniem odległości wzorem haversine.
+ *
+ * Stacje z współrzędnymi są przypisywane do komórek siatki o stałym rozmiarze w stopniach i zapisywane
+ * komórka po komórce (tablica przesunięć + tablica indeksów), razem z przeliczonymi radianami i cosinusami
+ * szerokości. Zapytanie o promień odwiedza tylko komórki przecinające prostokąt otaczający okrąg,
+ * a odległość liczy dopiero dla stacji z tych komórek, wsadowo jądrem HaversineBatch (kolejne komórki
+ * wiersza leżą w tablicach obok siebie); stacje poza promieniem są odrzucane bez wywołania asin().
+ *
+ * Zapytanie o k najbliższych stacji przegląda komórki pierścieniami wokół punktu, trzymając k najlepszych
+ * kandydatów w kopcu ograniczonym do k elementów, i kończy się, gdy dolne ograniczenie odległości
+ * do następnego pierścienia przekracza odległość najdalszego z nich.
+ *
+ * Indeks budowany jest raz po wczytaniu katalogu; wyniki adresują stacje ich indeksem w katalogu.
+ */
+class StationSpatialIndex {
+public:
+    /// Stacja znaleziona w zapytaniu.
+    struct Hit {
+        int index; ///< Indeks stacji w katalogu.
+        double distanceKm; ///< Odległość od punktu zapytania w kilometrach.
+    };
+
+    static constexpr double EarthRadiusKm = HaversineBatch::EarthRadiusKm; ///< Średni promień Ziemi.
+
+    /**
+     * @brief Buduje indeks dla stacji katalogu.
+     * @param catalog Katalog stacji (stacje bez współrzędnych są pomijane).
+     * @param cellSizeDeg Rozmiar komórki siatki w stopniach.
+     */
+    void build(const StationCatalog &catalog, double cellSizeDeg = 0.25);
+    /**
+     * @brief Usuwa zawartość indeksu.
+     */
+    void clear();
+
+    bool isEmpty() const { return stations.isEmpty(); } ///< Czy indeks jest pusty.
+    int size() const { return stations.size(); } ///< Liczba zaindeksowanych stacji.
+
+    /**
+     * @brief Zwraca stacje w zadanym promieniu od punktu.
+     * @param lat Szerokość geograficzna punktu (stopnie).
+     * @param lon Długość geograficzna punktu (stopnie).
+     * @param radiusKm Promień w kilometrach.
+     * @return Znalezione stacje (w kolejności komórek, nieposortowane).
+     */
+    QVector<Hit> withinRadius(double lat, double lon, double radiusKm) const;
+    /**
+     * @brief Zwraca k stacji najbliższych punktowi.
+     * @param lat Szerokość geograficzna punktu (stopnie).
+     * @param lon Długość geograficzna punktu (stopnie).
+     * @param k Liczba stacji.
+     * @return Co najwyżej k stacji, posortowanych rosnąco według odległości.
+     */
+    QVector<Hit> nearest(double lat, double lon, int k) const;
+
+private:
+    /**
+     * @brief Zwraca numer wiersza siatki dla szerokości geograficznej.
+     * @param lat Szerokość geograficzna (stopnie).
+     * @return Wiersz przycięty do zakresu siatki.
+     */
+    int rowOf(double lat) const;
+    /**
+     * @brief Zwraca numer kolumny siatki dla długości geograficznej.
+     * @param lon Długość geograficzna (stopnie).
+     * @return Kolumna przycięta do zakresu siatki.
+     */
+    int columnOf(double lon) const;
+
+    /**
+     * @brief Dolne ograniczenie odległości do stacji spoza bloku komórek wokół punktu.
+     * @param lat Szerokość geograficzna punktu (stopnie).
+     * @param lon Długość geograficzna punktu (stopnie).
+     * @param row Wiersz komórki punktu.
+     * @param column Kolumna komórki punktu.
+     * @param ring Promień bloku w komórkach.
+     * @return Odległość w kilometrach, poniżej której nie ma stacji spoza bloku.
+     */
+    double distanceOutsideRing(double lat, double lon, int row, int column, int ring) const;
+
+    double cellSize = 0.25; ///< Rozmiar komórki w stopniach.
+    double minLat = 0.0; ///< Szerokość dolnej krawędzi siatki.
+    double minLon = 0.0; ///< Długość lewej krawędzi siatki.
+    int rows = 0; ///< Liczba wierszy siatki.
+    int columns = 0; ///< Liczba kolumn siatki.
+    double minCosLat = 1.0; ///< Najmniejszy cosinus szerokości w obrębie siatki.
+    QVector<int> cellStart; ///< Początek komórki w tablicach stacji (rows * columns + 1 wartości).
+    QVector<int> stations; ///< Indeksy stacji w katalogu, uporządkowane komórkami.
+    QVector<double> latRad; ///< Szerokości stacji w radianach (w kolejności stations).
+    QVector<double> lonRad; ///< Długości stacji w radianach (w kolejności stations).
+    QVector<double> cosLat; ///< Cosinusy szerokości stacji (w kolejności stations).
+};
+
+#endif // STATIONSPATIALINDEX_H
@@ -0,0 +1,144 @@
+/**
+ * @file stationtextindex.cpp
+ * @brief Implementacja trigramowego indeksu nazw stacji.
+ */
+
+#include "stationtextindex.h"
+
+/**
+ * @brief Buduje indeks dla stacji katalogu.
+ * @param catalog Katalog stacji.
+ *
+ * Nazwy miejscowości są internowane w katalogu, więc każda jest normalizowana tylko raz.
+ * Stacje usunięte z katalogu (StationCatalog::merge()) nie są wyszukiwane.
+ */
+void StationTextIndex::build(const StationCatalog &catalog) {
+    clear();
+    keys.reserve(catalog.size());
+    allStations.reserve(catalog.size());
+    QHash<QString, QByteArray> foldedCities;
+    for (int i = 0; i < catalog.size(); ++i) {
+        auto city = foldedCities.find(catalog.city(i));
+        if (city == foldedCities.end()) {
+            city = foldedCities.insert(catalog.city(i), fold(catalog.city(i)).toUtf8());
+        }
+        const QByteArray key = city.value() + '\n' + fold(catalog.name(i)).toUtf8();
+        keys.append(key);
+        if (catalog.isRemoved(i)) {
+            continue;
+        }
+        allStations.append(i);
+
+        for (int position = 0; position + 3 <= key.size(); ++position) {
+            QVector<int> &list = postings[trigramAt(key, position)];
+            // Stacje dodawane są rosnąco, więc powtórzony trigram tej samej stacji jest na końcu listy
+            if (list.isEmpty() || list.last() != i) {
+                list.append(i);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Usuwa zawartość indeksu.
+ */
+void StationTextIndex::clear() {
+    keys.clear();
+    postings.clear();
+    allStations.clear();
+    lastQuery.clear();
+    lastResult.clear();
+}
+
+/**
+ * @brief Zwraca stacje, których miejscowość lub nazwa zawiera tekst.
+ * @param text Szukany tekst (wielkość liter i znaki diakrytyczne są pomijane).
+ * @return Indeksy stacji w katalogu, rosnąco (wszystkie stacje dla pustego tekstu).
+ */
+QVector<int> StationTextIndex::search(const QString &text) {
+    const QByteArray query = fold(text.trimmed()).toUtf8();
+    if (query.isEmpty()) {
+        lastQuery.clear();
+        lastResult = allStations;
+        return lastResult;
+    }
+    if (query == lastQuery) {
+        return lastResult;
+    }
+
+    QVector<int> result;
+    if (!lastQuery.isEmpty() && query.contains(lastQuery)) {
+        // Każda stacja pasująca do dłuższego zapytania pasuje też do poprzedniego
+        result = filter(lastResult, query);
+    } else if (query.size() >= 3) {
+        // Kandydaci z najkrótszej listy trigramu - brak trigramu oznacza brak wyników
+        const QVector<int> *shortest = nullptr;
+        for (int position = 0; position + 3 <= query.size(); ++position) {
+            auto it = postings.constFind(trigramAt(query, position));
+            if (it == postings.constEnd()) {
+                shortest = nullptr;
+                break;
+            }
+            if (!shortest || it->size() < shortest->size()) {
+                shortest = &it.value();
+            }
+        }
+        if (shortest) {
+            result = filter(*shortest, query);
+        }
+    } else {
+        result = filter(allStations, query);
+    }
+
+    lastQuery = query;
+    lastResult = result;
+    return result;
+}
+
+/**
+ * @brief Normalizuje tekst do porównań: małe litery bez znaków diakrytycznych.
+ * @param text Tekst.
+ * @return Znormalizowany tekst.
+ *
+ * Znaki są rozkładane (NFD) i pozbawiane znaków łączących; litera "ł", która nie ma rozkładu,
+ * zamieniana jest na "l".
+ */
+QString StationTextIndex::fold(const QString &text) {
+    const QString decomposed = text.toLower().normalized(QString::NormalizationForm_D);
+    QString result;
+    result.reserve(decomposed.size());
+    for (QChar c : decomposed) {
+        if (c.category() == QChar::Mark_NonSpacing) {
+            continue;
+        }
+        result.append(c == QChar(0x0142) ? QChar('l') : c);
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca stacje z podanej listy, których klucz zawiera tekst.
+ * @param candidates Indeksy stacji do sprawdzenia.
+ * @param needle Znormalizowany tekst (UTF-8).
+ * @return Pasujące indeksy (w kolejności listy).
+ */
+QVector<int> StationTextIndex::filter(const QVector<int> &candidates, const QByteArray &needle) const {
+    QVector<int> result;
+    for (int index : candidates) {
+        if (keys[index].contains(needle)) {
+            result.append(index);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca klucz trigramu zaczynającego się w danym miejscu tekstu.
+ * @param text Tekst (UTF-8).
+ * @param position Pozycja pierwszego bajtu trigramu.
+ * @return Klucz trigramu.
+ */
+quint32 StationTextIndex::trigramAt(const QByteArray &text, int position) {
+    return (quint32(uchar(text[position])) << 16) | (quint32(uchar(text[position + 1])) << 8)
+           | quint32(uchar(text[position + 2]));
+}
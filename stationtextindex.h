@@ -0,0 +1,76 @@
+/**
+ * @file stationtextindex.h
+ * @brief Trigramowy indeks nazw miejscowości i stacji do wyszukiwania podciągów.
+ */
+
+#ifndef STATIONTEXTINDEX_H
+#define STATIONTEXTINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "stationcatalog.h"
+
+/**
+ * @class StationTextIndex
+ * @brief Indeks wyszukiwania stacji po fragmencie nazwy miejscowości lub stacji.
+ *
+ * Dla każdej stacji przechowywany jest znormalizowany klucz (małe litery, bez znaków diakrytycznych,
+ * więc "lodz" pasuje do "Łódź") oraz listy stacji dla każdego trigramu klucza. Zapytanie o co najmniej
+ * trzy znaki sprawdza tylko stacje z najkrótszej listy spośród trigramów zapytania; krótsze zapytania
+ * przeglądają gotowe klucze bez ponownej normalizacji.
+ *
+ * Indeks pamięta wynik poprzedniego zapytania: jeśli nowe zapytanie zawiera poprzednie (np. kolejny
+ * wpisany znak), zawężany jest poprzedni wynik zamiast wyszukiwania od początku.
+ */
+class StationTextIndex {
+public:
+    /**
+     * @brief Buduje indeks dla stacji katalogu.
+     * @param catalog Katalog stacji.
+     */
+    void build(const StationCatalog &catalog);
+    /**
+     * @brief Usuwa zawartość indeksu.
+     */
+    void clear();
+
+    /**
+     * @brief Zwraca stacje, których miejscowość lub nazwa zawiera tekst.
+     * @param text Szukany tekst (wielkość liter i znaki diakrytyczne są pomijane).
+     * @return Indeksy stacji w katalogu, rosnąco (wszystkie stacje dla pustego tekstu).
+     */
+    QVector<int> search(const QString &text);
+
+    /**
+     * @brief Normalizuje tekst do porównań: małe litery bez znaków diakrytycznych.
+     * @param text Tekst.
+     * @return Znormalizowany tekst.
+     */
+    static QString fold(const QString &text);
+
+private:
+    /**
+     * @brief Zwraca stacje z podanej listy, których klucz zawiera tekst.
+     * @param candidates Indeksy stacji do sprawdzenia.
+     * @param needle Znormalizowany tekst (UTF-8).
+     * @return Pasujące indeksy (w kolejności listy).
+     */
+    QVector<int> filter(const QVector<int> &candidates, const QByteArray &needle) const;
+    /**
+     * @brief Zwraca klucz trigramu zaczynającego się w danym miejscu tekstu.
+     * @param text Tekst (UTF-8).
+     * @param position Pozycja pierwszego bajtu trigramu.
+     * @return Klucz trigramu.
+     */
+    static quint32 trigramAt(const QByteArray &text, int position);
+
+    QVector<QByteArray> keys; ///< Znormalizowane "miejscowość\nnazwa" każdej stacji (UTF-8).
+    QHash<quint32, QVector<int>> postings; ///< Trigram → rosnące indeksy stacji zawierających go.
+    QVector<int> allStations; ///< Indeksy wszystkich stacji (wynik pustego zapytania).
+    QByteArray lastQuery; ///< Znormalizowane poprzednie zapytanie.
+    QVector<int> lastResult; ///< Wynik poprzedniego zapytania.
+};
+
+#endif // STATIONTEXTINDEX_H
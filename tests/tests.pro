@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_giostime \
+    tst_haversinebatch \
+    tst_stationinfocard
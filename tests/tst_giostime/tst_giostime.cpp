@@ -0,0 +1,221 @@
+/**
+ * @file tst_giostime.cpp
+ * @brief Testy i pomiary wydajności kodera dat GiosTime względem QDateTime::fromString/toString.
+ */
+
+#include "giostime.h"
+#include <QDateTime>
+#include <QTimeZone>
+#include <QtTest>
+
+/**
+ * @class TestGiosTime
+ * @brief Porównuje GiosTime z dotychczasową ścieżką QDateTime dla dat w formacie GIOŚ.
+ *
+ * Dane to kolejne godziny dwóch lat (z obiema zmianami czasu), tak jak w historii jednego sensora.
+ */
+class TestGiosTime : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void parseMatchesQDateTime();
+    void formatMatchesQDateTime();
+    void columnsMatchSingle();
+    void invalidDates();
+    void benchmarkParseQDateTime();
+    void benchmarkParse();
+    void benchmarkParseColumn();
+    void benchmarkFormatQDateTime();
+    void benchmarkFormat();
+    void benchmarkFormatColumn();
+
+private:
+    static constexpr const char *Format = "yyyy-MM-dd HH:mm:ss"; ///< Format dat API GIOŚ.
+
+    QTimeZone warsaw;            ///< Strefa czasowa Europe/Warsaw.
+    QVector<qint64> timestamps;  ///< Kolejne pełne godziny (sekundy od epoki).
+    QStringList texts;           ///< Te same chwile zapisane w formacie GIOŚ (przez QDateTime).
+
+    qint64 parseWithQDateTime(const QString &text) const;
+    bool isNearTransition(qint64 epochSecs) const;
+};
+
+/**
+ * @brief Przygotowuje godzinowe znaczniki czasu z lat 2024-2025 i ich zapis tekstowy.
+ */
+void TestGiosTime::initTestCase() {
+    warsaw = QTimeZone("Europe/Warsaw");
+    QVERIFY(warsaw.isValid());
+
+    const qint64 start = QDateTime(QDate(2024, 1, 1), QTime(0, 0), warsaw).toSecsSinceEpoch();
+    const int hours = 2 * 365 * 24;
+    timestamps.reserve(hours);
+    texts.reserve(hours);
+    for (int i = 0; i < hours; ++i) {
+        const qint64 t = start + qint64(i) * 3600;
+        timestamps.append(t);
+        texts.append(QDateTime::fromSecsSinceEpoch(t, warsaw).toString(Format));
+    }
+}
+
+/**
+ * @brief Parsuje datę tak jak dawne StationInfoCard::updateChart, w strefie Europe/Warsaw.
+ * @param text Tekst daty.
+ * @return Czas w sekundach od epoki.
+ */
+qint64 TestGiosTime::parseWithQDateTime(const QString &text) const {
+    const QDateTime local = QDateTime::fromString(text, Format);
+    return QDateTime(local.date(), local.time(), warsaw).toSecsSinceEpoch();
+}
+
+/**
+ * @brief Sprawdza, czy godzina sąsiaduje ze zmianą czasu (zapis tekstowy może być niejednoznaczny).
+ * @param epochSecs Czas w sekundach od epoki.
+ * @return true, jeśli przesunięcie strefy godzinę wcześniej lub później jest inne.
+ */
+bool TestGiosTime::isNearTransition(qint64 epochSecs) const {
+    const int offset = warsaw.offsetFromUtc(QDateTime::fromSecsSinceEpoch(epochSecs, QTimeZone::UTC));
+    return warsaw.offsetFromUtc(QDateTime::fromSecsSinceEpoch(epochSecs - 3600, QTimeZone::UTC)) != offset
+           || warsaw.offsetFromUtc(QDateTime::fromSecsSinceEpoch(epochSecs + 3600, QTimeZone::UTC)) != offset;
+}
+
+/**
+ * @brief Sprawdza, że GiosTime::parse daje ten sam wynik co QDateTime::fromString.
+ *
+ * Godziny przy zmianie czasu są pomijane w porównaniu z QDateTime (rozstrzyganie niejednoznacznej godziny
+ * zależy od wersji Qt); dla nich sprawdzane jest tylko, że wynik to jedna z dwóch możliwych chwil.
+ */
+void TestGiosTime::parseMatchesQDateTime() {
+    for (int i = 0; i < texts.size(); ++i) {
+        qint64 parsed = 0;
+        QVERIFY2(GiosTime::parse(QStringView(texts[i]), &parsed), qPrintable(texts[i]));
+        if (isNearTransition(timestamps[i])) {
+            QVERIFY2(parsed == timestamps[i] || qAbs(parsed - timestamps[i]) == 3600, qPrintable(texts[i]));
+            continue;
+        }
+        QCOMPARE(parsed, timestamps[i]);
+        QCOMPARE(parsed, parseWithQDateTime(texts[i]));
+    }
+}
+
+/**
+ * @brief Sprawdza, że GiosTime::format daje ten sam tekst co QDateTime::toString.
+ */
+void TestGiosTime::formatMatchesQDateTime() {
+    for (int i = 0; i < timestamps.size(); ++i) {
+        QCOMPARE(GiosTime::format(timestamps[i]), texts[i]);
+    }
+}
+
+/**
+ * @brief Sprawdza, że wersje kolumnowe zgadzają się z pojedynczymi wywołaniami.
+ */
+void TestGiosTime::columnsMatchSingle() {
+    QVector<qint64> parsed;
+    QVector<bool> valid;
+    QCOMPARE(GiosTime::parseColumn(texts, &parsed, &valid), int(texts.size()));
+    const QByteArray formatted = GiosTime::formatColumn(timestamps);
+    QCOMPARE(int(formatted.size()), int(timestamps.size()) * GiosTime::TextLength);
+
+    for (int i = 0; i < texts.size(); ++i) {
+        qint64 single = 0;
+        GiosTime::parse(QStringView(texts[i]), &single);
+        QVERIFY(valid[i]);
+        QCOMPARE(parsed[i], single);
+        QCOMPARE(QString::fromLatin1(formatted.constData() + i * GiosTime::TextLength, GiosTime::TextLength), texts[i]);
+    }
+}
+
+/**
+ * @brief Sprawdza odrzucanie niepoprawnych dat.
+ */
+void TestGiosTime::invalidDates() {
+    qint64 parsed = 0;
+    QVERIFY(!GiosTime::parse(QStringView(u""), &parsed));
+    QVERIFY(!GiosTime::parse(QStringView(u"2025-04-22 12:00"), &parsed));
+    QVERIFY(!GiosTime::parse(QStringView(u"2025-13-01 00:00:00"), &parsed));
+    QVERIFY(!GiosTime::parse(QStringView(u"2025-02-30 00:00:00"), &parsed));
+    QVERIFY(!GiosTime::parse(QStringView(u"2025-04-22 24:00:00"), &parsed));
+    QVERIFY(!GiosTime::parse(QStringView(u"2025-04-22T12:00:00"), &parsed));
+}
+
+/**
+ * @brief Mierzy parsowanie kolumny dat przez QDateTime::fromString.
+ */
+void TestGiosTime::benchmarkParseQDateTime() {
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const QString &text : std::as_const(texts)) {
+            sum += parseWithQDateTime(text);
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+/**
+ * @brief Mierzy parsowanie kolumny dat pojedynczymi wywołaniami GiosTime::parse.
+ */
+void TestGiosTime::benchmarkParse() {
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const QString &text : std::as_const(texts)) {
+            qint64 parsed = 0;
+            GiosTime::parse(QStringView(text), &parsed);
+            sum += parsed;
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+/**
+ * @brief Mierzy parsowanie kolumny dat przez GiosTime::parseColumn.
+ */
+void TestGiosTime::benchmarkParseColumn() {
+    QVector<qint64> parsed;
+    QBENCHMARK {
+        GiosTime::parseColumn(texts, &parsed);
+    }
+    QCOMPARE(parsed.size(), timestamps.size());
+}
+
+/**
+ * @brief Mierzy formatowanie kolumny dat przez QDateTime::toString.
+ */
+void TestGiosTime::benchmarkFormatQDateTime() {
+    qsizetype length = 0;
+    QBENCHMARK {
+        for (qint64 t : std::as_const(timestamps)) {
+            length += QDateTime::fromSecsSinceEpoch(t, warsaw).toString(Format).size();
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+/**
+ * @brief Mierzy formatowanie kolumny dat pojedynczymi wywołaniami GiosTime::format.
+ */
+void TestGiosTime::benchmarkFormat() {
+    qsizetype length = 0;
+    QBENCHMARK {
+        for (qint64 t : std::as_const(timestamps)) {
+            length += GiosTime::format(t).size();
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+/**
+ * @brief Mierzy formatowanie kolumny dat przez GiosTime::formatColumn.
+ */
+void TestGiosTime::benchmarkFormatColumn() {
+    QByteArray formatted;
+    QBENCHMARK {
+        formatted = GiosTime::formatColumn(timestamps);
+    }
+    QCOMPARE(int(formatted.size()), int(timestamps.size()) * GiosTime::TextLength);
+}
+
+QTEST_APPLESS_MAIN(TestGiosTime)
+
+#include "tst_giostime.moc"
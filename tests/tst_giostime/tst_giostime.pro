@@ -0,0 +1,16 @@
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_giostime
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_giostime.cpp \
+    ../../giostime.cpp
+
+HEADERS += \
+    ../../giostime.h
@@ -0,0 +1,212 @@
+/**
+ * @file tst_haversinebatch.cpp
+ * @brief Testy i pomiary wydajności jądra HaversineBatch względem skalarnego wzoru haversine.
+ */
+
+#include "haversinebatch.h"
+#include <QRandomGenerator>
+#include <QVector>
+#include <QtMath>
+#include <QtTest>
+
+/**
+ * @class TestHaversineBatch
+ * @brief Porównuje filtrowanie stacji po promieniu jądrem wsadowym i wzorem skalarnym.
+ *
+ * Wzorzec skalarny to dawne MainWindow::calculateDistance (qSin/qCos/qAtan2 dla każdej stacji).
+ */
+class TestHaversineBatch : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void termsMatchScalar();
+    void radiusFilter_data();
+    void radiusFilter();
+    void benchmarkScalar_data();
+    void benchmarkScalar();
+    void benchmarkBatch_data();
+    void benchmarkBatch();
+
+private:
+    static constexpr double QueryLat = 52.2297;   ///< Szerokość punktu zapytania (Warszawa).
+    static constexpr double QueryLon = 21.0122;   ///< Długość punktu zapytania (Warszawa).
+
+    QVector<double> latitudes;   ///< Szerokości stacji (stopnie).
+    QVector<double> longitudes;  ///< Długości stacji (stopnie).
+    QVector<double> latRad;      ///< Szerokości stacji (radiany).
+    QVector<double> lonRad;      ///< Długości stacji (radiany).
+    QVector<double> cosLat;      ///< Cosinusy szerokości stacji.
+
+    static double scalarDistance(double lat1, double lon1, double lat2, double lon2);
+    int countScalar(double radiusKm) const;
+    int countBatch(double radiusKm, QVector<double> &terms) const;
+    static void addSizes();
+};
+
+/**
+ * @brief Oblicza odległość wzorem haversine tak jak dawne MainWindow::calculateDistance.
+ * @param lat1 Szerokość pierwszego punktu (stopnie).
+ * @param lon1 Długość pierwszego punktu (stopnie).
+ * @param lat2 Szerokość drugiego punktu (stopnie).
+ * @param lon2 Długość drugiego punktu (stopnie).
+ * @return Odległość w kilometrach.
+ */
+double TestHaversineBatch::scalarDistance(double lat1, double lon1, double lat2, double lon2) {
+    const double R = 6371.0;
+    double lat1Rad = qDegreesToRadians(lat1);
+    double lon1Rad = qDegreesToRadians(lon1);
+    double lat2Rad = qDegreesToRadians(lat2);
+    double lon2Rad = qDegreesToRadians(lon2);
+
+    double dLat = lat2Rad - lat1Rad;
+    double dLon = lon2Rad - lon1Rad;
+
+    double a = qSin(dLat / 2) * qSin(dLat / 2) +
+               qCos(lat1Rad) * qCos(lat2Rad) * qSin(dLon / 2) * qSin(dLon / 2);
+    double c = 2 * qAtan2(qSqrt(a), qSqrt(1 - a));
+    return R * c;
+}
+
+/**
+ * @brief Losuje stacje w granicach Polski (stałe ziarno, powtarzalne wyniki).
+ *
+ * Liczba stacji jest kilkukrotnie większa niż w katalogu GIOŚ, aby pomiar nie był zdominowany narzutem pętli.
+ */
+void TestHaversineBatch::initTestCase() {
+    QRandomGenerator random(20250422);
+    const int count = 8192;
+    latitudes.reserve(count);
+    longitudes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        latitudes.append(49.0 + random.generateDouble() * 5.9);
+        longitudes.append(14.1 + random.generateDouble() * 10.1);
+    }
+
+    latRad.reserve(count);
+    lonRad.reserve(count);
+    cosLat.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        latRad.append(qDegreesToRadians(latitudes[i]));
+        lonRad.append(qDegreesToRadians(longitudes[i]));
+        cosLat.append(std::cos(latRad.last()));
+    }
+}
+
+/**
+ * @brief Liczy stacje w promieniu wzorem skalarnym.
+ * @param radiusKm Promień w kilometrach.
+ * @return Liczba stacji w promieniu.
+ */
+int TestHaversineBatch::countScalar(double radiusKm) const {
+    int found = 0;
+    for (int i = 0; i < latitudes.size(); ++i) {
+        if (scalarDistance(QueryLat, QueryLon, latitudes[i], longitudes[i]) <= radiusKm) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Liczy stacje w promieniu jądrem wsadowym (porównanie składnika @c a z progiem, bez asin()).
+ * @param radiusKm Promień w kilometrach.
+ * @param terms Bufor na składniki @c a (rozmiar równy liczbie stacji).
+ * @return Liczba stacji w promieniu.
+ */
+int TestHaversineBatch::countBatch(double radiusKm, QVector<double> &terms) const {
+    HaversineBatch::computeTerms(latRad.constData(), lonRad.constData(), cosLat.constData(), int(latRad.size()),
+                                 qDegreesToRadians(QueryLat), qDegreesToRadians(QueryLon), terms.data());
+    const double limit = HaversineBatch::termForDistance(radiusKm);
+    int found = 0;
+    for (double term : terms) {
+        if (term <= limit) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Dodaje kolumnę promienia i wiersze z typowymi promieniami wyszukiwania.
+ */
+void TestHaversineBatch::addSizes() {
+    QTest::addColumn<double>("radiusKm");
+    QTest::newRow("10 km") << 10.0;
+    QTest::newRow("50 km") << 50.0;
+    QTest::newRow("300 km") << 300.0;
+}
+
+/**
+ * @brief Sprawdza, że odległości jądra wsadowego zgadzają się ze wzorem skalarnym.
+ */
+void TestHaversineBatch::termsMatchScalar() {
+    QVector<double> terms(latRad.size());
+    HaversineBatch::computeTerms(latRad.constData(), lonRad.constData(), cosLat.constData(), int(latRad.size()),
+                                 qDegreesToRadians(QueryLat), qDegreesToRadians(QueryLon), terms.data());
+    for (int i = 0; i < terms.size(); ++i) {
+        const double expected = scalarDistance(QueryLat, QueryLon, latitudes[i], longitudes[i]);
+        const double actual = HaversineBatch::distanceKm(terms[i]);
+        QVERIFY2(qAbs(actual - expected) < 1e-6, qPrintable(QString("stacja %1: %2 != %3")
+                                                             .arg(i).arg(actual, 0, 'f', 9).arg(expected, 0, 'f', 9)));
+    }
+}
+
+/**
+ * @brief Dane testu radiusFilter.
+ */
+void TestHaversineBatch::radiusFilter_data() {
+    addSizes();
+}
+
+/**
+ * @brief Sprawdza, że oba sposoby filtrowania znajdują tyle samo stacji.
+ */
+void TestHaversineBatch::radiusFilter() {
+    QFETCH(double, radiusKm);
+    QVector<double> terms(latRad.size());
+    QCOMPARE(countBatch(radiusKm, terms), countScalar(radiusKm));
+}
+
+/**
+ * @brief Dane pomiaru benchmarkScalar.
+ */
+void TestHaversineBatch::benchmarkScalar_data() {
+    addSizes();
+}
+
+/**
+ * @brief Mierzy filtrowanie po promieniu wzorem skalarnym.
+ */
+void TestHaversineBatch::benchmarkScalar() {
+    QFETCH(double, radiusKm);
+    int found = 0;
+    QBENCHMARK {
+        found = countScalar(radiusKm);
+    }
+    QVERIFY(found >= 0);
+}
+
+/**
+ * @brief Dane pomiaru benchmarkBatch.
+ */
+void TestHaversineBatch::benchmarkBatch_data() {
+    addSizes();
+}
+
+/**
+ * @brief Mierzy filtrowanie po promieniu jądrem wsadowym.
+ */
+void TestHaversineBatch::benchmarkBatch() {
+    QFETCH(double, radiusKm);
+    QVector<double> terms(latRad.size());
+    int found = 0;
+    QBENCHMARK {
+        found = countBatch(radiusKm, terms);
+    }
+    QVERIFY(found >= 0);
+}
+
+QTEST_APPLESS_MAIN(TestHaversineBatch)
+
+#include "tst_haversinebatch.moc"
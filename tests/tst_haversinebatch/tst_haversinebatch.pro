@@ -0,0 +1,16 @@
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_haversinebatch
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_haversinebatch.cpp \
+    ../../haversinebatch.cpp
+
+HEADERS += \
+    ../../haversinebatch.h
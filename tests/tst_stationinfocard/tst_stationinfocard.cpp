@@ -0,0 +1,86 @@
+/**
+ * @file tst_stationinfocard.cpp
+ * @brief Testy wyświetlania stacji z archiwum w karcie StationInfoCard.
+ */
+
+#include "giosclient.h"
+#include "giostime.h"
+#include "stationarchive.h"
+#include "stationinfocard.h"
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QtTest>
+
+/**
+ * @class TestStationInfoCard
+ * @brief Sprawdza, że stacja zapisana w archiwum wraca do karty z pełną historią sensorów.
+ *
+ * Testy z widżetami można uruchamiać bez ekranu: ./tst_stationinfocard -platform offscreen
+ */
+class TestStationInfoCard : public QObject {
+    Q_OBJECT
+
+private slots:
+    void archiveRoundTripShowsFirstSensor();
+
+private:
+    static constexpr int PointCount = 12; ///< Liczba zapisanych godzin każdego sensora.
+};
+
+/**
+ * @brief Zapisuje stację z dwoma sensorami, wczytuje ją z archiwum i sprawdza wykres pierwszego sensora.
+ *
+ * Pierwszy sensor wyświetlany jest od razu po wczytaniu, więc jego historia musi zostać zdekodowana
+ * z archiwum, a nie nadpisana pustym szeregiem.
+ */
+void TestStationInfoCard::archiveRoundTripShowsFirstSensor() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("stacja.gios");
+
+    ArchivedStation station;
+    station.stationId = 114;
+    station.stationName = "Wrocław - Bartnicza";
+    station.location = "Wrocław, DOLNOŚLĄSKIE";
+    const int sensorIds[] = {642, 644};
+    const char *paramCodes[] = {"PM10", "NO2"};
+
+    // Punkty z ostatnich godzin mieszczą się w domyślnym zakresie wykresu ("Dzień")
+    const qint64 lastHour = GiosTime::floorToHour(QDateTime::currentSecsSinceEpoch()) - 3600;
+    QMap<int, SensorSeries> histories;
+    for (int s = 0; s < 2; ++s) {
+        ArchivedSensor sensor;
+        sensor.sensorId = sensorIds[s];
+        sensor.paramCode = paramCodes[s];
+        sensor.latestValue = "10.00";
+        station.sensors.append(sensor);
+
+        SensorSeries &series = histories[sensor.sensorId];
+        for (int i = PointCount - 1; i >= 0; --i) {
+            series.append(lastHour - qint64(i) * 3600, float(10 + i + s), false);
+        }
+    }
+
+    StationArchiveWriter writer(fileName);
+    QVERIFY2(writer.append(station, histories), qPrintable(writer.errorString()));
+
+    auto archive = std::make_shared<StationArchiveReader>();
+    QVERIFY2(archive->open(fileName), qPrintable(archive->errorString()));
+
+    GiosClient client;
+    StationInfoCard card(&client);
+    card.showDataFromArchive(archive, 0);
+
+    QCOMPARE(card.sensorComboBox->currentData().toInt(), sensorIds[0]);
+    QCOMPARE(card.sensorSeries.value(sensorIds[0]).size(), PointCount);
+    QVERIFY(!card.archivedSensors.contains(sensorIds[0]));
+    QVERIFY(card.archivedSensors.contains(sensorIds[1]));
+
+    QLineSeries *line = qobject_cast<QLineSeries *>(card.chart->series().value(0));
+    QVERIFY(line);
+    QCOMPARE(line->count(), PointCount);
+}
+
+QTEST_MAIN(TestStationInfoCard)
+
+#include "tst_stationinfocard.moc"
@@ -0,0 +1,33 @@
+QT       += core gui network charts widgets testlib
+
+CONFIG += c++17 testcase
+CONFIG -= app_bundle
+
+TARGET = tst_stationinfocard
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_stationinfocard.cpp \
+    ../../giosclient.cpp \
+    ../../giosresponsecache.cpp \
+    ../../giosstreamparsers.cpp \
+    ../../giostime.cpp \
+    ../../jsonstreamreader.cpp \
+    ../../sensorseries.cpp \
+    ../../seriescodec.cpp \
+    ../../stationarchive.cpp \
+    ../../stationcatalog.cpp \
+    ../../stationinfocard.cpp
+
+HEADERS += \
+    ../../giosclient.h \
+    ../../giosresponsecache.h \
+    ../../giosstreamparsers.h \
+    ../../giostime.h \
+    ../../jsonstreamreader.h \
+    ../../sensorseries.h \
+    ../../seriescodec.h \
+    ../../stationarchive.h \
+    ../../stationcatalog.h \
+    ../../stationinfocard.h